@@ -4,6 +4,9 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
 #include <QDir>
+#include <QDirIterator>
+#include <QCryptographicHash>
+#include <QStandardPaths>
 #include <QQmlComponent>
 #include <QQmlContext>
 #include <private/qqmlmetatype_p.h>
@@ -39,4 +42,83 @@ void loadQmlDummyDataFiles(QQmlEngine *engine, const QString &directory)
     }
 }
 
+QString precompiledQmlCacheDirName()
+{
+    return qSL(".qmlcache");
+}
+
+// only set via the installer/precompileQml option
+static bool s_precompiledQmlCacheEnabled = false;
+
+bool isPrecompiledQmlCacheEnabled()
+{
+    return s_precompiledQmlCacheEnabled;
+}
+
+void setPrecompiledQmlCacheEnabled(bool enabled)
+{
+    s_precompiledQmlCacheEnabled = enabled;
+}
+
+// The location QML's disk cache is using in this process (see QV4::CompilationUnit::localCacheFilePath)
+QString qmlDiskCacheDirectory()
+{
+    const QString envCachePath = qEnvironmentVariable("QML_DISK_CACHE_PATH");
+    if (!envCachePath.isEmpty())
+        return envCachePath;
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + qSL("/qmlcache");
+}
+
+// The cache files are not stored next to the sources, but named after the hash of the source's
+// absolute path. This has to match QV4::CompilationUnit::localCacheFilePath()
+QString qmlDiskCacheFileName(const QString &sourceFilePath)
+{
+    const QString suffix = QFileInfo(sourceFilePath + qL1C('c')).completeSuffix();
+    const QByteArray hash = QCryptographicHash::hash(sourceFilePath.toUtf8(), QCryptographicHash::Sha1);
+    return QString::fromLatin1(hash.toHex()) + qL1C('.') + suffix;
+}
+
+/*! \internal
+    Copies the cache files generated at installation time into this process' QML disk cache, so
+    that the engine does not need to compile these files on the first start. Files that are
+    already in the cache are only replaced, if the precompiled ones are newer (e.g. after an
+    update). The engine itself verifies that a cache file matches its source before using it.
+    Nothing is done, unless precompiling was enabled via setPrecompiledQmlCacheEnabled().
+*/
+void seedQmlDiskCache(const QString &precompiledCacheDirectory)
+{
+    if (!s_precompiledQmlCacheEnabled || qEnvironmentVariableIsSet("QML_DISABLE_DISK_CACHE"))
+        return;
+
+    QDir srcDir(precompiledCacheDirectory);
+    if (!srcDir.exists())
+        return;
+
+    const QString cacheDir = qmlDiskCacheDirectory();
+    if (!QDir::root().mkpath(cacheDir)) {
+        qCWarning(LogQml) << "Could not create the QML disk cache directory" << cacheDir;
+        return;
+    }
+
+    QDirIterator it(srcDir.absolutePath(), QDir::Files | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo src = it.fileInfo();
+        const QString destPath = cacheDir + qL1C('/') + src.fileName();
+        const QFileInfo dest(destPath);
+
+        if (dest.exists() && (dest.lastModified() >= src.lastModified()))
+            continue;
+        if (dest.exists())
+            QFile::remove(destPath);
+        if (!QFile::copy(src.absoluteFilePath(), destPath)) {
+            qCWarning(LogQml) << "Could not copy the precompiled QML cache file" << src.absoluteFilePath()
+                              << "to" << destPath;
+            continue;
+        }
+        // the installed files might be read-only, but the engine needs to be able to replace them
+        QFile::setPermissions(destPath, QFile::ReadOwner | QFile::WriteOwner);
+    }
+}
+
 QT_END_NAMESPACE_AM
@@ -13,4 +13,12 @@ QT_BEGIN_NAMESPACE_AM
 
 void loadQmlDummyDataFiles(QQmlEngine *engine, const QString &directory);
 
+// Support for QML disk cache files that have been generated ahead of time (at installation)
+QString precompiledQmlCacheDirName();
+bool isPrecompiledQmlCacheEnabled();
+void setPrecompiledQmlCacheEnabled(bool enabled);
+QString qmlDiskCacheDirectory();
+QString qmlDiskCacheFileName(const QString &sourceFilePath);
+void seedQmlDiskCache(const QString &precompiledCacheDirectory);
+
 QT_END_NAMESPACE_AM
@@ -119,6 +119,62 @@ bool safeRemove(const QString &path, RecursiveOperationType type)
    return false;
 }
 
+bool syncToDisk(const QString &path, RecursiveOperationType type)
+{
+#if defined(Q_OS_UNIX)
+    // directories are flushed after all their entries
+    if (type == RecursiveOperationType::EnterDirectory)
+        return true;
+
+    int fd = QT_OPEN(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    bool ok = (::fsync(fd) == 0);
+    QT_CLOSE(fd);
+    return ok;
+#else
+    Q_UNUSED(path)
+    Q_UNUSED(type)
+    return true;
+#endif
+}
+
+bool syncRecursive(const QString &path)
+{
+#if defined(Q_OS_UNIX)
+    if (recursiveOperation(path, syncToDisk))
+        return true;
+
+    // at least restrict this to the file-system we are interested in
+    return syncFileSystem(path);
+#else
+    Q_UNUSED(path)
+    return true;
+#endif
+}
+
+bool syncFileSystem(const QString &path)
+{
+#if defined(Q_OS_UNIX)
+#  if defined(Q_OS_LINUX)
+    // path itself might not be accessible for us anymore, but its parent is on the same file-system
+    for (const QString &fsPath : { path, QFileInfo(path).absolutePath() }) {
+        int fd = QT_OPEN(QFile::encodeName(fsPath).constData(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            bool ok = (::syncfs(fd) == 0);
+            QT_CLOSE(fd);
+            return ok;
+        }
+    }
+#  endif
+    ::sync();
+    return true;
+#else
+    Q_UNUSED(path)
+    return true;
+#endif
+}
+
 qint64 getParentPid(qint64 pid)
 {
     qint64 ppid = 0;
@@ -97,6 +97,22 @@ bool recursiveOperation(const QDir &path, const std::function<bool(const QString
 // makes files and directories writable, then deletes them
 bool safeRemove(const QString &path, RecursiveOperationType type);
 
+// flushes the data and meta-data of a file or directory to the storage device (fsync)
+bool syncToDisk(const QString &path, RecursiveOperationType type = RecursiveOperationType::File);
+
+/*! \internal
+
+    Makes sure that the file-system tree at \a path has been written to the
+    storage device. Entries are flushed individually, so unrelated dirty data
+    in the page cache is not affected. If an entry cannot be opened (e.g.
+    because it belongs to another user already), the complete file-system
+    containing \a path is synced instead.
+ */
+bool syncRecursive(const QString &path);
+
+// flushes the complete file-system containing path (syncfs), or all file-systems if that fails
+bool syncFileSystem(const QString &path);
+
 qint64 getParentPid(qint64 pid);
 
 QVector<QObject *> loadPlugins_helper(const char *type, const QStringList &files, const char *iid) Q_DECL_NOEXCEPT_EXPR(false);
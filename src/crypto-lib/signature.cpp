@@ -53,14 +53,69 @@ QByteArray Signature::create(const QByteArray &signingCertificatePkcs12, const Q
 
 bool Signature::verify(const QByteArray &signaturePkcs7, const QList<QByteArray> &chainOfTrust)
 {
+    return verify(signaturePkcs7, TrustStore(chainOfTrust));
+}
+
+bool Signature::verify(const QByteArray &signaturePkcs7, const TrustStore &trustStore)
+{
+    // a null trust store is the same as an empty chain of trust
+    if (!trustStore.d)
+        return verify(signaturePkcs7, QList<QByteArray>());
+
     d->error.clear();
 
     try {
-        return d->verify(signaturePkcs7, chainOfTrust);
+        return d->verify(signaturePkcs7, trustStore.d.data());
     } catch (const Exception &e) {
         d->error = e.errorString();
         return false;
     }
 }
 
+
+TrustStore::TrustStore()
+{ }
+
+TrustStore::TrustStore(const QList<QByteArray> &chainOfTrust)
+{
+    Cryptography::initialize();
+
+    auto *tsp = new TrustStorePrivate;
+    tsp->chainOfTrust = chainOfTrust;
+    try {
+        tsp->parse();
+    } catch (const Exception &e) {
+        tsp->error = e.errorString();
+    }
+    d.reset(tsp);
+}
+
+bool TrustStore::isNull() const
+{
+    return !d;
+}
+
+bool TrustStore::isValid() const
+{
+    return !d || d->error.isEmpty();
+}
+
+QList<QByteArray> TrustStore::certificates() const
+{
+    return d ? d->chainOfTrust : QList<QByteArray>();
+}
+
+QString TrustStore::errorString() const
+{
+    return d ? d->error : QString();
+}
+
+void *TrustStorePrivate::nativeStore() const Q_DECL_NOEXCEPT_EXPR(false)
+{
+    // a broken chain of trust is only reported once a signature has been successfully decoded
+    if (!error.isEmpty())
+        throw Exception(Error::Cryptography, error);
+    return store;
+}
+
 QT_END_NAMESPACE_AM
@@ -6,11 +6,34 @@
 
 #include <QString>
 #include <QByteArray>
+#include <QList>
+#include <QSharedPointer>
 #include <QtAppManCommon/global.h>
 
 QT_BEGIN_NAMESPACE_AM
 
 class SignaturePrivate;
+class TrustStorePrivate;
+
+// A parsed chain of trust. It is immutable after construction and implicitly shared, so a single
+// instance can be used to verify any number of signatures, even from multiple threads at once.
+// A default constructed TrustStore is null: it behaves like an empty chain of trust, but does not
+// need the cryptography backend to be initialized.
+class TrustStore
+{
+public:
+    TrustStore();
+    explicit TrustStore(const QList<QByteArray> &chainOfTrust);
+
+    bool isNull() const;
+    bool isValid() const;
+    QList<QByteArray> certificates() const;
+    QString errorString() const;
+
+private:
+    QSharedPointer<const TrustStorePrivate> d;
+    friend class Signature;
+};
 
 class Signature
 {
@@ -20,6 +43,7 @@ public:
 
     QByteArray create(const QByteArray &signingCertificatePkcs12, const QByteArray &signingCertificatePassword);
     bool verify(const QByteArray &signaturePkcs7, const QList<QByteArray> &chainOfTrust);
+    bool verify(const QByteArray &signaturePkcs7, const TrustStore &trustStore);
 
     QString errorString() const;
 
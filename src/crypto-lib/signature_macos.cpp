@@ -100,8 +100,35 @@ QByteArray SignaturePrivate::create(const QByteArray &signingCertificatePkcs12,
     }
 }
 
+void TrustStorePrivate::parse() Q_DECL_NOEXCEPT_EXPR(false)
+{
+    OSStatus err;
+
+    QCFType<CFMutableArrayRef> caCerts = CFArrayCreateMutable(nullptr, 0, &kCFTypeArrayCallBacks);
+    for (const QByteArray &trustedCert : qAsConst(chainOfTrust)) {
+        QCFType<CFArrayRef> certs;
+        SecExternalFormat itemFormat = kSecFormatUnknown; // X509Cert;
+        SecExternalItemType itemType = kSecItemTypeUnknown; //Certificate;
+        if ((err = SecItemImport(trustedCert.toCFData(), nullptr, &itemFormat, &itemType, 0, nullptr, nullptr, &certs)))
+            throw SecurityException(err, "Could not load a certificate from the chain of trust");
+
+        for (int i = 0 ; i < CFArrayGetCount(certs); ++i) {
+            if (CFGetTypeID(CFArrayGetValueAtIndex(certs, i)) != SecCertificateGetTypeID())
+                continue;
+            CFArrayAppendValue(caCerts, CFArrayGetValueAtIndex(certs, i));
+        }
+    }
+    store = const_cast<void *>(static_cast<const void *>(CFArrayCreateCopy(nullptr, caCerts)));
+}
+
+TrustStorePrivate::~TrustStorePrivate()
+{
+    if (store)
+        CFRelease(static_cast<CFArrayRef>(store));
+}
+
 bool SignaturePrivate::verify(const QByteArray &signaturePkcs7,
-                              const QList<QByteArray> &chainOfTrust) Q_DECL_NOEXCEPT_EXPR(false)
+                              const TrustStorePrivate *trustStore) Q_DECL_NOEXCEPT_EXPR(false)
 {
     OSStatus err;
 
@@ -121,20 +148,7 @@ bool SignaturePrivate::verify(const QByteArray &signaturePkcs7,
     if ((err = CMSDecoderSetDetachedContent(decoder, hashContent)))
         throw SecurityException(err, "Could not set PKCS#7 signature detached content");
 
-    QCFType<CFMutableArrayRef> caCerts = CFArrayCreateMutable(nullptr, 0, nullptr);
-    for (const QByteArray &trustedCert : chainOfTrust) {
-        QCFType<CFArrayRef> certs;
-        SecExternalFormat itemFormat = kSecFormatUnknown; // X509Cert;
-        SecExternalItemType itemType = kSecItemTypeUnknown; //Certificate;
-        if ((err = SecItemImport(trustedCert.toCFData(), nullptr, &itemFormat, &itemType, 0, nullptr, nullptr, &certs)))
-            throw SecurityException(err, "Could not load a certificate from the chain of trust");
-
-        for (int i = 0 ; i < CFArrayGetCount(certs); ++i) {
-            if (CFGetTypeID(CFArrayGetValueAtIndex(certs, i)) != SecCertificateGetTypeID())
-                continue;
-            CFArrayAppendValue(caCerts, CFRetain(CFArrayGetValueAtIndex(certs, i)));
-        }
-    }
+    auto caCerts = static_cast<CFArrayRef>(trustStore->nativeStore());
 
     QCFType<CFArrayRef> msgCerts;
     if ((err = CMSDecoderCopyAllCerts(decoder, &msgCerts)))
@@ -3,8 +3,11 @@
 // Copyright (C) 2018 Pelagicore AG
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
+#include <QMutex>
 #include <QScopedPointer>
 
+#include <mutex>
+
 #include "exception.h"
 #include "cryptography.h"
 #include "libcryptofunction.h"
@@ -151,28 +154,13 @@ QByteArray SignaturePrivate::create(const QByteArray &signingCertificatePkcs12,
     return QByteArray(data, size);
 }
 
-bool SignaturePrivate::verify(const QByteArray &signaturePkcs7,
-                              const QList<QByteArray> &chainOfTrust) Q_DECL_NOEXCEPT_EXPR(false)
+void TrustStorePrivate::parse() Q_DECL_NOEXCEPT_EXPR(false)
 {
-    OpenSslPointer<BIO> bioSignature(am_BIO_new_mem_buf(signaturePkcs7.constData(), signaturePkcs7.size()));
-    if (!bioSignature)
-        throw OpenSslException("Could not create BIO buffer for PKCS#7 data");
-
-    // PKCS7 *PEM_read_bio_PKCS7(BIO *bp, PKCS7 **x, pem_password_cb *cb, void *u);
-    //OpenSslPointer<PKCS7> signature((PKCS7 *) am_PEM_ASN1_read_bio((d2i_of_void *) am_d2i_PKCS7.functionPointer(), PEM_STRING_PKCS7, bioSignature.get(), nullptr, nullptr, nullptr));
-    OpenSslPointer<PKCS7> signature(am_d2i_PKCS7_bio(bioSignature.get(), nullptr));
-    if (!signature)
-        throw OpenSslException("Could not read PKCS#7 data from BIO buffer");
-
-    OpenSslPointer<BIO> bioHash(am_BIO_new_mem_buf(hash.constData(), hash.size()));
-    if (!bioHash)
-        throw OpenSslException("Could not create BIO buffer for the hash");
-
     OpenSslPointer<X509_STORE> certChain(am_X509_STORE_new());
     if (!certChain)
         throw OpenSslException("Could not create a X509 certificate store");
 
-    for (const QByteArray &trustedCert : chainOfTrust) {
+    for (const QByteArray &trustedCert : qAsConst(chainOfTrust)) {
         OpenSslPointer<BIO> bioCert(am_BIO_new_mem_buf(trustedCert.constData(), trustedCert.size()));
         if (!bioCert)
             throw OpenSslException("Could not create BIO buffer for a certificate");
@@ -190,9 +178,42 @@ bool SignaturePrivate::verify(const QByteArray &signaturePkcs7,
             // X509 certs are ref-counted, so we need to "free" the one we got via PEM_read_bio
         }
     }
+    store = certChain.take();
+}
+
+TrustStorePrivate::~TrustStorePrivate()
+{
+    if (store)
+        am_X509_STORE_free(static_cast<X509_STORE *>(store));
+}
+
+bool SignaturePrivate::verify(const QByteArray &signaturePkcs7,
+                              const TrustStorePrivate *trustStore) Q_DECL_NOEXCEPT_EXPR(false)
+{
+    OpenSslPointer<BIO> bioSignature(am_BIO_new_mem_buf(signaturePkcs7.constData(), signaturePkcs7.size()));
+    if (!bioSignature)
+        throw OpenSslException("Could not create BIO buffer for PKCS#7 data");
+
+    // PKCS7 *PEM_read_bio_PKCS7(BIO *bp, PKCS7 **x, pem_password_cb *cb, void *u);
+    //OpenSslPointer<PKCS7> signature((PKCS7 *) am_PEM_ASN1_read_bio((d2i_of_void *) am_d2i_PKCS7.functionPointer(), PEM_STRING_PKCS7, bioSignature.get(), nullptr, nullptr, nullptr));
+    OpenSslPointer<PKCS7> signature(am_d2i_PKCS7_bio(bioSignature.get(), nullptr));
+    if (!signature)
+        throw OpenSslException("Could not read PKCS#7 data from BIO buffer");
+
+    OpenSslPointer<BIO> bioHash(am_BIO_new_mem_buf(hash.constData(), hash.size()));
+    if (!bioHash)
+        throw OpenSslException("Could not create BIO buffer for the hash");
+
+    auto *certChain = static_cast<X509_STORE *>(trustStore->nativeStore());
+
+    // OpenSSL 1.1 locks the store internally, but 1.0 needs the application to do that
+    static QMutex openSsl10Mutex;
+    std::unique_lock<QMutex> locker(openSsl10Mutex, std::defer_lock);
+    if (!Cryptography::LibCryptoFunctionBase::isOpenSSL11())
+        locker.lock();
 
     // int PKCS7_verify(PKCS7 *p7, STACK_OF(X509) *certs, X509_STORE *store, BIO *indata, BIO *out, int flags);
-    if (am_PKCS7_verify(signature.get(), nullptr, certChain.get(), bioHash.get(), nullptr, 0x8 /*PKCS7_NOCHAIN*/) != 1) {
+    if (am_PKCS7_verify(signature.get(), nullptr, certChain, bioHash.get(), nullptr, 0x8 /*PKCS7_NOCHAIN*/) != 1) {
         bool failed = (am_ERR_get_error() != 0);
         if (failed)
             throw OpenSslException("Failed to verify signature");
@@ -9,6 +9,19 @@
 
 QT_BEGIN_NAMESPACE_AM
 
+class TrustStorePrivate
+{
+public:
+    ~TrustStorePrivate();
+
+    QList<QByteArray> chainOfTrust;
+    QString error;
+    void *store = nullptr; // backend specific: X509_STORE *, HCERTSTORE or CFArrayRef
+
+    void parse() Q_DECL_NOEXCEPT_EXPR(false);
+    void *nativeStore() const Q_DECL_NOEXCEPT_EXPR(false);
+};
+
 class SignaturePrivate
 {
 public:
@@ -18,7 +31,7 @@ public:
     QByteArray create(const QByteArray &signingCertificatePkcs12,
                       const QByteArray &signingCertificatePassword) Q_DECL_NOEXCEPT_EXPR(false);
     bool verify(const QByteArray &signaturePkcs7,
-                const QList<QByteArray> &chainOfTrust) Q_DECL_NOEXCEPT_EXPR(false);
+                const TrustStorePrivate *trustStore) Q_DECL_NOEXCEPT_EXPR(false);
 };
 
 QT_END_NAMESPACE_AM
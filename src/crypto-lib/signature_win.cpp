@@ -105,12 +105,55 @@ QByteArray SignaturePrivate::create(const QByteArray &signingCertificatePkcs12,
     }
 }
 
+void TrustStorePrivate::parse() Q_DECL_NOEXCEPT_EXPR(false)
+{
+    HCERTSTORE rootCertStore = CertOpenStore(CERT_STORE_PROV_MEMORY, X509_ASN_ENCODING | PKCS_7_ASN_ENCODING,
+                                             0, 0, nullptr);
+    if (!rootCertStore)
+        throw WinCryptException("Could not create temporary root certificate store");
+
+    try {
+        for (const QByteArray &trustedCert : qAsConst(chainOfTrust)) {
+            // convert from PEM to DER
+            DWORD derSize = 0;
+            if (!CryptStringToBinaryA(trustedCert.constData(), trustedCert.size(), CRYPT_STRING_BASE64HEADER,
+                                      nullptr, &derSize, nullptr, nullptr)) {
+                throw WinCryptException("Could not load a certificate from the chain of trust (PEM to DER size calculation failed)");
+            }
+            QByteArray derBuffer;
+            derBuffer.resize(derSize);
+            if (!CryptStringToBinaryA(trustedCert.constData(), trustedCert.size(), CRYPT_STRING_BASE64HEADER,
+                                      (BYTE *) derBuffer.data(), &derSize, nullptr, nullptr)) {
+                throw WinCryptException("Could not load a certificate from the chain of trust (PEM to DER conversion failed)");
+            }
+            derBuffer.resize(derSize);
+
+            if (!CertAddEncodedCertificateToStore(rootCertStore, X509_ASN_ENCODING | PKCS_7_ASN_ENCODING,
+                                                  (const BYTE *) derBuffer.constData(), derBuffer.size(),
+                                                  CERT_STORE_ADD_ALWAYS, nullptr)) {
+                throw WinCryptException("Could not add a certificate from the chain of trust to the certificate store");
+            }
+        }
+        // the store is only read from now on, which is thread-safe for memory stores
+        store = rootCertStore;
+
+    } catch (const Exception &) {
+        CertCloseStore(rootCertStore, CERT_CLOSE_STORE_FORCE_FLAG);
+        throw;
+    }
+}
+
+TrustStorePrivate::~TrustStorePrivate()
+{
+    if (store)
+        CertCloseStore(static_cast<HCERTSTORE>(store), CERT_CLOSE_STORE_FORCE_FLAG);
+}
+
 bool SignaturePrivate::verify(const QByteArray &signaturePkcs7,
-                              const QList<QByteArray> &chainOfTrust) Q_DECL_NOEXCEPT_EXPR(false)
+                              const TrustStorePrivate *trustStore) Q_DECL_NOEXCEPT_EXPR(false)
 {
     PCCERT_CONTEXT signerCert = nullptr;
     HCERTSTORE msgCertStore = nullptr;
-    HCERTSTORE rootCertStore = nullptr;
     HCERTCHAINENGINE certChainEngine = nullptr;
     PCCERT_CHAIN_CONTEXT chainContext = nullptr;
 
@@ -119,8 +162,6 @@ bool SignaturePrivate::verify(const QByteArray &signaturePkcs7,
             CertFreeCertificateChain(chainContext);
         if (certChainEngine)
             CertFreeCertificateChainEngine(certChainEngine);
-        if (rootCertStore)
-            CertCloseStore(rootCertStore, CERT_CLOSE_STORE_FORCE_FLAG);
         if (msgCertStore)
             CertCloseStore(msgCertStore, CERT_CLOSE_STORE_FORCE_FLAG);
         if (signerCert)
@@ -154,32 +195,7 @@ bool SignaturePrivate::verify(const QByteArray &signaturePkcs7,
         if (!msgCertStore)
             throw WinCryptException("Could not retrieve certificates from signature");
 
-        rootCertStore = CertOpenStore(CERT_STORE_PROV_MEMORY, X509_ASN_ENCODING | PKCS_7_ASN_ENCODING,
-                                      0, 0, nullptr);
-        if (!rootCertStore)
-            throw WinCryptException("Could not create temporary root certificate store");
-
-        for (const QByteArray &trustedCert : chainOfTrust) {
-            // convert from PEM to DER
-            DWORD derSize = 0;
-            if (!CryptStringToBinaryA(trustedCert.constData(), trustedCert.size(), CRYPT_STRING_BASE64HEADER,
-                                      nullptr, &derSize, nullptr, nullptr)) {
-                throw WinCryptException("Could not load a certificate from the chain of trust (PEM to DER size calculation failed)");
-            }
-            QByteArray derBuffer;
-            derBuffer.resize(derSize);
-            if (!CryptStringToBinaryA(trustedCert.constData(), trustedCert.size(), CRYPT_STRING_BASE64HEADER,
-                                      (BYTE *) derBuffer.data(), &derSize, nullptr, nullptr)) {
-                throw WinCryptException("Could not load a certificate from the chain of trust (PEM to DER conversion failed)");
-            }
-            derBuffer.resize(derSize);
-
-            if (!CertAddEncodedCertificateToStore(rootCertStore, X509_ASN_ENCODING | PKCS_7_ASN_ENCODING,
-                                                  (const BYTE *) derBuffer.constData(), derBuffer.size(),
-                                                  CERT_STORE_ADD_ALWAYS, nullptr)) {
-                throw WinCryptException("Could not add a certificate from the chain of trust to the certificate store");
-            }
-        }
+        HCERTSTORE rootCertStore = static_cast<HCERTSTORE>(trustStore->nativeStore());
 
         CERT_CHAIN_ENGINE_CONFIG chainConfig;
         memset(&chainConfig, 0, sizeof(chainConfig));
@@ -219,6 +219,26 @@ bool ApplicationManagerAdaptor::startApplication(const QString &id, const QtAM::
     }
 }
 
+bool ApplicationManagerAdaptor::startApplicationInBackground(const QString &id)
+{
+    return startApplicationInBackground(id, QString());
+}
+
+bool ApplicationManagerAdaptor::startApplicationInBackground(const QString &id, const QString &documentUrl)
+{
+    AM_AUTHENTICATE_DBUS(bool)
+
+    auto am = ApplicationManager::instance();
+    try {
+        return am->startApplicationInternal(id, documentUrl, QString(), QString(), { },
+                                            ApplicationManager::BackgroundStart);
+    } catch (const Exception &e) {
+        qCWarning(LogSystem) << e.what();
+        AbstractDBusContextAdaptor::dbusContextFor(this)->sendErrorReply(qL1S("org.freedesktop.DBus.Error.Failed"), e.errorString());
+        return false;
+    }
+}
+
 void ApplicationManagerAdaptor::stopAllApplications()
 {
     stopAllApplications(false);
@@ -240,3 +260,15 @@ void ApplicationManagerAdaptor::stopApplication(const QString &id, bool forceKil
     AM_AUTHENTICATE_DBUS(void)
     ApplicationManager::instance()->stopApplication(id, forceKill);
 }
+
+bool ApplicationManagerAdaptor::freezeApplication(const QString &id)
+{
+    AM_AUTHENTICATE_DBUS(bool)
+    return ApplicationManager::instance()->freezeApplication(id);
+}
+
+bool ApplicationManagerAdaptor::thawApplication(const QString &id)
+{
+    AM_AUTHENTICATE_DBUS(bool)
+    return ApplicationManager::instance()->thawApplication(id);
+}
@@ -23,7 +23,10 @@ QT_USE_NAMESPACE_AM
 
 WindowManagerAdaptor::WindowManagerAdaptor(QObject *parent)
     : QDBusAbstractAdaptor(parent)
-{ }
+{
+    connect(WindowManager::instance(), &WindowManager::screenshotFinished,
+            this, &WindowManagerAdaptor::screenshotFinished);
+}
 
 WindowManagerAdaptor::~WindowManagerAdaptor()
 { }
@@ -47,3 +50,14 @@ bool WindowManagerAdaptor::makeScreenshot(const QString &filename, const QString
 {
     return WindowManager::instance()->makeScreenshot(filename, selector);
 }
+
+uint WindowManagerAdaptor::requestScreenshot(const QString &filename, const QString &selector,
+                                             const QVariantMap &options)
+{
+    return WindowManager::instance()->requestScreenshot(filename, selector, options);
+}
+
+QVariantList WindowManagerAdaptor::frameStatistics()
+{
+    return WindowManager::instance()->frameStatistics();
+}
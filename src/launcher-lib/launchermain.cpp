@@ -8,6 +8,7 @@
 #include <QtAppManCommon/exception.h>
 #include <QtAppManCommon/logging.h>
 #include <QtAppManCommon/utilities.h>
+#include <QtAppManCommon/qml-utilities.h>
 #include <QtAppManCommon/crashhandler.h>
 #include <QtAppManCommon/exception.h>
 
@@ -194,6 +195,7 @@ void LauncherMain::loadConfiguration(const QByteArray &configYaml) Q_DECL_NOEXCE
     m_openGLConfiguration = uiConfig.value(qSL("opengl")).toMap();
     m_iconThemeName = uiConfig.value(qSL("iconThemeName")).toString();
     m_iconThemeSearchPaths = uiConfig.value(qSL("iconThemeSearchPaths")).toStringList();
+    setPrecompiledQmlCacheEnabled(uiConfig.value(qSL("precompiledQmlCache")).toBool());
 
     // un-comment this if things go south:
     //qWarning() << "### LOG " << m_loggingRules;
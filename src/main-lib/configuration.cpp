@@ -371,7 +371,7 @@ void Configuration::parseWithArguments(const QStringList &arguments)
 }
 
 
-const quint32 ConfigurationData::DataStreamVersion = 8;
+const quint32 ConfigurationData::DataStreamVersion = 14;
 
 
 ConfigurationData *ConfigurationData::loadFromCache(QDataStream &ds)
@@ -400,6 +400,9 @@ ConfigurationData *ConfigurationData::loadFromCache(QDataStream &ds)
        >> cd->logging.useAMConsoleLogger
        >> cd->installer.disable
        >> cd->installer.caCertificates
+       >> cd->installer.precompileQml
+       >> cd->installer.ioPriority
+       >> cd->installer.ioBandwidthLimit
        >> cd->installer.applicationUserIdSeparation.maxUserId
        >> cd->installer.applicationUserIdSeparation.minUserId
        >> cd->installer.applicationUserIdSeparation.commonGroupId
@@ -418,10 +421,14 @@ ConfigurationData *ConfigurationData::loadFromCache(QDataStream &ds)
        >> cd->ui.loadDummyData
        >> cd->ui.iconThemeSearchPaths
        >> cd->ui.opengl
+       >> cd->ui.watchdog
        >> cd->applications.builtinAppsManifestDir
        >> cd->applications.installationDir
        >> cd->applications.documentDir
        >> cd->applications.installationDirMountPoint
+       >> cd->applications.maximumConcurrentStarts
+       >> cd->applications.startTimeout
+       >> cd->applications.evictionPolicy
        >> cd->installationLocations
        >> cd->crashAction
        >> cd->systemProperties
@@ -463,6 +470,9 @@ void ConfigurationData::saveToCache(QDataStream &ds) const
        << logging.useAMConsoleLogger
        << installer.disable
        << installer.caCertificates
+       << installer.precompileQml
+       << installer.ioPriority
+       << installer.ioBandwidthLimit
        << installer.applicationUserIdSeparation.maxUserId
        << installer.applicationUserIdSeparation.minUserId
        << installer.applicationUserIdSeparation.commonGroupId
@@ -481,10 +491,14 @@ void ConfigurationData::saveToCache(QDataStream &ds) const
        << ui.loadDummyData
        << ui.iconThemeSearchPaths
        << ui.opengl
+       << ui.watchdog
        << applications.builtinAppsManifestDir
        << applications.installationDir
        << applications.documentDir
        << applications.installationDirMountPoint
+       << applications.maximumConcurrentStarts
+       << applications.startTimeout
+       << applications.evictionPolicy
        << installationLocations
        << crashAction
        << systemProperties
@@ -563,6 +577,9 @@ void ConfigurationData::mergeFrom(const ConfigurationData *from)
     MERGE_FIELD(logging.useAMConsoleLogger);
     MERGE_FIELD(installer.disable);
     MERGE_FIELD(installer.caCertificates);
+    MERGE_FIELD(installer.precompileQml);
+    MERGE_FIELD(installer.ioPriority);
+    MERGE_FIELD(installer.ioBandwidthLimit);
     MERGE_FIELD(installer.applicationUserIdSeparation.maxUserId);
     MERGE_FIELD(installer.applicationUserIdSeparation.minUserId);
     MERGE_FIELD(installer.applicationUserIdSeparation.commonGroupId);
@@ -581,10 +598,14 @@ void ConfigurationData::mergeFrom(const ConfigurationData *from)
     MERGE_FIELD(ui.loadDummyData);
     MERGE_FIELD(ui.iconThemeSearchPaths);
     MERGE_FIELD(ui.opengl);
+    MERGE_FIELD(ui.watchdog);
     MERGE_FIELD(applications.builtinAppsManifestDir);
     MERGE_FIELD(applications.installationDir);
     MERGE_FIELD(applications.documentDir);
     MERGE_FIELD(applications.installationDirMountPoint);
+    MERGE_FIELD(applications.maximumConcurrentStarts);
+    MERGE_FIELD(applications.startTimeout);
+    MERGE_FIELD(applications.evictionPolicy);
     MERGE_FIELD(installationLocations);
     MERGE_FIELD(crashAction);
     MERGE_FIELD(systemProperties);
@@ -733,6 +754,18 @@ ConfigurationData *ConfigurationData::loadFromSource(QIODevice *source, const QS
                             cd->installer.disable = p->parseScalar().toBool(); } },
                       { "caCertificates", false, YamlParser::Scalar | YamlParser::List, [&cd](YamlParser *p) {
                             cd->installer.caCertificates = p->parseStringOrStringList(); } },
+                      { "precompileQml", false, YamlParser::Scalar, [&cd](YamlParser *p) {
+                            cd->installer.precompileQml = p->parseScalar().toBool(); } },
+                      { "ioPriority", false, YamlParser::Scalar, [&cd](YamlParser *p) {
+                            static const QStringList validValues {
+                                qL1S("normal"), qL1S("low"), qL1S("idle")
+                            };
+                            QString s = p->parseScalar().toString();
+                            if (!validValues.contains(s))
+                                throw YamlParserException(p, "installer.ioPriority needs to be one of %1").arg(validValues);
+                            cd->installer.ioPriority = s; } },
+                      { "ioBandwidthLimit", false, YamlParser::Scalar, [&cd](YamlParser *p) {
+                            cd->installer.ioBandwidthLimit = quint64(qMax(qint64(0), p->parseScalar().toLongLong())); } },
                       { "applicationUserIdSeparation", false, YamlParser::Map, [&cd](YamlParser *p) {
                             p->parseFields({
                                 { "minUserId", false, YamlParser::Scalar, [&cd](YamlParser *p) {
@@ -785,6 +818,8 @@ ConfigurationData *ConfigurationData::loadFromSource(QIODevice *source, const QS
                                       cd->ui.opengl.insert(qSL("esMinorVersion"), p->parseScalar().toInt()); } }
                             });
                         } },
+                      { "watchdog", false, YamlParser::Map, [&cd](YamlParser *p) {
+                            cd->ui.watchdog = p->parseMap(); } },
                   }); } },
             { "applications", false, YamlParser::Map, [&cd](YamlParser *p) {
                   p->parseFields({
@@ -796,6 +831,12 @@ ConfigurationData *ConfigurationData::loadFromSource(QIODevice *source, const QS
                             cd->applications.documentDir = p->parseScalar().toString(); } },
                       { "installationDirMountPoint", false, YamlParser::Scalar | YamlParser::Scalar, [&cd](YamlParser *p) {
                             cd->applications.installationDirMountPoint = p->parseScalar().toString(); } },
+                      { "maximumConcurrentStarts", false, YamlParser::Scalar, [&cd](YamlParser *p) {
+                            cd->applications.maximumConcurrentStarts = p->parseScalar().toInt(); } },
+                      { "startTimeout", false, YamlParser::Scalar, [&cd](YamlParser *p) {
+                            cd->applications.startTimeout = p->parseScalar().toInt(); } },
+                      { "evictionPolicy", false, YamlParser::Map, [&cd](YamlParser *p) {
+                            cd->applications.evictionPolicy = p->parseMap(); } },
                       { "installedAppsManifestDir", false, YamlParser::Scalar, [](YamlParser *p) {
                             qCDebug(LogDeployment) << "ignoring 'installedAppsManifestDir'";
                             (void) p->parseScalar(); } },
@@ -931,6 +972,21 @@ QString Configuration::installationDirMountPoint() const
     return m_data->applications.installationDirMountPoint;
 }
 
+int Configuration::maximumConcurrentApplicationStarts() const
+{
+    return qMax(0, m_data->applications.maximumConcurrentStarts);
+}
+
+int Configuration::applicationStartTimeout() const
+{
+    return qMax(0, m_data->applications.startTimeout);
+}
+
+QVariantMap Configuration::applicationEvictionPolicy() const
+{
+    return m_data->applications.evictionPolicy;
+}
+
 bool Configuration::disableInstaller() const
 {
     return value<bool>("disable-installer", m_data->installer.disable);
@@ -1129,6 +1185,11 @@ QVariantMap Configuration::openGLConfiguration() const
     return m_data->ui.opengl;
 }
 
+QVariantMap Configuration::uiWatchdogConfiguration() const
+{
+    return m_data->ui.watchdog;
+}
+
 QVariantList Configuration::installationLocations() const
 {
     return m_data->installationLocations;
@@ -1250,6 +1311,21 @@ QStringList Configuration::caCertificates() const
     return m_data->installer.caCertificates;
 }
 
+bool Configuration::precompileQml() const
+{
+    return m_data->installer.precompileQml;
+}
+
+QString Configuration::ioPriority() const
+{
+    return m_data->installer.ioPriority.isEmpty() ? qSL("low") : m_data->installer.ioPriority;
+}
+
+quint64 Configuration::ioBandwidthLimit() const
+{
+    return m_data->installer.ioBandwidthLimit;
+}
+
 QStringList Configuration::pluginFilePaths(const char *type) const
 {
     if (qstrcmp(type, "startup") == 0)
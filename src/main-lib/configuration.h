@@ -40,6 +40,9 @@ public:
     QString documentDir() const;
     QString installationDir() const;
     QString installationDirMountPoint() const;
+    int maximumConcurrentApplicationStarts() const;
+    int applicationStartTimeout() const;
+    QVariantMap applicationEvictionPolicy() const;
     bool disableInstaller() const;
     bool disableIntents() const;
     int intentTimeoutForDisambiguation() const;
@@ -80,6 +83,7 @@ public:
     QStringList resources() const;
 
     QVariantMap openGLConfiguration() const;
+    QVariantMap uiWatchdogConfiguration() const;
 
     QVariantList installationLocations() const;
 
@@ -103,6 +107,9 @@ public:
     QVariantMap managerCrashAction() const;
 
     QStringList caCertificates() const;
+    bool precompileQml() const;
+    QString ioPriority() const;
+    quint64 ioBandwidthLimit() const;
 
     QStringList pluginFilePaths(const char *type) const;
 
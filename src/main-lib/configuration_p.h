@@ -68,6 +68,9 @@ struct ConfigurationData
     struct {
         bool disable = false;
         QStringList caCertificates;
+        bool precompileQml = false;
+        QString ioPriority;
+        quint64 ioBandwidthLimit = 0;
         struct {
             int minUserId = -1;
             int maxUserId = -1;
@@ -97,6 +100,7 @@ struct ConfigurationData
         bool fullscreen = false;
         QString mainQml;
         QStringList resources;
+        QVariantMap watchdog;
     } ui;
 
     struct {
@@ -104,6 +108,9 @@ struct ConfigurationData
         QString installationDir;
         QString documentDir;
         QString installationDirMountPoint;
+        int maximumConcurrentStarts = 0;
+        int startTimeout = 20000;
+        QVariantMap evictionPolicy;
     } applications; // TODO: rename to package?
 
     QVariantList installationLocations; // deprecated
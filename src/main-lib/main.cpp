@@ -87,10 +87,12 @@
 #include "unixsignalhandler.h"
 
 // monitor-lib
+#include "cpucoresstatus.h"
 #include "cpustatus.h"
 #include "iostatus.h"
 #include "memorystatus.h"
 #include "monitormodel.h"
+#include "pressurestatus.h"
 #include "processstatus.h"
 
 #include "../plugin-interfaces/startupinterface.h"
@@ -198,7 +200,9 @@ void Main::setup(const Configuration *cfg) Q_DECL_NOEXCEPT_EXPR(false)
     loadPackageDatabase(cfg->clearCache() || cfg->noCache(), cfg->singleApp());
 
     setupSingletons(cfg->containerSelectionConfiguration(), cfg->quickLaunchRuntimesPerContainer(),
-                    cfg->quickLaunchIdleLoad());
+                    cfg->quickLaunchIdleLoad(), cfg->maximumConcurrentApplicationStarts(),
+                    cfg->applicationStartTimeout(),
+                    cfg->applicationEvictionPolicy());
 
     if (!cfg->disableIntents()) {
         setupIntents(cfg->intentTimeoutForDisambiguation(), cfg->intentTimeoutForStartApplication(),
@@ -212,13 +216,14 @@ void Main::setup(const Configuration *cfg) Q_DECL_NOEXCEPT_EXPR(false)
     } else {
         setupInstaller(cfg->developmentMode(), cfg->allowUnsignedPackages(), cfg->caCertificates(),
                        std::bind(&Configuration::applicationUserIdSeparation, cfg,
-                                 std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+                                 std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+                       cfg->precompileQml(), cfg->ioPriority(), cfg->ioBandwidthLimit());
     }
     setLibraryPaths(libraryPaths() + cfg->pluginPaths());
     setupQmlEngine(cfg->importPaths(), cfg->style());
     setupWindowTitle(QString(), cfg->windowIcon());
     setupWindowManager(cfg->waylandSocketName(), cfg->waylandExtraSockets(), cfg->slowAnimations(),
-                       cfg->noUiWatchdog(), cfg->allowUnknownUiClients());
+                       cfg->noUiWatchdog(), cfg->uiWatchdogConfiguration(), cfg->allowUnknownUiClients());
 
     setupDBus(std::bind(&Configuration::dbusRegistration, cfg, std::placeholders::_1),
               std::bind(&Configuration::dbusPolicy, cfg, std::placeholders::_1));
@@ -434,7 +439,10 @@ void Main::setupIntents(int disambiguationTimeout, int startApplicationTimeout,
 
 void Main::setupSingletons(const QList<QPair<QString, QString>> &containerSelectionConfiguration,
                            int quickLaunchRuntimesPerContainer,
-                           qreal quickLaunchIdleLoad) Q_DECL_NOEXCEPT_EXPR(false)
+                           qreal quickLaunchIdleLoad,
+                           int maximumConcurrentApplicationStarts,
+                           int applicationStartTimeout,
+                           const QVariantMap &applicationEvictionPolicy) Q_DECL_NOEXCEPT_EXPR(false)
 {
     m_packageManager = PackageManager::createInstance(m_packageDatabase, m_documentDir);
     m_applicationManager = ApplicationManager::createInstance(m_isSingleProcessMode);
@@ -444,6 +452,9 @@ void Main::setupSingletons(const QList<QPair<QString, QString>> &containerSelect
 
     m_applicationManager->setSystemProperties(m_systemProperties.at(SP_SystemUi));
     m_applicationManager->setContainerSelectionConfiguration(containerSelectionConfiguration);
+    m_applicationManager->setMaximumConcurrentStarts(maximumConcurrentApplicationStarts);
+    m_applicationManager->setStartTimeout(applicationStartTimeout);
+    m_applicationManager->setEvictionPolicy(applicationEvictionPolicy);
 
     StartupTimer::instance()->checkpoint("after ApplicationManager instantiation");
 
@@ -459,7 +470,9 @@ void Main::setupSingletons(const QList<QPair<QString, QString>> &containerSelect
 }
 
 void Main::setupInstaller(bool devMode, bool allowUnsigned, const QStringList &caCertificatePaths,
-                          const std::function<bool(uint *, uint *, uint *)> &userIdSeparation) Q_DECL_NOEXCEPT_EXPR(false)
+                          const std::function<bool(uint *, uint *, uint *)> &userIdSeparation,
+                          bool precompileQml, const QString &ioPriority,
+                          quint64 ioBandwidthLimit) Q_DECL_NOEXCEPT_EXPR(false)
 {
 #if !defined(AM_DISABLE_INSTALLER)
     if (Q_UNLIKELY(!PackageUtilities::checkCorrectLocale())) {
@@ -511,6 +524,17 @@ void Main::setupInstaller(bool devMode, bool allowUnsigned, const QStringList &c
     if (m_noSecurity || allowUnsigned)
         m_packageManager->setAllowInstallationOfUnsignedPackages(true);
 
+    m_packageManager->setPrecompileQml(precompileQml);
+    setPrecompiledQmlCacheEnabled(precompileQml);
+
+    if (ioPriority == qL1S("normal"))
+        m_packageManager->setIoPriority(AsynchronousTask::NormalIoPriority);
+    else if (ioPriority == qL1S("idle"))
+        m_packageManager->setIoPriority(AsynchronousTask::IdleIoPriority);
+    else
+        m_packageManager->setIoPriority(AsynchronousTask::LowIoPriority);
+    m_packageManager->setIoBandwidthLimit(ioBandwidthLimit);
+
     if (!m_noSecurity) {
         QList<QByteArray> caCertificateList;
 
@@ -544,6 +568,9 @@ void Main::setupInstaller(bool devMode, bool allowUnsigned, const QStringList &c
     Q_UNUSED(allowUnsigned)
     Q_UNUSED(caCertificatePaths)
     Q_UNUSED(userIdSeparation)
+    Q_UNUSED(precompileQml)
+    Q_UNUSED(ioPriority)
+    Q_UNUSED(ioBandwidthLimit)
 #endif // AM_DISABLE_INSTALLER
 }
 
@@ -579,11 +606,13 @@ void Main::setupQmlEngine(const QStringList &importPaths, const QString &quickCo
 
     // monitor-lib
     qmlRegisterType<CpuStatus>("QtApplicationManager", 2, 0, "CpuStatus");
+    qmlRegisterType<CpuCoresStatus>("QtApplicationManager", 2, 0, "CpuCoresStatus");
     qmlRegisterType<WindowFrameTimer>("QtApplicationManager", 2, 0, "FrameTimer");
     qmlRegisterType<GpuStatus>("QtApplicationManager", 2, 0, "GpuStatus");
     qmlRegisterType<IoStatus>("QtApplicationManager", 2, 0, "IoStatus");
     qmlRegisterType<MemoryStatus>("QtApplicationManager", 2, 0, "MemoryStatus");
     qmlRegisterType<MonitorModel>("QtApplicationManager", 2, 0, "MonitorModel");
+    qmlRegisterType<PressureStatus>("QtApplicationManager", 2, 0, "PressureStatus");
     qmlRegisterType<ProcessStatus>("QtApplicationManager.SystemUI", 2, 0, "ProcessStatus");
 
     StartupTimer::instance()->checkpoint("after QML registrations");
@@ -614,7 +643,8 @@ void Main::setupWindowTitle(const QString &title, const QString &iconPath)
 }
 
 void Main::setupWindowManager(const QString &waylandSocketName, const QVariantList &waylandExtraSockets,
-                              bool slowAnimations, bool noUiWatchdog, bool allowUnknownUiClients)
+                              bool slowAnimations, bool noUiWatchdog, const QVariantMap &uiWatchdogConfiguration,
+                              bool allowUnknownUiClients)
 {
     QUnifiedTimer::instance()->setSlowModeEnabled(slowAnimations);
 
@@ -622,6 +652,7 @@ void Main::setupWindowManager(const QString &waylandSocketName, const QVariantLi
     m_windowManager->setAllowUnknownUiClients(m_noSecurity || allowUnknownUiClients);
     m_windowManager->setSlowAnimations(slowAnimations);
     m_windowManager->enableWatchdog(!noUiWatchdog);
+    m_windowManager->setWatchdogConfiguration(uiWatchdogConfiguration);
 
 #if defined(QT_WAYLANDCOMPOSITOR_LIB)
     connect(&m_windowManager->internalSignals, &WindowManagerInternalSignals::compositorAboutToBeCreated,
@@ -82,15 +82,20 @@ protected:
     void setupIntents(int disambiguationTimeout, int startApplicationTimeout,
                       int replyFromApplicationTimeout, int replyFromSystemTimeout) Q_DECL_NOEXCEPT_EXPR(false);
     void setupSingletons(const QList<QPair<QString, QString>> &containerSelectionConfiguration,
-                         int quickLaunchRuntimesPerContainer, qreal quickLaunchIdleLoad) Q_DECL_NOEXCEPT_EXPR(false);
+                         int quickLaunchRuntimesPerContainer, qreal quickLaunchIdleLoad,
+                         int maximumConcurrentApplicationStarts, int applicationStartTimeout,
+                         const QVariantMap &applicationEvictionPolicy) Q_DECL_NOEXCEPT_EXPR(false);
     void setupInstaller(bool devMode, bool allowUnsigned, const QStringList &caCertificatePaths,
-                        const std::function<bool(uint *, uint *, uint *)> &userIdSeparation) Q_DECL_NOEXCEPT_EXPR(false);
+                        const std::function<bool(uint *, uint *, uint *)> &userIdSeparation,
+                        bool precompileQml = false, const QString &ioPriority = QString(),
+                        quint64 ioBandwidthLimit = 0) Q_DECL_NOEXCEPT_EXPR(false);
     void registerPackages();
 
     void setupQmlEngine(const QStringList &importPaths, const QString &quickControlsStyle = QString());
     void setupWindowTitle(const QString &title, const QString &iconPath);
     void setupWindowManager(const QString &waylandSocketName, const QVariantList &waylandExtraSockets,
-                            bool slowAnimations, bool noUiWatchdog, bool allowUnknownUiClients);
+                            bool slowAnimations, bool noUiWatchdog, const QVariantMap &uiWatchdogConfiguration,
+                            bool allowUnknownUiClients);
 
     enum SystemProperties {
         SP_ThirdParty = 0,
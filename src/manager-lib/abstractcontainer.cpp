@@ -8,6 +8,10 @@
 #include "application.h"
 #include "abstractcontainer.h"
 
+#if defined(Q_OS_UNIX)
+#  include <csignal>
+#endif
+
 
 /*!
     \qmltype Container
@@ -53,6 +57,21 @@ bool AbstractContainer::setControlGroup(const QString &groupName)
     return false;
 }
 
+bool AbstractContainer::setFrozen(bool frozen)
+{
+    // The generic fallback only stops the main process: containers that have a better way to
+    // freeze all of the application's processes at once should override this function.
+#if defined(Q_OS_UNIX)
+    qint64 pid = m_process ? m_process->processId() : 0;
+    if (pid <= 0)
+        return false;
+    return ::kill(pid_t(pid), frozen ? SIGSTOP : SIGCONT) == 0;
+#else
+    Q_UNUSED(frozen)
+    return false;
+#endif
+}
+
 bool AbstractContainer::setProgram(const QString &program)
 {
     if (!m_program.isEmpty())
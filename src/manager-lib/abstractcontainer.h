@@ -73,6 +73,8 @@ public:
     virtual QString controlGroup() const;
     virtual bool setControlGroup(const QString &groupName);
 
+    virtual bool setFrozen(bool frozen);
+
     virtual bool setProgram(const QString &program);
     virtual void setBaseDirectory(const QString &baseDirectory);
 
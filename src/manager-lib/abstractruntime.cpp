@@ -132,6 +132,27 @@ void AbstractRuntime::setState(Am::RunState newState)
     }
 }
 
+bool AbstractRuntime::freeze()
+{
+    if (m_state == Am::Suspended)
+        return true;
+    // in-process runtimes have no container and can never be frozen
+    if ((m_state != Am::Running) || !m_container || !m_container->setFrozen(true))
+        return false;
+    setState(Am::Suspended);
+    return true;
+}
+
+bool AbstractRuntime::thaw()
+{
+    if (m_state != Am::Suspended)
+        return (m_state == Am::Running);
+    if (!m_container || !m_container->setFrozen(false))
+        return false;
+    setState(Am::Running);
+    return true;
+}
+
 void AbstractRuntime::setInProcessQmlEngine(QQmlEngine *engine)
 {
     m_inProcessQmlEngine = engine;
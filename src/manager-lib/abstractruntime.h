@@ -108,6 +108,9 @@ public:
     virtual bool start() = 0;
     virtual void stop(bool forceKill = false) = 0;
 
+    bool freeze();
+    bool thaw();
+
     static RuntimeSignaler* signaler();
 
 signals:
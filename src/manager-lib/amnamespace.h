@@ -33,6 +33,7 @@ public:
         StartingUp,
         Running,
         ShuttingDown,
+        Suspended,
     };
     Q_ENUM(RunState)
 
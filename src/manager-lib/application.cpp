@@ -129,6 +129,8 @@
     \li Am.Running - the application is running.
     \li Am.ShuttingDown - the application has been stopped and is cleaning up (in multi-process mode
                           this state is only reached, if the application is terminating gracefully).
+    \li Am.Suspended - the application has been frozen via ApplicationManager::freezeApplication()
+                       and is not scheduled anymore, but its memory is kept resident.
     \endlist
 */
 /*!
@@ -12,6 +12,8 @@
 #include <QMetaObject>
 #include <QUuid>
 #include <QThread>
+#include <QThreadPool>
+#include <QTimer>
 #include <QMimeDatabase>
 #include <qplatformdefs.h>
 #if defined(QT_GUI_LIB)
@@ -45,7 +47,11 @@
 #include "amnamespace.h"
 #include "package.h"
 #include "packagemanager.h"
+#include "evictionpolicy.h"
+#include "startscheduler.h"
+#include "processreader.h"
 
+#include <algorithm>
 #include <memory>
 
 /*!
@@ -280,6 +286,41 @@
           ApplicationManager model: applicationAdded, applicationAboutToBeRemoved and applicationChanged.
 */
 
+/*!
+    \qmlsignal ApplicationManager::applicationStartTimes(string id, int queueTime, int startupTime)
+
+    This signal is emitted after the application identified by \a id has been started successfully.
+    The \a queueTime is the time in milliseconds the start request spent waiting for a free start
+    slot (see \l{maximumConcurrentStarts}{applications/maximumConcurrentStarts} in the
+    configuration), while the \a startupTime is the time in milliseconds between the actual
+    start and the application's run state changing to \c Running.
+*/
+
+/*!
+    \qmlsignal ApplicationManager::applicationEvictionRequested(string requestId, string id, string reason)
+
+    This signal is emitted, if the eviction policy (see \l{evictionPolicy}{applications/evictionPolicy}
+    in the configuration) decided to stop the background application identified by \a id in order
+    to free memory. The \a reason is either \c memoryLow or \c memoryCritical.
+
+    If this signal is connected, the System UI can veto the eviction by calling
+    rejectEvictionRequest, or allow it right away by calling acknowledgeEvictionRequest. In both
+    cases the unique \a requestId needs to be passed. If the System UI does not answer within the
+    policy's \c vetoTimeout, the application will be evicted.
+
+    \sa applicationEvicted
+*/
+
+/*!
+    \qmlsignal ApplicationManager::applicationEvicted(string id, string reason)
+
+    This signal is emitted, after the eviction policy asked the application identified by \a id to
+    quit, because the system was running low on memory. The \a reason is either \c memoryLow or
+    \c memoryCritical.
+
+    \sa applicationEvictionRequested
+*/
+
 /*!
     \qmlproperty bool ApplicationManager::windowManagerCompositorReady
     \readonly
@@ -344,6 +385,7 @@ ApplicationManagerPrivate::ApplicationManagerPrivate()
 
 ApplicationManagerPrivate::~ApplicationManagerPrivate()
 {
+    delete evictionPool; // waits for a running PSS measurement
     for (const QString &scheme : qAsConst(registeredMimeSchemes))
         QDesktopServices::unsetUrlHandler(scheme);
     qDeleteAll(apps);
@@ -418,6 +460,20 @@ ApplicationManager::ApplicationManager(bool singleProcess, QObject *parent)
     connect(this, &QAbstractItemModel::rowsRemoved, this, &ApplicationManager::countChanged);
     connect(this, &QAbstractItemModel::layoutChanged, this, &ApplicationManager::countChanged);
     connect(this, &QAbstractItemModel::modelReset, this, &ApplicationManager::countChanged);
+
+    d->startScheduler = new StartScheduler(this);
+    connect(d->startScheduler, &StartScheduler::startTimes,
+            this, &ApplicationManager::applicationStartTimes);
+
+    d->evictionPolicy = new EvictionPolicy(this);
+    connect(d->evictionPolicy, &EvictionPolicy::memoryLow,
+            this, &ApplicationManager::memoryLowWarning);
+    connect(d->evictionPolicy, &EvictionPolicy::memoryCritical,
+            this, &ApplicationManager::memoryCriticalWarning);
+    connect(d->evictionPolicy, &EvictionPolicy::evictionRequired,
+            this, [this](EvictionPolicy::Reason reason, quint64 bytesToFree) {
+        evictApplications(EvictionPolicy::reasonToString(reason), bytesToFree);
+    });
 }
 
 ApplicationManager::~ApplicationManager()
@@ -596,7 +652,8 @@ void ApplicationManager::registerMimeTypes()
 bool ApplicationManager::startApplicationInternal(const QString &appId, const QString &documentUrl,
                                                   const QString &documentMimeType,
                                                   const QString &debugWrapperSpecification,
-                                                  QVector<int> &&stdioRedirections)  Q_DECL_NOEXCEPT_EXPR(false)
+                                                  QVector<int> &&stdioRedirections,
+                                                  StartPriority priority)  Q_DECL_NOEXCEPT_EXPR(false)
 {
     auto redirectionGuard = qScopeGuard([&stdioRedirections]() {
         closeAndClearFileDescriptors(stdioRedirections);
@@ -651,6 +708,10 @@ bool ApplicationManager::startApplicationInternal(const QString &appId, const QS
 
     if (runtime) {
         switch (runtime->state()) {
+        case Am::Suspended:
+            if (!runtime->thaw())
+                throw Exception("Application %1 is frozen and could not be thawed").arg(app->id());
+            Q_FALLTHROUGH();
         case Am::StartingUp:
         case Am::Running:
             if (!debugWrapperCommand.isEmpty()) {
@@ -677,6 +738,20 @@ bool ApplicationManager::startApplicationInternal(const QString &appId, const QS
         }
     }
 
+    // the start of this application might have been queued already
+    if (d->startScheduler->isQueued(app->id())) {
+        if (!debugWrapperCommand.isEmpty() || hasStdioRedirections) {
+            throw Exception("Application %1 is already queued for starting - cannot start with a "
+                            "debug-wrapper or standard IO redirections").arg(app->id());
+        }
+        if (runtime && !documentUrl.isNull())
+            runtime->openDocument(documentUrl, documentMimeType);
+
+        if (priority == UserStart)
+            d->startScheduler->promote(app->id());
+        return true;
+    }
+
     AbstractContainer *container = nullptr;
     QString containerId;
 
@@ -793,6 +868,10 @@ bool ApplicationManager::startApplicationInternal(const QString &appId, const QS
     }
 
     connect(runtime, &AbstractRuntime::stateChanged, this, [this, app](Am::RunState newRuntimeState) {
+        if ((newRuntimeState == Am::Running) || (newRuntimeState == Am::NotRunning))
+            d->startScheduler->finished(app->id(), newRuntimeState == Am::Running);
+        if (newRuntimeState == Am::NotRunning)
+            d->evictionPolicy->applicationStopped(app->id());
         app->setRunState(newRuntimeState);
         emit applicationRunStateChanged(app->id(), newRuntimeState);
         emitDataChanged(app, QVector<int> { IsRunning, IsStartingUp, IsShuttingDown });
@@ -820,15 +899,30 @@ bool ApplicationManager::startApplicationInternal(const QString &appId, const QS
         // Using a state-machine would be one option, but then we would need that state-machine
         // object plus the per-app state. Relying on 2 lambdas is the easier choice for now.
 
-        auto doStartInContainer = [this, app, attachRuntime, runtime]() -> bool {
-            bool successfullyStarted = attachRuntime ? runtime->attachApplicationToQuickLauncher(app)
-                                                     : runtime->start();
-            if (successfullyStarted)
-                emitActivated(app);
-            else
-                runtime->deleteLater(); // ~Runtime() will clean app->nonAliased()->m_runtime
+        auto doStartInContainer = [this, app, attachRuntime, runtime, priority]() -> bool {
+            QPointer<AbstractRuntime> guard(runtime);
+
+            auto start = [this, app, attachRuntime, guard]() -> bool {
+                if (!guard) // the runtime vanished while we were waiting in the queue
+                    return false;
+
+                bool successfullyStarted = attachRuntime ? guard->attachApplicationToQuickLauncher(app)
+                                                         : guard->start();
+                if (successfullyStarted)
+                    emitActivated(app);
+                else
+                    guard->deleteLater(); // ~Runtime() will clean app->nonAliased()->m_runtime
 
-            return successfullyStarted;
+                return successfullyStarted;
+            };
+            auto cancel = [guard]() {
+                if (guard)
+                    guard->deleteLater(); // ~Runtime() will clean app->nonAliased()->m_runtime
+            };
+
+            return d->startScheduler->schedule(app->id(), (priority == UserStart) ? StartScheduler::UserStart
+                                                                                  : StartScheduler::BackgroundStart,
+                                               start, cancel);
         };
 
         auto tryStartInContainer = [container, doStartInContainer]() -> bool {
@@ -860,11 +954,33 @@ void ApplicationManager::stopApplicationInternal(Application *app, bool forceKil
 {
     if (!app)
         return;
+    if (d->startScheduler->cancel(app->id()))
+        return;
     AbstractRuntime *rt = app->currentRuntime();
     if (rt)
         rt->stop(forceKill);
 }
 
+int ApplicationManager::maximumConcurrentStarts() const
+{
+    return d->startScheduler->maximumConcurrentStarts();
+}
+
+void ApplicationManager::setMaximumConcurrentStarts(int maximum)
+{
+    d->startScheduler->setMaximumConcurrentStarts(maximum);
+}
+
+int ApplicationManager::startTimeout() const
+{
+    return d->startScheduler->startTimeout();
+}
+
+void ApplicationManager::setStartTimeout(int msec)
+{
+    d->startScheduler->setStartTimeout(msec);
+}
+
 /*!
     \qmlmethod bool ApplicationManager::startApplication(string id, string document)
 
@@ -888,6 +1004,26 @@ bool ApplicationManager::startApplication(const QString &id, const QString &docu
     }
 }
 
+/*!
+    \qmlmethod bool ApplicationManager::startApplicationInBackground(string id, string document)
+
+    Works exactly like startApplication, but the start is marked as a background start (e.g. when
+    restoring a session or auto-starting services). If the number of concurrent application starts
+    is limited (see \l{maximumConcurrentStarts}{applications/maximumConcurrentStarts} in the
+    configuration), queued background starts will always be postponed in favor of user starts.
+
+    \sa startApplication
+*/
+bool ApplicationManager::startApplicationInBackground(const QString &id, const QString &documentUrl)
+{
+    try {
+        return startApplicationInternal(id, documentUrl, QString(), QString(), { }, BackgroundStart);
+    } catch (const Exception &e) {
+        qCWarning(LogSystem) << e.what();
+        return false;
+    }
+}
+
 /*!
     \qmlmethod bool ApplicationManager::debugApplication(string id, string debugWrapper, string document)
 
@@ -930,6 +1066,63 @@ void ApplicationManager::stopApplication(const QString &id, bool forceKill)
     return stopApplicationInternal(fromId(id), forceKill);
 }
 
+/*!
+    \qmlmethod bool ApplicationManager::freezeApplication(string id)
+
+    Freezes the running application identified by its unique \a id: the application's processes
+    will not be scheduled anymore, but they stay resident in memory. The application's run state
+    changes to \c Am.Suspended. Switching back to a frozen application via thawApplication or
+    startApplication is much faster than starting it again after it has been stopped.
+
+    On Linux systems using cgroup v2, the freezer of the application's control group is used,
+    which also covers any child processes. Otherwise the application's main process is stopped via
+    \c SIGSTOP. Applications using an in-process runtime cannot be frozen.
+
+    Returns \c true if the application is frozen, or \c false otherwise.
+
+    \sa thawApplication
+*/
+bool ApplicationManager::freezeApplication(const QString &id)
+{
+    Application *app = fromId(id);
+    if (!app) {
+        qCWarning(LogSystem) << "Cannot freeze application: id" << id << "is not known";
+        return false;
+    }
+    AbstractRuntime *rt = app->currentRuntime();
+    if (!rt || !rt->freeze()) {
+        qCWarning(LogSystem) << "Cannot freeze application" << id << "in run state" << app->runState();
+        return false;
+    }
+    return true;
+}
+
+/*!
+    \qmlmethod bool ApplicationManager::thawApplication(string id)
+
+    Resumes the application identified by its unique \a id after it has been frozen by
+    freezeApplication. The application's run state changes back to \c Am.Running. Starting a
+    frozen application via startApplication will also thaw it.
+
+    Returns \c true if the application is running, or \c false otherwise.
+
+    \sa freezeApplication
+*/
+bool ApplicationManager::thawApplication(const QString &id)
+{
+    Application *app = fromId(id);
+    if (!app) {
+        qCWarning(LogSystem) << "Cannot thaw application: id" << id << "is not known";
+        return false;
+    }
+    AbstractRuntime *rt = app->currentRuntime();
+    if (!rt || !rt->thaw()) {
+        qCWarning(LogSystem) << "Cannot thaw application" << id << "in run state" << app->runState();
+        return false;
+    }
+    return true;
+}
+
 /*!
     \qmlmethod ApplicationManager::stopAllApplications(bool forceKill)
 
@@ -1116,6 +1309,154 @@ void ApplicationManager::rejectOpenUrlRequest(const QString &requestId)
     }
 }
 
+void ApplicationManager::setEvictionPolicy(const QVariantMap &configuration)
+{
+    d->evictionPolicy->setConfiguration(configuration);
+}
+
+void ApplicationManager::evictApplications(const QString &reason, quint64 bytesToFree)
+{
+    // skip this pass, if the previous one is still measuring
+    if (d->shuttingDown || d->singleProcess || d->evictionMeasuring)
+        return;
+
+    QVector<EvictionPolicy::Candidate> candidates;
+    QVector<qint64> pids; // 0: do not measure
+    QStringList excluded = d->evictionPolicy->excludedApplications();
+
+    for (Application *app : qAsConst(d->apps)) {
+        AbstractRuntime *rt = app->currentRuntime();
+        if (!rt || rt->manager()->inProcess())
+            continue;
+        if ((rt->state() != Am::Running) && (rt->state() != Am::Suspended))
+            continue;
+
+        qint64 pid = rt->applicationProcessId();
+        if (std::any_of(d->evictionRequests.cbegin(), d->evictionRequests.cend(), [app](const auto &er) {
+                        return er.app == app; })) {
+            excluded << app->id();
+            pid = 0;
+        }
+        candidates << EvictionPolicy::Candidate { app->id(), d->evictionPolicy->lastActivation(app->id()), 0 };
+        pids << pid;
+    }
+
+    if (!d->evictionPool) {
+        d->evictionPool = new QThreadPool;
+        d->evictionPool->setMaxThreadCount(1);
+    }
+    d->evictionMeasuring = true;
+    const int protectedCount = d->evictionPolicy->protectedApplications();
+
+    // Parsing the smaps of every running application takes way too long to be done on the GUI
+    // thread, which would then be blocked exactly when the system is under memory pressure.
+    d->evictionPool->start([this, reason, bytesToFree, candidates, pids, excluded, protectedCount]() mutable {
+        for (int i = 0; i < candidates.size(); ++i) {
+            if (pids.at(i) <= 0)
+                continue;
+            // smaps reports KiB (although it says kB)
+            ProcessReader reader;
+            reader.setProcessId(pids.at(i));
+            reader.update();
+            candidates[i].pss = quint64(reader.memory.totalPss) << 10;
+        }
+        const QStringList victims = EvictionPolicy::selectVictims(candidates, protectedCount,
+                                                                  excluded, bytesToFree);
+        QMetaObject::invokeMethod(this, [this, reason, bytesToFree, victims]() {
+            d->evictionMeasuring = false;
+            evictVictims(reason, bytesToFree, victims);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ApplicationManager::evictVictims(const QString &reason, quint64 bytesToFree, const QStringList &victims)
+{
+    if (d->shuttingDown)
+        return;
+
+    if (victims.isEmpty()) {
+        qCWarning(LogSystem) << "Eviction policy: need to free" << (bytesToFree >> 20)
+                             << "MB of memory, but there are no applications left to evict";
+        return;
+    }
+
+    for (const QString &id : victims) {
+        // the application might have been stopped or removed while its PSS was measured
+        Application *app = fromId(id);
+        AbstractRuntime *rt = app ? app->currentRuntime() : nullptr;
+        if (!rt || ((rt->state() != Am::Running) && (rt->state() != Am::Suspended)))
+            continue;
+
+        if (!isSignalConnected(QMetaMethod::fromSignal(&ApplicationManager::applicationEvictionRequested))) {
+            evictApplication(app, reason);
+            continue;
+        }
+
+        ApplicationManagerPrivate::EvictionRequest req { QUuid::createUuid().toString(), app, reason };
+        d->evictionRequests << req;
+
+        // no answer within the timeout means that the System UI does not object
+        QTimer::singleShot(d->evictionPolicy->vetoTimeout(), this, [this, requestId = req.requestId]() {
+            acknowledgeEvictionRequest(requestId);
+        });
+        emit applicationEvictionRequested(req.requestId, id, reason);
+    }
+}
+
+void ApplicationManager::evictApplication(Application *app, const QString &reason)
+{
+    AbstractRuntime *rt = app ? app->currentRuntime() : nullptr;
+    if (!rt || ((rt->state() != Am::Running) && (rt->state() != Am::Suspended)))
+        return;
+
+    qCInfo(LogSystem) << "Eviction policy: stopping application" << app->id() << "due to" << reason;
+
+    // this is not a forced kill: the application gets a quit request first
+    stopApplicationInternal(app, false);
+    emit applicationEvicted(app->id(), reason);
+}
+
+/*!
+    \qmlmethod ApplicationManager::acknowledgeEvictionRequest(string requestId)
+
+    Allows the eviction of an application, identified by the \a requestId that was given by the
+    applicationEvictionRequested signal.
+
+    \sa applicationEvictionRequested
+*/
+void ApplicationManager::acknowledgeEvictionRequest(const QString &requestId)
+{
+    for (auto it = d->evictionRequests.cbegin(); it != d->evictionRequests.cend(); ++it) {
+        if (it->requestId == requestId) {
+            QPointer<Application> app = it->app;
+            QString reason = it->reason;
+            d->evictionRequests.erase(it);
+            evictApplication(app, reason);
+            break;
+        }
+    }
+}
+
+/*!
+    \qmlmethod ApplicationManager::rejectEvictionRequest(string requestId)
+
+    Vetoes the eviction of an application, identified by the \a requestId that was given by the
+    applicationEvictionRequested signal.
+
+    \sa applicationEvictionRequested
+*/
+void ApplicationManager::rejectEvictionRequest(const QString &requestId)
+{
+    for (auto it = d->evictionRequests.cbegin(); it != d->evictionRequests.cend(); ++it) {
+        if (it->requestId == requestId) {
+            qCDebug(LogSystem) << "Eviction policy: the System UI vetoed the eviction of"
+                               << (it->app ? it->app->id() : QString());
+            d->evictionRequests.erase(it);
+            break;
+        }
+    }
+}
+
 /*!
     \qmlmethod list<string> ApplicationManager::capabilities(string id)
 
@@ -1172,6 +1513,8 @@ void ApplicationManager::shutDown()
     d->shuttingDown = true;
     emit shuttingDownChanged();
 
+    d->startScheduler->cancelAll();
+
     auto shutdownHelper = [this]() {
         bool activeRuntime = false;
         for (Application *app : qAsConst(d->apps)) {
@@ -1223,6 +1566,7 @@ void ApplicationManager::emitDataChanged(Application *app, const QVector<int> &r
 
 void ApplicationManager::emitActivated(Application *app)
 {
+    d->evictionPolicy->applicationActivated(app->id());
     emit applicationWasActivated(app->id(), app->id());
     emit app->activated();
 }
@@ -1491,6 +1835,7 @@ void ApplicationManager::removeApplication(ApplicationInfo *appInfo, Package *pa
 
     registerMimeTypes();
 
+    d->startScheduler->remove(app->id());
     delete app;
 }
 
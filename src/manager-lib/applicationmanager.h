@@ -9,6 +9,7 @@
 #include <QStringList>
 #include <QVariantList>
 #include <QJSValue>
+#include <functional>
 #include <QtAppManCommon/global.h>
 #include <QtAppManManager/application.h>
 
@@ -47,6 +48,12 @@ class ApplicationManager : public QAbstractListModel
     Q_PROPERTY(QJSValue containerSelectionFunction READ containerSelectionFunction WRITE setContainerSelectionFunction NOTIFY containerSelectionFunctionChanged)
 
 public:
+    enum StartPriority {
+        BackgroundStart,
+        UserStart
+    };
+    Q_ENUM(StartPriority)
+
     ~ApplicationManager() override;
     static ApplicationManager *createInstance(bool singleProcess);
     static ApplicationManager *instance();
@@ -71,9 +78,16 @@ public:
     bool startApplicationInternal(const QString &appId, const QString &documentUrl = QString(),
                                   const QString &documentMimeType = QString(),
                                   const QString &debugWrapperSpecification = QString(),
-                                  QVector<int> &&stdioRedirections = QVector<int>()) Q_DECL_NOEXCEPT_EXPR(false);
+                                  QVector<int> &&stdioRedirections = QVector<int>(),
+                                  StartPriority priority = UserStart) Q_DECL_NOEXCEPT_EXPR(false);
     void stopApplicationInternal(Application *app, bool forceKill = false);
 
+    // start scheduling
+    int maximumConcurrentStarts() const;
+    void setMaximumConcurrentStarts(int maximum);
+    int startTimeout() const;
+    void setStartTimeout(int msec);
+
     // only use these two functions for development!
     bool securityChecksEnabled() const;
     void setSecurityChecksEnabled(bool enabled);
@@ -102,13 +116,20 @@ public:
     Q_INVOKABLE void acknowledgeOpenUrlRequest(const QString &requestId, const QString &appId);
     Q_INVOKABLE void rejectOpenUrlRequest(const QString &requestId);
 
+    void setEvictionPolicy(const QVariantMap &configuration);
+    Q_INVOKABLE void acknowledgeEvictionRequest(const QString &requestId);
+    Q_INVOKABLE void rejectEvictionRequest(const QString &requestId);
+
     // DBus interface
     Q_SCRIPTABLE QStringList applicationIds() const;
     Q_SCRIPTABLE QVariantMap get(const QString &id) const;
     Q_SCRIPTABLE bool startApplication(const QString &id, const QString &documentUrl = QString());
+    Q_SCRIPTABLE bool startApplicationInBackground(const QString &id, const QString &documentUrl = QString());
     Q_SCRIPTABLE bool debugApplication(const QString &id, const QString &debugWrapper, const QString &documentUrl = QString());
     Q_SCRIPTABLE void stopApplication(const QString &id, bool forceKill = false);
     Q_SCRIPTABLE void stopAllApplications(bool forceKill = false);
+    Q_SCRIPTABLE bool freezeApplication(const QString &id);
+    Q_SCRIPTABLE bool thawApplication(const QString &id);
     Q_SCRIPTABLE bool openUrl(const QString &url);
     Q_SCRIPTABLE QStringList capabilities(const QString &id) const;
     Q_SCRIPTABLE QString identifyApplication(qint64 pid) const;
@@ -133,6 +154,11 @@ signals:
 
     void openUrlRequested(const QString &requestId, const QString &url, const QString &mimeType, const QStringList &possibleAppIds);
 
+    void applicationStartTimes(const QString &id, int queueTime, int startupTime);
+
+    void applicationEvictionRequested(const QString &requestId, const QString &id, const QString &reason);
+    void applicationEvicted(const QString &id, const QString &reason);
+
     void memoryLowWarning();
     void memoryCriticalWarning();
 
@@ -147,6 +173,9 @@ private:
     void emitDataChanged(Application *app, const QVector<int> &roles = QVector<int>());
     void emitActivated(Application *app);
     void registerMimeTypes();
+    void evictApplications(const QString &reason, quint64 bytesToFree);
+    void evictVictims(const QString &reason, quint64 bytesToFree, const QStringList &victims);
+    void evictApplication(Application *app, const QString &reason);
 
     ApplicationManager(bool singleProcess, QObject *parent = nullptr);
     ApplicationManager(const ApplicationManager &);
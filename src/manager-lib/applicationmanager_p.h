@@ -9,8 +9,15 @@
 #include <QVariantMap>
 #include <QJSValue>
 #include <QSet>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <functional>
 #include <QtAppManCommon/global.h>
 #include <QtAppManManager/applicationmanager.h>
+#include <QtAppManManager/evictionpolicy.h>
+#include <QtAppManManager/startscheduler.h>
+
+QT_FORWARD_DECLARE_CLASS(QThreadPool)
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -42,6 +49,22 @@ public:
 
     QVector<OpenUrlRequest> openUrlRequests;
 
+    // out-of-process starts beyond maximumConcurrentStarts are queued
+    StartScheduler *startScheduler = nullptr;
+
+    // memory pressure based eviction of background applications
+    struct EvictionRequest
+    {
+        QString requestId;
+        QPointer<Application> app;
+        QString reason;
+    };
+
+    EvictionPolicy *evictionPolicy = nullptr;
+    QVector<EvictionRequest> evictionRequests;
+    QThreadPool *evictionPool = nullptr; // measures the PSS of the candidates
+    bool evictionMeasuring = false;
+
     ApplicationManagerPrivate();
     ~ApplicationManagerPrivate();
 };
@@ -6,8 +6,16 @@
 #include <QUuid>
 
 #include "global.h"
+#include "logging.h"
 #include "asynchronoustask.h"
 
+#if defined(Q_OS_LINUX)
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#  include <cerrno>
+#  include <cstring>
+#endif
+
 QT_BEGIN_NAMESPACE_AM
 
 AsynchronousTask::AsynchronousTask(QObject *parent)
@@ -71,6 +79,16 @@ QString AsynchronousTask::packageId() const
     return m_packageId;
 }
 
+AsynchronousTask::IoPriority AsynchronousTask::ioPriority() const
+{
+    return m_ioPriority;
+}
+
+void AsynchronousTask::setIoPriority(IoPriority ioPriority)
+{
+    m_ioPriority = ioPriority;
+}
+
 bool AsynchronousTask::preExecute()
 {
     return true;
@@ -90,6 +108,23 @@ void AsynchronousTask::setError(Error errorCode, const QString &errorString)
 
 void AsynchronousTask::run()
 {
+#if defined(SYS_ioprio_set)
+    // Package extraction, removal and the fsyncs at the end can easily saturate the flash
+    // storage of an embedded device, which makes the System UI and the applications stutter
+    // while loading their QML and images. Linux lets us set the I/O priority per thread, so
+    // this only affects this task's thread and not the rest of the application manager.
+    // (this is a no-op with I/O schedulers that do not support priorities, e.g. mq-deadline)
+    if (m_ioPriority != NormalIoPriority) {
+        enum { IoPrioWhoProcess = 1, IoPrioClassShift = 13, IoPrioClassBestEffort = 2, IoPrioClassIdle = 3 };
+
+        const int ioprio = (m_ioPriority == IdleIoPriority) ? (IoPrioClassIdle << IoPrioClassShift)
+                                                            : ((IoPrioClassBestEffort << IoPrioClassShift) | 7);
+        if (::syscall(SYS_ioprio_set, IoPrioWhoProcess, 0 /* calling thread */, ioprio) < 0) {
+            qCWarning(LogInstaller) << "Could not set the I/O priority of task" << m_id << ":"
+                                    << strerror(errno);
+        }
+    }
+#endif
     execute();
 }
 
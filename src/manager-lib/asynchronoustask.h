@@ -32,6 +32,14 @@ public:
     };
     Q_ENUM(TaskState)
 
+    enum IoPriority
+    {
+        NormalIoPriority, // same as the application manager itself
+        LowIoPriority,    // best-effort class, lowest level
+        IdleIoPriority    // only when nobody else needs the disk
+    };
+    Q_ENUM(IoPriority)
+
     AsynchronousTask(QObject *parent = nullptr);
 
     QString id() const;
@@ -48,6 +56,9 @@ public:
 
     QString packageId() const; // convenience
 
+    IoPriority ioPriority() const;
+    void setIoPriority(IoPriority ioPriority); // needs to be called before start()
+
     virtual bool preExecute();
     virtual bool postExecute();
 
@@ -68,6 +79,7 @@ protected:
     TaskState m_state = Queued;
     Error m_errorCode = Error::None;
     QString m_errorString;
+    IoPriority m_ioPriority = NormalIoPriority;
 };
 
 
@@ -0,0 +1,169 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <algorithm>
+
+#include <QTimer>
+
+#include "global.h"
+#include "logging.h"
+#include "evictionpolicy.h"
+#include "systemreader.h"
+
+
+QT_BEGIN_NAMESPACE_AM
+
+EvictionPolicy::EvictionPolicy(QObject *parent)
+    : QObject(parent)
+    , m_graceTimer(new QTimer(this))
+{
+    m_clock.start();
+
+    m_graceTimer->setSingleShot(true);
+    m_graceTimer->setInterval(2000);
+    connect(m_graceTimer, &QTimer::timeout, this, [this]() {
+        // the applications had their chance to free memory on their own
+        quint64 toFree = bytesToFree();
+        if (toFree)
+            emit evictionRequired(MemoryLow, toFree);
+    });
+}
+
+EvictionPolicy::~EvictionPolicy()
+{ }
+
+void EvictionPolicy::setConfiguration(const QVariantMap &configuration)
+{
+    m_enabled = configuration.value(qSL("enabled"), false).toBool();
+    m_lowThreshold = configuration.value(qSL("memoryLowThreshold"), 75.0).toReal();
+    m_criticalThreshold = configuration.value(qSL("memoryCriticalThreshold"), 90.0).toReal();
+    m_targetUsage = configuration.value(qSL("targetMemoryUsage"), 70.0).toReal();
+    m_protectedApplications = qMax(0, configuration.value(qSL("protectedApplications"), 1).toInt());
+    m_excludedApplications = configuration.value(qSL("excludedApplications")).toStringList();
+    m_vetoTimeout = qMax(0, configuration.value(qSL("vetoTimeout"), 1000).toInt());
+    m_graceTimer->setInterval(qMax(0, configuration.value(qSL("gracePeriod"), 2000).toInt()));
+
+    delete m_watcher;
+    m_watcher = nullptr;
+    m_reader.reset();
+    m_graceTimer->stop();
+
+    if (!m_enabled)
+        return;
+
+    if (m_targetUsage >= m_lowThreshold) {
+        qCWarning(LogSystem) << "The eviction policy's targetMemoryUsage (" << m_targetUsage
+                             << "%) should be lower than its memoryLowThreshold (" << m_lowThreshold << "%)";
+    }
+
+    m_reader.reset(new MemoryReader);
+
+#if defined(Q_OS_LINUX)
+    m_watcher = new MemoryWatcher(this);
+    m_watcher->setThresholds(m_lowThreshold, m_criticalThreshold);
+    connect(m_watcher, &MemoryWatcher::memoryLow, this, &EvictionPolicy::onMemoryLow);
+    connect(m_watcher, &MemoryWatcher::memoryCritical, this, &EvictionPolicy::onMemoryCritical);
+    if (!m_watcher->startWatching())
+        qCWarning(LogSystem) << "Could not start watching the system memory: applications will not be evicted";
+#else
+    qCWarning(LogSystem) << "Memory pressure based application eviction is not supported on this platform";
+#endif
+}
+
+bool EvictionPolicy::isEnabled() const
+{
+    return m_enabled;
+}
+
+int EvictionPolicy::protectedApplications() const
+{
+    return m_protectedApplications;
+}
+
+QStringList EvictionPolicy::excludedApplications() const
+{
+    return m_excludedApplications;
+}
+
+int EvictionPolicy::vetoTimeout() const
+{
+    return m_vetoTimeout;
+}
+
+void EvictionPolicy::applicationActivated(const QString &id)
+{
+    m_lastActivation.insert(id, m_clock.elapsed());
+}
+
+void EvictionPolicy::applicationStopped(const QString &id)
+{
+    m_lastActivation.remove(id);
+}
+
+qint64 EvictionPolicy::lastActivation(const QString &id) const
+{
+    return m_lastActivation.value(id, -1);
+}
+
+quint64 EvictionPolicy::bytesToFree() const
+{
+    if (!m_reader)
+        return 0;
+
+    const quint64 used = m_reader->readUsedValue();
+    const quint64 target = quint64(m_reader->totalValue() * m_targetUsage / 100.0);
+    return (used > target) ? (used - target) : 0;
+}
+
+QString EvictionPolicy::reasonToString(Reason reason)
+{
+    return (reason == MemoryCritical) ? qSL("memoryCritical") : qSL("memoryLow");
+}
+
+QStringList EvictionPolicy::selectVictims(QVector<Candidate> candidates, int protectedCount,
+                                          const QStringList &excluded, quint64 bytesToFree)
+{
+    // most recently activated first, never activated ones last
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &c1, const Candidate &c2) {
+        return c1.lastActivation > c2.lastActivation;
+    });
+
+    // the protected applications are taken from all candidates, so that excluding an application
+    // does not lead to the eviction of one more recently used application
+    candidates.remove(0, qMin(qMax(0, protectedCount), candidates.size()));
+
+    QStringList victims;
+    quint64 freed = 0;
+    for (auto it = candidates.crbegin(); (it != candidates.crend()) && (freed < bytesToFree); ++it) {
+        if (excluded.contains(it->id))
+            continue;
+        victims << it->id;
+        // if we do not know how much memory the application is using, we need to re-evaluate
+        // the situation after it has been stopped
+        freed = it->pss ? (freed + it->pss) : bytesToFree;
+    }
+    return victims;
+}
+
+void EvictionPolicy::onMemoryLow()
+{
+    qCDebug(LogSystem) << "Eviction policy: system memory is low";
+    emit memoryLow();
+    if (!m_graceTimer->isActive())
+        m_graceTimer->start();
+}
+
+void EvictionPolicy::onMemoryCritical()
+{
+    qCDebug(LogSystem) << "Eviction policy: system memory is critical";
+    m_graceTimer->stop();
+    emit memoryCritical();
+
+    quint64 toFree = bytesToFree();
+    if (toFree)
+        emit evictionRequired(MemoryCritical, toFree);
+}
+
+QT_END_NAMESPACE_AM
+
+#include "moc_evictionpolicy.cpp"
@@ -0,0 +1,88 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#pragma once
+
+#include <memory>
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+
+#include <QtAppManCommon/global.h>
+
+QT_FORWARD_DECLARE_CLASS(QTimer)
+
+QT_BEGIN_NAMESPACE_AM
+
+class MemoryReader;
+class MemoryWatcher;
+
+// Decides when and which background applications should be stopped to relieve memory pressure.
+// The actual stopping (including the System UI's veto) is done by the ApplicationManager.
+class EvictionPolicy : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Reason {
+        MemoryLow,
+        MemoryCritical
+    };
+    Q_ENUM(Reason)
+
+    struct Candidate
+    {
+        QString id;
+        qint64 lastActivation = -1; // msecs since the policy was created; -1: never activated
+        quint64 pss = 0;            // bytes; 0: unknown
+    };
+
+    explicit EvictionPolicy(QObject *parent = nullptr);
+    ~EvictionPolicy() override;
+
+    void setConfiguration(const QVariantMap &configuration);
+
+    bool isEnabled() const;
+    int protectedApplications() const;
+    QStringList excludedApplications() const;
+    int vetoTimeout() const;
+
+    void applicationActivated(const QString &id);
+    void applicationStopped(const QString &id);
+    qint64 lastActivation(const QString &id) const;
+
+    quint64 bytesToFree() const;
+
+    static QString reasonToString(Reason reason);
+    static QStringList selectVictims(QVector<Candidate> candidates, int protectedCount,
+                                     const QStringList &excluded, quint64 bytesToFree);
+
+signals:
+    void memoryLow();
+    void memoryCritical();
+    void evictionRequired(QT_PREPEND_NAMESPACE_AM(EvictionPolicy)::Reason reason, quint64 bytesToFree);
+
+private:
+    void onMemoryLow();
+    void onMemoryCritical();
+
+    bool m_enabled = false;
+    qreal m_lowThreshold = 75.0;
+    qreal m_criticalThreshold = 90.0;
+    qreal m_targetUsage = 70.0;
+    int m_protectedApplications = 1;
+    QStringList m_excludedApplications;
+    int m_vetoTimeout = 1000;
+
+    QElapsedTimer m_clock;
+    QHash<QString, qint64> m_lastActivation;
+    QTimer *m_graceTimer;
+    MemoryWatcher *m_watcher = nullptr;
+    std::unique_ptr<MemoryReader> m_reader;
+};
+
+QT_END_NAMESPACE_AM
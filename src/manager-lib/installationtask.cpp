@@ -6,6 +6,11 @@
 #include <QTemporaryDir>
 #include <QMessageAuthenticationCode>
 #include <QPointer>
+#include <QDirIterator>
+#include <QLibraryInfo>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QThread>
 
 #include "logging.h"
 #include "packagemanager_p.h"
@@ -18,9 +23,13 @@
 #include "utilities.h"
 #include "signature.h"
 #include "sudo.h"
+#include "qml-utilities.h"
 #include "installationtask.h"
 
 #include <memory>
+#include <vector>
+#include <algorithm>
+#include <errno.h>
 
 /*
   Overview of what happens on an installation of an app with <id> to <location>:
@@ -40,6 +49,12 @@
   PackageExtractor does its job
 
 
+  Step 2.1 -- precompileQml() (optional)
+  =======================================
+
+  compile all QML and JS files in <extractiondir> into <extractiondir>/.qmlcache
+
+
   Step 3 -- finishInstallation()
   ================================
 
@@ -142,20 +157,30 @@ void InstallationTask::execute()
             throw Exception(Error::Canceled, "canceled");
 
         m_extractor = new PackageExtractor(m_sourceUrl, QDir(extractionDir.path()));
+        m_extractor->setWriteBandwidthLimit(m_pm->ioBandwidthLimit());
         locker.unlock();
 
         connect(m_extractor, &PackageExtractor::progress, this, &AsynchronousTask::progress);
 
         m_extractor->setFileExtractedCallback(std::bind(&InstallationTask::checkExtractedFile,
                                                         this, std::placeholders::_1));
+        if (m_pm->isApplicationUserIdSeparationEnabled()) {
+            m_extractor->setEntryWrittenCallback(std::bind(&InstallationTask::entryWritten, this,
+                                                           std::placeholders::_1, std::placeholders::_2));
+        }
 
         if (!m_extractor->extract())
             throw Exception(m_extractor->errorCode(), m_extractor->errorString());
 
+        if (m_extractor->throttledTime() > 0) {
+            qCDebug(LogInstaller) << "Extraction of" << m_sourceUrl << "was throttled for"
+                                  << m_extractor->throttledTime() << "msec";
+        }
+
         if (!m_foundInfo || !m_foundIcon)
             throw Exception(Error::Package, "package did not contain a valid info.yaml and icon file");
 
-        QList<QByteArray> chainOfTrust = m_pm->caCertificates();
+        const TrustStore trustStore = m_pm->caTrustStore();
 
         if (!m_pm->allowInstallationOfUnsignedPackages()) {
             if (!m_extractor->installationReport().storeSignature().isEmpty()) {
@@ -163,12 +188,12 @@ void InstallationTask::execute()
                 QByteArray sigDigest = m_extractor->installationReport().digest();
                 bool sigOk = false;
 
-                if (Signature(sigDigest).verify(m_extractor->installationReport().storeSignature(), chainOfTrust)) {
+                if (Signature(sigDigest).verify(m_extractor->installationReport().storeSignature(), trustStore)) {
                     sigOk = true;
                 } else if (!m_pm->hardwareId().isEmpty()) {
                     // did not verify - if we have a hardware-id, try to verify with it
                     sigDigest = QMessageAuthenticationCode::hash(sigDigest, m_pm->hardwareId().toUtf8(), QCryptographicHash::Sha256);
-                    if (Signature(sigDigest).verify(m_extractor->installationReport().storeSignature(), chainOfTrust))
+                    if (Signature(sigDigest).verify(m_extractor->installationReport().storeSignature(), trustStore))
                         sigOk = true;
                 }
                 if (!sigOk)
@@ -178,7 +203,7 @@ void InstallationTask::execute()
                 if (!m_pm->developmentMode())
                     throw Exception(Error::Package, "cannot install development packages on consumer devices");
 
-                if (!Signature(m_extractor->installationReport().digest()).verify(m_extractor->installationReport().developerSignature(), chainOfTrust))
+                if (!Signature(m_extractor->installationReport().digest()).verify(m_extractor->installationReport().developerSignature(), trustStore))
                     throw Exception(Error::Package, "could not verify the package's developer signature");
 
             } else {
@@ -201,6 +226,10 @@ void InstallationTask::execute()
 
         setState(Installing);
 
+        // this is done outside of the serialized section below, since it can take a while
+        if (m_pm->precompileQml())
+            precompileQml();
+
         // However many downloads are allowed to happen in parallel: we need to serialize those
         // tasks here for the finishInstallation() step
         QMutexLocker finishLocker(&s_serializeFinishInstallation);
@@ -221,6 +250,10 @@ void InstallationTask::execute()
     } catch (const Exception &e) {
         setError(e.errorCode(), e.errorString());
 
+        try {
+            waitForOwnerChanges(); // do not leave unanswered requests behind
+        } catch (const Exception &) { }
+
         if (m_managerApproval) {
             // we need to call those ApplicationManager methods in the correct thread
             bool cancelOk = false;
@@ -319,6 +352,10 @@ void InstallationTask::checkExtractedFile(const QString &file) Q_DECL_NOEXCEPT_E
         m_package->m_uid = m_pm->findUnusedUserId();
         m_applicationUid = m_package->m_uid;
 
+        // these two were extracted before we knew the user-id
+        setOwnerAndPermissions(m_extractionDir.filePath(qSL("info.yaml")));
+        setOwnerAndPermissions(m_extractionDir.filePath(m_iconFileName));
+
         // we need to call those ApplicationManager methods in the correct thread
         // this will also exclusively lock the application for us
         // m_package ownership is transferred to the ApplicationManager
@@ -345,6 +382,179 @@ void InstallationTask::checkExtractedFile(const QString &file) Q_DECL_NOEXCEPT_E
     }
 }
 
+void InstallationTask::entryWritten(const QString &entryPath, int fd) Q_DECL_NOEXCEPT_EXPR(false)
+{
+    // the first two files are extracted to a temporary directory before we know the user-id
+    if (m_applicationUid == uint(-1))
+        return;
+
+    const QString path = m_extractor->destinationDirectory().absoluteFilePath(entryPath);
+
+    // we still need to create files in directories and qmlcachegen needs to read the sources
+    static const QStringList qmlSuffixes = { qSL(".qml"), qSL(".js"), qSL(".mjs") };
+    bool defer = (fd < 0);
+    if (!defer && m_pm->precompileQml()) {
+        defer = std::any_of(qmlSuffixes.cbegin(), qmlSuffixes.cend(), [&entryPath](const QString &suffix) {
+            return entryPath.endsWith(suffix);
+        });
+    }
+    if (defer)
+        m_deferredOwnerChanges << path;
+    else
+        setOwnerAndPermissions(path, fd);
+}
+
+/*! \internal
+    With user-id separation enabled, all files and directories of a package are owned by the
+    application's user and are read-only. Files are changed right after they have been extracted,
+    via their still open file descriptor \a fd (\a path is opened, if \a fd is -1). This saves
+    a second, recursive pass over the whole package in finishInstallation(), where only the
+    directories (and QML sources, if they need to be precompiled) are handled.
+    The requests are pipelined to the SudoServer: the results are only collected by
+    waitForOwnerChanges().
+*/
+void InstallationTask::setOwnerAndPermissions(const QString &path, int fd) Q_DECL_NOEXCEPT_EXPR(false)
+{
+#ifdef Q_OS_UNIX
+    SudoClient *root = SudoClient::instance();
+
+    if (!m_pm->isApplicationUserIdSeparationEnabled() || !root || (m_applicationUid == uint(-1)))
+        return;
+
+    uid_t uid = m_applicationUid;
+    gid_t gid = m_pm->commonApplicationGroupId();
+
+    int ownFd = -1;
+    if (fd < 0) {
+        fd = ownFd = QT_OPEN(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw Exception(errno, "could not open %1 to change its owner and permission bits").arg(path);
+    }
+    m_pendingOwnerChanges.append({ root->submitSetOwnerAndPermissions(fd, uid, gid, 0440), path });
+    if (ownFd >= 0)
+        QT_CLOSE(ownFd);
+#else
+    Q_UNUSED(path)
+    Q_UNUSED(fd)
+#endif
+}
+
+void InstallationTask::waitForOwnerChanges() Q_DECL_NOEXCEPT_EXPR(false)
+{
+#ifdef Q_OS_UNIX
+    SudoClient *root = SudoClient::instance();
+    if (!root)
+        return;
+
+    // collect all replies, even if one of them failed already
+    QString failedPath;
+    QString errorString;
+    for (const auto &pending : qAsConst(m_pendingOwnerChanges)) {
+        QString error;
+        if (!root->waitForReply(pending.first, &error) && failedPath.isEmpty()) {
+            failedPath = pending.second;
+            errorString = error;
+        }
+    }
+    m_pendingOwnerChanges.clear();
+
+    if (!failedPath.isEmpty()) {
+        throw Exception(Error::IO, "could not change the owner to %1:%2 and the permission bits to %3 of %4: %5")
+                .arg(m_applicationUid).arg(m_pm->commonApplicationGroupId()).arg(0440, 0, 8)
+                .arg(failedPath, errorString);
+    }
+#endif
+}
+
+/*! \internal
+    Generates the QML disk cache files for the package, so that the first start of an app does not
+    need to compile its QML code. The cache files are named after the final location of the sources
+    (see qmlDiskCacheFileName()) and are picked up by the qml runtimes via seedQmlDiskCache().
+    This is purely an optimization: failures are logged, but do not fail the installation.
+*/
+void InstallationTask::precompileQml()
+{
+    static const QString compiler = []() {
+        QString path = QLibraryInfo::path(QLibraryInfo::LibraryExecutablesPath) + qSL("/qmlcachegen");
+        if (!QFileInfo(path).isExecutable())
+            path = QStandardPaths::findExecutable(qSL("qmlcachegen"));
+        return path;
+    }();
+
+    if (compiler.isEmpty()) {
+        qCWarning(LogInstaller) << "Cannot precompile the QML files of package" << m_packageId
+                                << "- qmlcachegen was not found";
+        return;
+    }
+
+    const QString cacheDirName = precompiledQmlCacheDirName();
+    const QString extractionPath = m_extractionDir.absolutePath();
+    QDir cacheDir(m_extractionDir.absoluteFilePath(cacheDirName));
+
+    struct Job
+    {
+        QString relativePath;
+        QString sourcePath;
+        QString cachePath;
+        std::unique_ptr<QProcess> qmlcachegen;
+    };
+    std::vector<Job> jobs;
+
+    QDirIterator it(extractionPath, { qSL("*.qml"), qSL("*.js"), qSL("*.mjs") },
+                    QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        Job job;
+        job.sourcePath = it.next();
+        job.relativePath = m_extractionDir.relativeFilePath(job.sourcePath);
+        if (job.relativePath.startsWith(cacheDirName + qL1C('/')))
+            continue;
+
+        // the engine will look up the cache file via the source's path after the final rename
+        const QString finalPath = m_applicationDir.absoluteFilePath(job.relativePath);
+        job.cachePath = cacheDir.absoluteFilePath(qmlDiskCacheFileName(finalPath));
+        jobs.push_back(std::move(job));
+    }
+    if (jobs.empty())
+        return;
+
+    if (!cacheDir.exists() && !QDir::root().mkpath(cacheDir.absolutePath())) {
+        qCWarning(LogInstaller) << "Cannot precompile the QML files of package" << m_packageId
+                                << "- could not create" << cacheDir.absolutePath();
+        return;
+    }
+
+    // qmlcachegen can only compile one file per invocation, but the files are independent of
+    // each other: keep as many compilers running in parallel as we have cores.
+    const size_t maxRunning = size_t(qMax(1, QThread::idealThreadCount()));
+    size_t started = 0;
+    int count = 0;
+
+    for (size_t finished = 0; finished < jobs.size(); ++finished) {
+        while ((started < jobs.size()) && (started - finished < maxRunning)) {
+            Job &job = jobs[started++];
+            job.qmlcachegen.reset(new QProcess);
+            job.qmlcachegen->setProcessChannelMode(QProcess::MergedChannels);
+            job.qmlcachegen->start(compiler, { qSL("--only-bytecode"), qSL("-o"), job.cachePath, job.sourcePath });
+        }
+
+        Job &job = jobs[finished];
+        QProcess *qmlcachegen = job.qmlcachegen.get();
+
+        if (!qmlcachegen->waitForFinished(60000) || (qmlcachegen->exitStatus() != QProcess::NormalExit)
+                || (qmlcachegen->exitCode() != 0)) {
+            qCWarning(LogInstaller).noquote() << "Could not precompile" << job.relativePath << "in package"
+                                              << m_packageId << ":" << qmlcachegen->readAll().trimmed();
+            qmlcachegen->kill();
+            qmlcachegen->waitForFinished(1000);
+            QFile::remove(job.cachePath);
+        } else {
+            ++count;
+        }
+        job.qmlcachegen.reset();
+    }
+    qCDebug(LogInstaller) << "Precompiled" << count << "QML/JS files of package" << m_packageId;
+}
+
 void InstallationTask::startInstallation() Q_DECL_NOEXCEPT_EXPR(false)
 {
     // 2. delete old, partial installation
@@ -369,6 +579,7 @@ void InstallationTask::finishInstallation() Q_DECL_NOEXCEPT_EXPR(false)
 {
     QDir documentDirectory(m_documentPath);
     ScopedDirectoryCreator documentDirCreator;
+    bool createdDocumentDir = false;
 
     enum { Installation, Update } mode = Installation;
 
@@ -381,6 +592,7 @@ void InstallationTask::finishInstallation() Q_DECL_NOEXCEPT_EXPR(false)
     QFile reportFile(m_extractionDir.absoluteFilePath(qSL(".installation-report.yaml")));
     if (!reportFile.open(QFile::WriteOnly) || !report.serialize(&reportFile))
         throw Exception(reportFile, "could not write the installation report");
+    setOwnerAndPermissions(reportFile.fileName(), reportFile.handle());
     reportFile.close();
 
     // create the document directories when installing (not needed on updates)
@@ -389,8 +601,15 @@ void InstallationTask::finishInstallation() Q_DECL_NOEXCEPT_EXPR(false)
         if (!documentDirectory.cd(m_packageId)) {
             if (!documentDirCreator.create(documentDirectory.absoluteFilePath(m_packageId)))
                 throw Exception(Error::IO, "could not create the document directory %1").arg(documentDirectory.filePath(m_packageId));
+            createdDocumentDir = true;
         }
     }
+    // Make the new content durable before it becomes visible under its final name. If possible,
+    // only our own files are flushed: a global sync() would also have to write back every other
+    // dirty page in the system, which can take seconds on a busy device. Most of the data has
+    // already been written back while extracting (see PackageExtractor), so this is usually quick.
+    bool synced = false;
+
 #ifdef Q_OS_UNIX
     // update the owner, group and permission bits on both the installation and document directories
     SudoClient *root = SudoClient::instance();
@@ -399,18 +618,48 @@ void InstallationTask::finishInstallation() Q_DECL_NOEXCEPT_EXPR(false)
         uid_t uid = m_applicationUid;
         gid_t gid = m_pm->commonApplicationGroupId();
 
+        // The document directory cannot be opened by us anymore after its owner has been
+        // changed. It is usually empty, so syncing it right before is cheap.
+        if (createdDocumentDir && !syncRecursive(documentDirectory.absoluteFilePath(m_packageId)))
+            throw Exception(Error::IO, "could not write the document directory %1 to disk").arg(documentDirectory.filePath(m_packageId));
+
         if (!root->setOwnerAndPermissionsRecursive(documentDirectory.filePath(m_packageId), uid, gid, 02700)) {
             throw Exception(Error::IO, "could not recursively change the owner to %1:%2 and the permission bits to %3 in %4")
                     .arg(uid).arg(gid).arg(02700, 0, 8).arg(documentDirectory.filePath(m_packageId));
         }
 
-        if (!root->setOwnerAndPermissionsRecursive(m_extractionDir.path(), uid, gid, 0440)) {
+        // the package's files have already been handled while extracting, but the precompiled
+        // QML files have been created afterwards
+        const QString qmlCachePath = m_extractionDir.absoluteFilePath(precompiledQmlCacheDirName());
+        if (QFileInfo::exists(qmlCachePath) && !root->setOwnerAndPermissionsRecursive(qmlCachePath, uid, gid, 0440)) {
             throw Exception(Error::IO, "could not recursively change the owner to %1:%2 and the permission bits to %3 in %4")
-                    .arg(uid).arg(gid).arg(0440, 0, 8).arg(m_extractionDir.absolutePath());
+                    .arg(uid).arg(gid).arg(0440, 0, 8).arg(qmlCachePath);
         }
+
+        // children need to be handled before their parents
+        for (auto it = m_deferredOwnerChanges.crbegin(); it != m_deferredOwnerChanges.crend(); ++it)
+            setOwnerAndPermissions(*it);
+        setOwnerAndPermissions(m_extractionDir.absolutePath());
+        waitForOwnerChanges();
+
+        // None of the package's files can be opened by us anymore, so they cannot be synced
+        // individually. A single syncfs() on the installation file-system is still far cheaper
+        // than an fsync() per file while extracting, and it also covers the owner changes.
+        if (!syncFileSystem(m_extractionDir.absolutePath()))
+            throw Exception(Error::IO, "could not write the installation directory %1 to disk").arg(m_extractionDir.absolutePath());
+        synced = true;
     }
 #endif
 
+    if (!synced && !syncRecursive(m_extractionDir.absolutePath()))
+        throw Exception(Error::IO, "could not write the installation directory %1 to disk").arg(m_extractionDir.absolutePath());
+    if (createdDocumentDir) {
+        if ((!synced && !syncRecursive(documentDirectory.absoluteFilePath(m_packageId)))
+                || !syncToDisk(documentDirectory.absolutePath(), RecursiveOperationType::LeaveDirectory)) {
+            throw Exception(Error::IO, "could not write the document directory %1 to disk").arg(documentDirectory.filePath(m_packageId));
+        }
+    }
+
     // final rename
 
     // POSIX cannot atomically rename directories, if the destination directory exists
@@ -440,10 +689,9 @@ void InstallationTask::finishInstallation() Q_DECL_NOEXCEPT_EXPR(false)
     if (mode == Update)
         removeRecursiveHelper(m_applicationDir.absolutePath() + qL1C('-'));
 
-#ifdef Q_OS_UNIX
-    // write files to the filesystem
-    sync();
-#endif
+    // persist the renames: they are recorded in the parent directory
+    if (!syncToDisk(QString(m_installationPath + qL1C('/')), RecursiveOperationType::LeaveDirectory))
+        qCWarning(LogInstaller) << "Could not write the installation directory" << m_installationPath << "to disk";
 
     m_errorString.clear();
 }
@@ -9,6 +9,8 @@
 #include <QStringList>
 #include <QWaitCondition>
 #include <QMutex>
+#include <QPair>
+#include <QVector>
 
 #include <QtAppManApplication/installationreport.h>
 #include <QtAppManManager/asynchronoustask.h>
@@ -45,6 +47,10 @@ private:
     void startInstallation() Q_DECL_NOEXCEPT_EXPR(false);
     void finishInstallation() Q_DECL_NOEXCEPT_EXPR(false);
     void checkExtractedFile(const QString &file) Q_DECL_NOEXCEPT_EXPR(false);
+    void entryWritten(const QString &entryPath, int fd) Q_DECL_NOEXCEPT_EXPR(false);
+    void setOwnerAndPermissions(const QString &path, int fd = -1) Q_DECL_NOEXCEPT_EXPR(false);
+    void waitForOwnerChanges() Q_DECL_NOEXCEPT_EXPR(false);
+    void precompileQml();
 
 private:
     PackageManager *m_pm;
@@ -58,6 +64,8 @@ private:
     bool m_managerApproval = false;
     std::unique_ptr<PackageInfo> m_package;
     uint m_applicationUid = uint(-1);
+    QStringList m_deferredOwnerChanges; // only changed in finishInstallation()
+    QVector<QPair<quint32, QString>> m_pendingOwnerChanges; // SudoClient request id and path
     std::unique_ptr<Package> m_tempPackageForAcknowledge;
 
     // changes to these 4 member variables are protected by m_mutex
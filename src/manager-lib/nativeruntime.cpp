@@ -24,6 +24,7 @@
 #include "qtyaml.h"
 #include "applicationinterface.h"
 #include "utilities.h"
+#include "qml-utilities.h"
 #include "notificationmanager.h"
 #include "dbus-utilities.h"
 #include "processtitle.h"
@@ -70,10 +71,17 @@ NativeRuntime::NativeRuntime(AbstractContainer *container, Application *app, Nat
     , m_isQuickLauncher(app == nullptr)
     , m_startedViaLauncher(manager->identifier() != qL1S("native"))
 {
-    QDir().mkdir(qSL("/tmp/dbus-qtam"));
-    QString dbusAddress = QUuid::createUuid().toString().mid(1,36);
-    m_applicationInterfaceServer = new QDBusServer(qSL("unix:path=/tmp/dbus-qtam/dbus-qtam-") + dbusAddress, this);
-    m_applicationInterfaceServer->setAnonymousAuthenticationAllowed(true);
+    // the server is already listening and the interface objects are created upfront, so that
+    // there is as little work as possible left to do, once the application connects
+    m_applicationInterfaceServer = manager->takeApplicationInterfaceServer();
+    m_applicationInterfaceServer->setParent(this);
+
+    m_applicationInterface = new NativeRuntimeApplicationInterface(this);
+    connect(m_applicationInterface, &NativeRuntimeApplicationInterface::applicationFinishedInitialization,
+            this, &NativeRuntime::onApplicationFinishedInitialization);
+
+    if (m_startedViaLauncher)
+        m_runtimeInterface = new NativeRuntimeInterface(this);
 
     connect(m_applicationInterfaceServer, &QDBusServer::newConnection,
             this, [this](const QDBusConnection &connection) {
@@ -222,6 +230,7 @@ bool NativeRuntime::start()
     switch (state()) {
     case Am::StartingUp:
     case Am::Running:
+    case Am::Suspended:
         return true;
     case Am::ShuttingDown:
         return false;
@@ -246,6 +255,8 @@ bool NativeRuntime::start()
     QVariantMap uiConfig;
     if (m_slowAnimations)
         uiConfig.insert(qSL("slowAnimations"), true);
+    if (isPrecompiledQmlCacheEnabled())
+        uiConfig.insert(qSL("precompiledQmlCache"), true);
 
     QVariantMap openGLConfig;
     if (m_app)
@@ -357,6 +368,10 @@ void NativeRuntime::stop(bool forceKill)
     if (!m_process)
         return;
 
+    // a frozen application would neither react to the quit request nor to SIGTERM
+    if ((m_state == Am::Suspended) && m_container)
+        m_container->setFrozen(false);
+
     setState(Am::ShuttingDown);
     emit aboutToStop();
 
@@ -378,6 +393,8 @@ void NativeRuntime::stop(bool forceKill)
 
 void NativeRuntime::onProcessStarted()
 {
+    m_peerDBusTimer.start();
+
     if (!m_startedViaLauncher
             && !(application()->info()->supportsApplicationInterface() || manager()->supportsQuickLaunch())) {
         setState(Am::Running);
@@ -387,7 +404,7 @@ void NativeRuntime::onProcessStarted()
 void NativeRuntime::onProcessError(Am::ProcessError error)
 {
     Q_UNUSED(error)
-    if (m_state != Am::Running && m_state != Am::ShuttingDown)
+    if (m_state != Am::Running && m_state != Am::Suspended && m_state != Am::ShuttingDown)
         shutdown(-1, Am::CrashExit);
 }
 
@@ -406,7 +423,6 @@ void NativeRuntime::onDBusPeerConnection(const QDBusConnection &connection)
     m_dbusConnectionName = connection.name();
     QDBusConnection conn = connection;
 
-    m_applicationInterface = new NativeRuntimeApplicationInterface(this);
     if (!conn.registerObject(qSL("/ApplicationInterface"), m_applicationInterface, QDBusConnection::ExportScriptableContents))
         qCWarning(LogSystem) << "ERROR: could not register the /ApplicationInterface object on the peer DBus:" << conn.lastError().name() << conn.lastError().message();
 
@@ -414,13 +430,10 @@ void NativeRuntime::onDBusPeerConnection(const QDBusConnection &connection)
     QDBusConnection::sessionBus().registerObject(qSL("/Application%1/ApplicationInterface").arg(applicationProcessId()),
                                                  m_applicationInterface, QDBusConnection::ExportScriptableContents);
 #endif
-    // we need to delay the actual start call, until the launcher side is ready to
-    // listen to the interface
-    connect(m_applicationInterface, &NativeRuntimeApplicationInterface::applicationFinishedInitialization,
-            this, &NativeRuntime::onApplicationFinishedInitialization);
+    // the actual start call is delayed until the launcher side is ready to listen to the
+    // interface (see onApplicationFinishedInitialization)
 
-    if (m_startedViaLauncher) {
-        m_runtimeInterface = new NativeRuntimeInterface(this);
+    if (m_runtimeInterface) {
         if (!conn.registerObject(qSL("/RuntimeInterface"), m_runtimeInterface, QDBusConnection::ExportScriptableContents))
             qCWarning(LogSystem) << "ERROR: could not register the /RuntimeInterface object on the peer DBus.";
 
@@ -439,6 +452,13 @@ void NativeRuntime::onApplicationFinishedInitialization()
     m_connectedToApplicationInterface = true;
 
     if (m_app) {
+        if (m_peerDBusTimer.isValid()) {
+            qCDebug(LogSystem) << "NativeRuntime (id:" << m_app->id() << "pid:" << applicationProcessId()
+                               << ") ready on the peer D-Bus" << m_peerDBusTimer.elapsed()
+                               << "msec after the process was started";
+            m_peerDBusTimer.invalidate();
+        }
+
         // now we know which app was launched, so initialize any additional interfaces on the p2p bus
         emit applicationReadyOnPeerDBus(QDBusConnection(m_dbusConnectionName), m_app);
 
@@ -555,7 +575,12 @@ NativeRuntimeManager::NativeRuntimeManager(QObject *parent)
 
 NativeRuntimeManager::NativeRuntimeManager(const QString &id, QObject *parent)
     : AbstractRuntimeManager(id, parent)
-{ }
+{
+    // the configuration is not available yet: pre-fill the pool once the event loop is running
+    m_refillPending = true;
+    QMetaObject::invokeMethod(this, &NativeRuntimeManager::refillApplicationInterfaceServerPool,
+                              Qt::QueuedConnection);
+}
 
 QString NativeRuntimeManager::defaultIdentifier()
 {
@@ -578,6 +603,59 @@ AbstractRuntime *NativeRuntimeManager::create(AbstractContainer *container, Appl
     return nrt.release();
 }
 
+QDBusServer *NativeRuntimeManager::takeApplicationInterfaceServer()
+{
+    QDBusServer *server = m_serverPool.isEmpty() ? createApplicationInterfaceServer()
+                                                 : m_serverPool.takeFirst();
+
+    // nobody is allowed to connect to a pooled server: see createApplicationInterfaceServer()
+    server->disconnect(this);
+
+    if (!m_refillPending) {
+        // refill later, so that creating the replacement does not delay the current start
+        m_refillPending = true;
+        QMetaObject::invokeMethod(this, &NativeRuntimeManager::refillApplicationInterfaceServerPool,
+                                  Qt::QueuedConnection);
+    }
+    return server;
+}
+
+QDBusServer *NativeRuntimeManager::createApplicationInterfaceServer()
+{
+    QDir().mkdir(qSL("/tmp/dbus-qtam"));
+    QString dbusAddress = QUuid::createUuid().toString().mid(1,36);
+    auto *server = new QDBusServer(qSL("unix:path=/tmp/dbus-qtam/dbus-qtam-") + dbusAddress, this);
+    server->setAnonymousAuthenticationAllowed(true);
+
+    // as long as the server is in the pool, there is no application process that could be
+    // validated via its pid, so any connection attempt is rejected
+    connect(server, &QDBusServer::newConnection, this, [](const QDBusConnection &connection) {
+        QDBusConnection::disconnectFromPeer(connection.name());
+        qCWarning(LogSystem) << "Rejected a connection attempt on an unused peer D-Bus.";
+    });
+    return server;
+}
+
+void NativeRuntimeManager::refillApplicationInterfaceServerPool()
+{
+    m_refillPending = false;
+
+    // the pool is disabled, unless it is explicitly configured
+    int poolSize = qMax(0, configuration().value(qSL("peerDBusServerPoolSize")).toInt());
+
+    while (m_serverPool.size() > poolSize)
+        delete m_serverPool.takeLast();
+    while (m_serverPool.size() < poolSize) {
+        QDBusServer *server = createApplicationInterfaceServer();
+        if (!server->isConnected()) {
+            qCWarning(LogSystem) << "Could not create a peer D-Bus server:" << server->lastError().message();
+            delete server;
+            break;
+        }
+        m_serverPool.append(server);
+    }
+}
+
 QT_END_NAMESPACE_AM
 
 #include "moc_nativeruntime.cpp"
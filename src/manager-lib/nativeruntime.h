@@ -9,6 +9,7 @@
 
 #include <QtPlugin>
 #include <QVector>
+#include <QElapsedTimer>
 
 #include <QtAppManManager/abstractruntime.h>
 #include <QtAppManManager/abstractcontainer.h>
@@ -34,6 +35,15 @@ public:
     bool supportsQuickLaunch() const override;
 
     AbstractRuntime *create(AbstractContainer *container, Application *app) override;
+
+    QDBusServer *takeApplicationInterfaceServer();
+
+private:
+    QDBusServer *createApplicationInterfaceServer();
+    void refillApplicationInterfaceServerPool();
+
+    QList<QDBusServer *> m_serverPool;
+    bool m_refillPending = false;
 };
 
 class NativeRuntime : public AbstractRuntime
@@ -96,6 +106,7 @@ private:
     NativeRuntimeInterface *m_runtimeInterface = nullptr;
     AbstractContainerProcess *m_process = nullptr;
     QDBusServer *m_applicationInterfaceServer;
+    QElapsedTimer m_peerDBusTimer;
     bool m_slowAnimations = false;
     QVariantMap m_openGLConfiguration;
 
@@ -679,6 +679,36 @@ void PackageManager::setAllowInstallationOfUnsignedPackages(bool enable)
     d->allowInstallationOfUnsignedPackages = enable;
 }
 
+bool PackageManager::precompileQml() const
+{
+    return d->precompileQml;
+}
+
+void PackageManager::setPrecompileQml(bool enable)
+{
+    d->precompileQml = enable;
+}
+
+AsynchronousTask::IoPriority PackageManager::ioPriority() const
+{
+    return d->ioPriority;
+}
+
+void PackageManager::setIoPriority(AsynchronousTask::IoPriority ioPriority)
+{
+    d->ioPriority = ioPriority;
+}
+
+quint64 PackageManager::ioBandwidthLimit() const
+{
+    return d->ioBandwidthLimit;
+}
+
+void PackageManager::setIoBandwidthLimit(quint64 bytesPerSecond)
+{
+    d->ioBandwidthLimit = bytesPerSecond;
+}
+
 QString PackageManager::hardwareId() const
 {
     return d->hardwareId;
@@ -736,12 +766,21 @@ uint PackageManager::findUnusedUserId() const Q_DECL_NOEXCEPT_EXPR(false)
 
 QList<QByteArray> PackageManager::caCertificates() const
 {
-    return d->chainOfTrust;
+    return d->trustStore.certificates();
+}
+
+TrustStore PackageManager::caTrustStore() const
+{
+    return d->trustStore;
 }
 
 void PackageManager::setCACertificates(const QList<QByteArray> &chainOfTrust)
 {
-    d->chainOfTrust = chainOfTrust;
+    // parse the certificates only once, instead of for every signature that needs to be verified
+    // (this needs the cryptography backend, so it is skipped if there is nothing to parse)
+    d->trustStore = chainOfTrust.isEmpty() ? TrustStore() : TrustStore(chainOfTrust);
+    if (!d->trustStore.isValid())
+        qCWarning(LogInstaller) << "Could not load the CA certificates:" << d->trustStore.errorString();
 }
 
 static QVariantMap locationMap(const QString &path)
@@ -1312,6 +1351,7 @@ void PackageManager::executeNextTask()
 
 
     d->activeTask = task;
+    task->setIoPriority(d->ioPriority);
     task->setState(AsynchronousTask::Executing);
     task->start();
 }
@@ -24,6 +24,7 @@ QT_BEGIN_NAMESPACE_AM
 class PackageDatabase;
 class Package;
 class PackageManagerPrivate;
+class TrustStore;
 
 // A place to collect signals used internally by appman without polluting
 // PackageManager's public QML API.
@@ -104,6 +105,12 @@ public:
     void setDevelopmentMode(bool enable);
     bool allowInstallationOfUnsignedPackages() const;
     void setAllowInstallationOfUnsignedPackages(bool enable);
+    bool precompileQml() const;
+    void setPrecompileQml(bool enable);
+    AsynchronousTask::IoPriority ioPriority() const;
+    void setIoPriority(AsynchronousTask::IoPriority ioPriority);
+    quint64 ioBandwidthLimit() const;
+    void setIoBandwidthLimit(quint64 bytesPerSecond);
     QString hardwareId() const;
     void setHardwareId(const QString &hwId);
 //    bool securityChecksEnabled() const;
@@ -192,6 +199,7 @@ private:
     void unregisterApplicationsAndIntentsOfPackage(Package *package);
     static void registerQmlTypes();
     QList<QByteArray> caCertificates() const;
+    TrustStore caTrustStore() const;
     uint findUnusedUserId() const Q_DECL_NOEXCEPT_EXPR(false);
 
 private:
@@ -13,6 +13,7 @@
 #include <QtAppManManager/packagemanager.h>
 #include <QtAppManApplication/packagedatabase.h>
 #include <QtAppManManager/asynchronoustask.h>
+#include <QtAppManCrypto/signature.h>
 #include <QtAppManCommon/global.h>
 
 QT_BEGIN_NAMESPACE_AM
@@ -34,6 +35,9 @@ public:
 
     bool developmentMode = false;
     bool allowInstallationOfUnsignedPackages = false;
+    bool precompileQml = false;
+    AsynchronousTask::IoPriority ioPriority = AsynchronousTask::LowIoPriority;
+    quint64 ioBandwidthLimit = 0; // bytes/sec, 0: unlimited
     bool userIdSeparation = false;
     uint minUserId = uint(-1);
     uint maxUserId = uint(-1);
@@ -45,7 +49,7 @@ public:
     QString error;
 
     QString hardwareId;
-    QList<QByteArray> chainOfTrust;
+    TrustStore trustStore; // pre-parsed chain of trust, shared by all installation tasks
     bool cleanupBrokenInstallationsDone = false;
 
     QList<AsynchronousTask *> incomingTaskList;     // incoming queue
@@ -3,8 +3,13 @@
 // Copyright (C) 2018 Pelagicore AG
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
+#include <QDir>
+#include <QFileInfo>
 #include <QProcess>
 #include <QProcessEnvironment>
+#include <QSocketNotifier>
+#include <QStandardPaths>
+#include <QTimer>
 
 #include "global.h"
 #include "logging.h"
@@ -14,12 +19,25 @@
 #include "processcontainer.h"
 #include "systemreader.h"
 #include "debugwrapper.h"
+#if defined(Q_OS_LINUX)
+#  include "sysfsreader.h"
+#endif
 
 #if defined(Q_OS_UNIX)
 #  include <csignal>
 #  include <unistd.h>
 #  include <fcntl.h>
 #endif
+#if defined(Q_OS_LINUX)
+#  include <cerrno>
+#  include <cstring>
+#  include <spawn.h>
+#  include <sys/syscall.h>
+#  include <sys/wait.h>
+#  if defined(__GLIBC__) && __GLIBC_PREREQ(2, 29)
+#    define AM_HAVE_SPAWN_CHDIR 1
+#  endif
+#endif
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -136,6 +154,263 @@ void HostProcess::setStopBeforeExec(bool stopBeforeExec)
 }
 
 
+#if defined(Q_OS_LINUX)
+
+SpawnedHostProcess::SpawnedHostProcess()
+{ }
+
+SpawnedHostProcess::~SpawnedHostProcess()
+{
+    closeAndClearFileDescriptors(m_stdioRedirections);
+
+    // same as QProcess: never leave a child behind (or a zombie for that matter)
+    // (m_pid is 0 if posix_spawn() failed: kill(0) would hit our whole process group)
+    if ((m_state != Am::NotRunning) && (m_pid > 0)) {
+        ::kill(pid_t(m_pid), SIGKILL);
+        ::waitpid(pid_t(m_pid), nullptr, 0);
+    }
+    if (m_pidFd >= 0)
+        QT_CLOSE(m_pidFd);
+}
+
+bool SpawnedHostProcess::isSupported()
+{
+#if defined(AM_HAVE_SPAWN_CHDIR)
+    return true;
+#else
+    return false; // we cannot set the working directory without forking
+#endif
+}
+
+void SpawnedHostProcess::start(const QString &program, const QStringList &arguments)
+{
+    if (m_state != Am::NotRunning) {
+        qCWarning(LogSystem) << "Process" << program << "is already started and cannot be started again";
+        return;
+    }
+    setState(Am::StartingUp);
+
+    // QProcess searches the PATH for programs without a directory component (e.g. debug wrappers)
+    QString executable = program;
+    if (!executable.contains(u'/')) {
+        const QString found = QStandardPaths::findExecutable(executable);
+        if (!found.isEmpty())
+            executable = found;
+    }
+
+    const QByteArray executablePath = executable.toLocal8Bit();
+    const QByteArray workingDirectory = m_workingDirectory.toLocal8Bit();
+
+    // build argv and envp upfront: there is no room for allocations in the child
+    QByteArrayList argList { executablePath };
+    for (const QString &arg : arguments)
+        argList << arg.toLocal8Bit();
+    QByteArrayList envList;
+    for (const QString &env : qAsConst(m_environment))
+        envList << env.toLocal8Bit();
+
+    QVector<char *> argv;
+    argv.reserve(argList.size() + 1);
+    for (const QByteArray &arg : qAsConst(argList))
+        argv << const_cast<char *>(arg.constData());
+    argv << nullptr;
+
+    QVector<char *> envp;
+    envp.reserve(envList.size() + 1);
+    for (const QByteArray &env : qAsConst(envList))
+        envp << const_cast<char *>(env.constData());
+    envp << nullptr;
+
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+
+    // duplicate any requested redirections to the respective stdin/out/err fd, then close the
+    // originals in the child. Otherwise we would block the tty where the fds originated from.
+    QVector<int> closeInChild;
+    for (int i = 0; i < 3; ++i) {
+        int fd = m_stdioRedirections.value(i, -1);
+        if (fd >= 0) {
+            posix_spawn_file_actions_adddup2(&fileActions, fd, i);
+            if (fd > 2 && !closeInChild.contains(fd))
+                closeInChild << fd;
+        }
+    }
+    for (int fd : qAsConst(closeInChild))
+        posix_spawn_file_actions_addclose(&fileActions, fd);
+
+#if defined(AM_HAVE_SPAWN_CHDIR)
+    if (!workingDirectory.isEmpty())
+        posix_spawn_file_actions_addchdir_np(&fileActions, workingDirectory.constData());
+#else
+    Q_UNUSED(workingDirectory)
+#endif
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+
+    // the System UI may have blocked or re-routed signals: the child should start out clean
+    sigset_t sigMask;
+    sigemptyset(&sigMask);
+    posix_spawnattr_setsigmask(&attr, &sigMask);
+    sigset_t sigDefault;
+    sigfillset(&sigDefault);
+    posix_spawnattr_setsigdefault(&attr, &sigDefault);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    pid_t pid = 0;
+    int result = posix_spawn(&pid, executablePath.constData(), &fileActions, &attr,
+                             argv.data(), envp.data());
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&fileActions);
+
+    // the child process has received a copy of all redirected fds (or it failed to start): now
+    // it's time to close our fds, since we don't need them anymore (plus we would block the tty
+    // where they originated from)
+    closeAndClearFileDescriptors(m_stdioRedirections);
+
+    if (result != 0) {
+        qCWarning(LogSystem) << "Failed to spawn" << executable << ":" << ::strerror(result);
+        // QProcess reports start errors asynchronously, so we do the same
+        QMetaObject::invokeMethod(this, [this]() {
+            setState(Am::NotRunning);
+            emit errorOccured(Am::FailedToStart);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    m_pid = pid;
+
+#if defined(SYS_pidfd_open)
+    m_pidFd = int(::syscall(SYS_pidfd_open, pid, 0));
+    if (m_pidFd >= 0) {
+        ::fcntl(m_pidFd, F_SETFD, FD_CLOEXEC);
+        m_pidFdNotifier = new QSocketNotifier(m_pidFd, QSocketNotifier::Read, this);
+        connect(m_pidFdNotifier, &QSocketNotifier::activated, this, &SpawnedHostProcess::reap);
+    }
+#endif
+    if (m_pidFd < 0) {
+        // kernels older than 5.3 have no pidfds: fall back to polling, since we cannot install
+        // a SIGCHLD handler without interfering with QProcess
+        m_reapTimer = new QTimer(this);
+        m_reapTimer->setInterval(100);
+        connect(m_reapTimer, &QTimer::timeout, this, &SpawnedHostProcess::reap);
+        m_reapTimer->start();
+    }
+
+    QMetaObject::invokeMethod(this, [this]() {
+        if (m_state == Am::StartingUp) {
+            setState(Am::Running);
+            emit started();
+        }
+    }, Qt::QueuedConnection);
+}
+
+void SpawnedHostProcess::reap()
+{
+    int status = 0;
+    pid_t result = ::waitpid(pid_t(m_pid), &status, WNOHANG);
+    if (result == 0)
+        return;
+    if ((result < 0) && (errno == EINTR))
+        return;
+
+    if (m_pidFdNotifier)
+        m_pidFdNotifier->setEnabled(false);
+    if (m_reapTimer)
+        m_reapTimer->stop();
+
+    int exitCode = 0;
+    Am::ExitStatus exitStatus = Am::NormalExit;
+
+    if (result < 0) {
+        // somebody else reaped our child: there is nothing we can report besides the fact
+        exitCode = -1;
+        exitStatus = Am::CrashExit;
+    } else if (WIFSIGNALED(status)) {
+        exitCode = WTERMSIG(status);
+        exitStatus = Am::CrashExit;
+    } else {
+        exitCode = WEXITSTATUS(status);
+    }
+
+    // the order of signals matches QProcess
+    if (exitStatus == Am::CrashExit)
+        emit errorOccured(Am::Crashed);
+    setState(Am::NotRunning);
+    emit finished(exitCode, exitStatus);
+}
+
+void SpawnedHostProcess::setState(Am::RunState newState)
+{
+    if (m_state != newState) {
+        m_state = newState;
+        emit stateChanged(newState);
+    }
+}
+
+void SpawnedHostProcess::setWorkingDirectory(const QString &dir)
+{
+    m_workingDirectory = dir;
+}
+
+void SpawnedHostProcess::setProcessEnvironment(const QProcessEnvironment &environment)
+{
+    m_environment = environment.toStringList();
+}
+
+void SpawnedHostProcess::kill()
+{
+    if ((m_state != Am::NotRunning) && m_pid)
+        ::kill(pid_t(m_pid), SIGKILL);
+}
+
+void SpawnedHostProcess::terminate()
+{
+    if ((m_state != Am::NotRunning) && m_pid)
+        ::kill(pid_t(m_pid), SIGTERM);
+}
+
+qint64 SpawnedHostProcess::processId() const
+{
+    return m_pid;
+}
+
+Am::RunState SpawnedHostProcess::state() const
+{
+    return m_state;
+}
+
+void SpawnedHostProcess::setStdioRedirections(QVector<int> &&stdioRedirections)
+{
+    // we own the file descriptors now
+    closeAndClearFileDescriptors(m_stdioRedirections);
+    m_stdioRedirections = stdioRedirections;
+
+    // make sure that the redirection fds do not have a close-on-exec flag: posix_spawn's dup2
+    // actions do clear it on the target fd, but not if source and target are the same fd.
+    for (int fd : qAsConst(m_stdioRedirections)) {
+        if (fd < 0)
+            continue;
+        int flags = fcntl(fd, F_GETFD);
+        if (flags & FD_CLOEXEC)
+            fcntl(fd, F_SETFD, flags & ~FD_CLOEXEC);
+    }
+}
+
+static bool writeCGroupFile(const QString &fileName, const QByteArray &value)
+{
+    QFile f(fileName);
+    if (!f.open(QFile::WriteOnly | QFile::Unbuffered) || (f.write(value) != value.size())) {
+        qCWarning(LogSystem) << "Could not write" << value.trimmed() << "to" << fileName << ":" << f.errorString();
+        return false;
+    }
+    return true;
+}
+
+#endif // Q_OS_LINUX
+
+
 ProcessContainer::ProcessContainer(ProcessContainerManager *manager, Application *app,
                                    QVector<int> &&stdioRedirections,
                                    const QMap<QString, QString> &debugWrapperEnvironment,
@@ -149,6 +424,10 @@ ProcessContainer::ProcessContainer(ProcessContainerManager *manager, Application
 ProcessContainer::~ProcessContainer()
 {
     closeAndClearFileDescriptors(m_stdioRedirections);
+#if defined(Q_OS_LINUX)
+    if (!m_controlGroupPath.isEmpty())
+        QDir().rmdir(m_controlGroupPath); // fails, if the process is still alive
+#endif
 }
 
 QString ProcessContainer::controlGroup() const
@@ -165,7 +444,25 @@ bool ProcessContainer::setControlGroup(const QString &groupName)
     auto git = map.constFind(groupName);
     if (git != map.constEnd()) {
         QVariantMap mapping = (*git).toMap();
-        QByteArray pidString = QByteArray::number(m_process->processId());
+
+        // writing a pid of 0 to cgroup.procs would move the application manager itself
+        const qint64 pid = m_process ? m_process->processId() : 0;
+        if (pid <= 0) {
+            qCWarning(LogSystem) << "Cannot set the control group of" << m_program
+                                 << "before its process has been started";
+            return false;
+        }
+
+#if defined(Q_OS_LINUX)
+        if (isCGroupV2()) {
+            if (!setControlGroupV2(groupName, mapping))
+                return false;
+            m_currentControlGroup = groupName;
+            emit controlGroupChanged(groupName);
+            return true;
+        }
+#endif
+        QByteArray pidString = QByteArray::number(pid);
         pidString.append('\n');
 
         for (auto it = mapping.cbegin(); it != mapping.cend(); ++it) {
@@ -174,6 +471,12 @@ bool ProcessContainer::setControlGroup(const QString &groupName)
 
             //qWarning() << "Setting cgroup for" << m_program << ", pid" << m_process->processId() << ":" << resource << "->" << userclass;
 
+            if (resource.contains(qL1C('.'))) {
+                qCWarning(LogSystem) << "Ignoring cgroup v2 setting" << resource << "in control group"
+                                     << groupName << ", since this system is using cgroup v1";
+                continue;
+            }
+
             QString file = QString(qSL("/sys/fs/cgroup/%1/%2/cgroup.procs")).arg(resource, userclass);
             QFile f(file);
             bool ok = f.open(QFile::WriteOnly);
@@ -184,16 +487,8 @@ bool ProcessContainer::setControlGroup(const QString &groupName)
                 return false;
             }
 
-            if (resource == qSL("memory")) {
-                if (!m_memWatcher) {
-                    m_memWatcher = new MemoryWatcher(this);
-                    connect(m_memWatcher, &MemoryWatcher::memoryLow,
-                            this, &ProcessContainer::memoryLowWarning);
-                    connect(m_memWatcher, &MemoryWatcher::memoryCritical,
-                            this, &ProcessContainer::memoryCriticalWarning);
-                }
-                m_memWatcher->startWatching(userclass);
-            }
+            if (resource == qSL("memory"))
+                startMemoryWatcher(userclass);
         }
         m_currentControlGroup = groupName;
         emit controlGroupChanged(groupName);
@@ -202,6 +497,104 @@ bool ProcessContainer::setControlGroup(const QString &groupName)
     return false;
 }
 
+bool ProcessContainer::setFrozen(bool frozen)
+{
+#if defined(Q_OS_LINUX)
+    // The cgroup v2 freezer also catches all child processes of the application. The leaf cgroup
+    // only exists once the process has been started and moved there: until then, the fallback
+    // refuses to freeze, since there is no pid yet.
+    if (!m_controlGroupPath.isEmpty())
+        return writeCGroupFile(m_controlGroupPath + qSL("/cgroup.freeze"), frozen ? "1\n" : "0\n");
+#endif
+    return AbstractContainer::setFrozen(frozen);
+}
+
+void ProcessContainer::startMemoryWatcher(const QString &groupPath)
+{
+    if (!m_memWatcher) {
+        m_memWatcher = new MemoryWatcher(this);
+        connect(m_memWatcher, &MemoryWatcher::memoryLow,
+                this, &ProcessContainer::memoryLowWarning);
+        connect(m_memWatcher, &MemoryWatcher::memoryCritical,
+                this, &ProcessContainer::memoryCriticalWarning);
+    }
+    m_memWatcher->startWatching(groupPath);
+}
+
+#if defined(Q_OS_LINUX)
+
+bool ProcessContainer::setControlGroupV2(const QString &groupName, const QVariantMap &settings)
+{
+    // With cgroup v2 there is only one (unified) hierarchy, so every control group name maps to
+    // exactly one cgroup below <controlGroupRoot>. The settings are the interface files of the
+    // controllers within that cgroup, e.g. "cpu.weight: 20" or "memory.high: 256M".
+    // The process itself is put into its own leaf cgroup below that, so that it can be frozen
+    // without affecting other applications in the same control group.
+
+    static const QStringList supportedSettings = {
+        qSL("cpu.weight"), qSL("cpu.max"), qSL("memory.low"), qSL("memory.high"),
+        qSL("memory.max"), qSL("memory.swap.max"), qSL("pids.max"), qSL("io.weight")
+    };
+
+    QString root = m_manager->configuration().value(qSL("controlGroupRoot"), qSL("qtam")).toString();
+    const QString rootPath = cGroupBaseDir() + root;
+    const QString relativePath = root + qL1C('/') + groupName;
+    const QString path = cGroupBaseDir() + relativePath;
+
+    if (!QFileInfo(path).isDir()) {
+        if (!QDir().mkpath(path)) {
+            qCWarning(LogSystem) << "Could not create the cgroup" << path
+                                 << "(make sure that the application manager has write access to" << rootPath << ")";
+            return false;
+        }
+    }
+
+    // Enable the controllers we need for the groups below our root. Any of these might already
+    // be enabled or not be available in this kernel, so we just write them one by one.
+    const QList<QByteArray> available = SysFsReader(QString(rootPath + qSL("/cgroup.controllers")).toLocal8Bit(), 256)
+            .readValue().simplified().split(' ');
+    const QList<QByteArray> enabled = SysFsReader(QString(rootPath + qSL("/cgroup.subtree_control")).toLocal8Bit(), 256)
+            .readValue().simplified().split(' ');
+    for (const char *controller : { "cpu", "memory", "pids", "io" }) {
+        if (!available.contains(controller) || enabled.contains(controller))
+            continue;
+        writeCGroupFile(rootPath + qSL("/cgroup.subtree_control"), QByteArray("+") + controller);
+    }
+
+    for (auto it = settings.cbegin(); it != settings.cend(); ++it) {
+        const QString &setting = it.key();
+
+        if (!supportedSettings.contains(setting)) {
+            if (!setting.contains(qL1C('.'))) {
+                qCWarning(LogSystem) << "Ignoring cgroup v1 mapping" << setting << "->" << it.value().toString()
+                                     << "in control group" << groupName << ", since this system is using cgroup v2";
+            } else {
+                qCWarning(LogSystem) << "Ignoring unsupported cgroup v2 setting" << setting
+                                     << "in control group" << groupName;
+            }
+            continue;
+        }
+        writeCGroupFile(path + qL1C('/') + setting, it.value().toString().toLatin1());
+    }
+
+    Q_ASSERT(m_process && (m_process->processId() > 0));
+    const QString leafPath = path + qSL("/pid-") + QString::number(m_process->processId());
+    QByteArray pidString = QByteArray::number(m_process->processId());
+    pidString.append('\n');
+    if (!QDir().mkpath(leafPath) || !writeCGroupFile(leafPath + qSL("/cgroup.procs"), pidString)) {
+        qWarning() << "Failed setting cgroup for" << m_program << ", pid" << m_process->processId() << ":" << leafPath;
+        return false;
+    }
+    if (!m_controlGroupPath.isEmpty())
+        QDir().rmdir(m_controlGroupPath);
+    m_controlGroupPath = leafPath;
+
+    startMemoryWatcher(relativePath);
+    return true;
+}
+
+#endif // Q_OS_LINUX
+
 bool ProcessContainer::isReady()
 {
     return true;
@@ -237,12 +630,6 @@ AbstractContainerProcess *ProcessContainer::start(const QStringList &arguments,
             penv.insert(it.key(), it.value());
     }
 
-    HostProcess *process = new HostProcess();
-    process->setWorkingDirectory(m_baseDirectory);
-    process->setProcessEnvironment(penv);
-    process->setStopBeforeExec(configuration().value(qSL("stopBeforeExec")).toBool());
-    process->setStdioRedirections(std::move(m_stdioRedirections));
-
     QString command = m_program;
     QStringList args = arguments;
 
@@ -252,13 +639,62 @@ AbstractContainerProcess *ProcessContainer::start(const QStringList &arguments,
         command = cmd.takeFirst();
         args = cmd;
     }
-    qCDebug(LogSystem) << "Running command:" << command << "arguments:" << args;
 
-    process->start(command, args);
-    m_process = process;
+    const bool stopBeforeExec = configuration().value(qSL("stopBeforeExec")).toBool();
+    const QString startMethod = configuration().value(qSL("startMethod"), qSL("fork")).toString();
+
+    if (startMethod == qSL("spawn")) {
+#if defined(Q_OS_LINUX)
+        if (stopBeforeExec) {
+            // raising SIGSTOP in a vfork()ed child would also block the System UI
+            qCDebug(LogSystem) << "The 'spawn' start method does not support stopBeforeExec - "
+                                  "falling back to 'fork'";
+        } else if (!SpawnedHostProcess::isSupported()) {
+            qCWarning(LogSystem) << "The 'spawn' start method is not supported on this platform - "
+                                    "falling back to 'fork'";
+        } else {
+            SpawnedHostProcess *process = new SpawnedHostProcess();
+            process->setWorkingDirectory(m_baseDirectory);
+            process->setProcessEnvironment(penv);
+            process->setStdioRedirections(std::move(m_stdioRedirections));
+
+            qCDebug(LogSystem) << "Spawning command:" << command << "arguments:" << args;
+
+            process->start(command, args);
+            m_process = process;
+        }
+#else
+        qCWarning(LogSystem) << "The 'spawn' start method is only supported on Linux - "
+                                "falling back to 'fork'";
+#endif
+    } else if (startMethod != qSL("fork")) {
+        qCWarning(LogSystem) << "Unknown start method" << startMethod << "- falling back to 'fork'";
+    }
+
+    if (!m_process) {
+        HostProcess *process = new HostProcess();
+        process->setWorkingDirectory(m_baseDirectory);
+        process->setProcessEnvironment(penv);
+        process->setStopBeforeExec(stopBeforeExec);
+        process->setStdioRedirections(std::move(m_stdioRedirections));
 
-    setControlGroup(configuration().value(qSL("defaultControlGroup")).toString());
-    return process;
+        qCDebug(LogSystem) << "Running command:" << command << "arguments:" << args;
+
+        process->start(command, args);
+        m_process = process;
+    }
+
+    // The pid of a spawned process is known right away, but a forked one only reports its pid
+    // once it has been started. The leaf cgroup on v2 is named after the pid, so we have to wait.
+    const QString defaultControlGroup = configuration().value(qSL("defaultControlGroup")).toString();
+    if (m_process->processId() > 0) {
+        setControlGroup(defaultControlGroup);
+    } else {
+        connect(m_process, &AbstractContainerProcess::started, this, [this, defaultControlGroup]() {
+            setControlGroup(defaultControlGroup);
+        });
+    }
+    return m_process;
 }
 
 ProcessContainerManager::ProcessContainerManager(QObject *parent)
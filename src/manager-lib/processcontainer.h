@@ -10,6 +10,8 @@
 
 QT_FORWARD_DECLARE_CLASS(QProcess)
 QT_FORWARD_DECLARE_CLASS(QProcessEnvironment)
+QT_FORWARD_DECLARE_CLASS(QSocketNotifier)
+QT_FORWARD_DECLARE_CLASS(QTimer)
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -60,6 +62,50 @@ private:
     QVector<int> m_stdioRedirections;
 };
 
+#if defined(Q_OS_LINUX)
+
+// An alternative to HostProcess that does not fork() the (potentially huge) System UI process:
+// posix_spawn() is implemented via clone(CLONE_VM|CLONE_VFORK) in glibc, so the cost of starting
+// a child does not depend on the RSS of the parent.
+class SpawnedHostProcess : public AbstractContainerProcess
+{
+    Q_OBJECT
+
+public:
+    SpawnedHostProcess();
+    virtual ~SpawnedHostProcess() override;
+
+    static bool isSupported();
+
+    virtual qint64 processId() const override;
+    virtual Am::RunState state() const override;
+
+    void setStdioRedirections(QVector<int> &&stdioRedirections);
+    void setWorkingDirectory(const QString &dir);
+    void setProcessEnvironment(const QProcessEnvironment &environment);
+
+public slots:
+    void kill() override;
+    void terminate() override;
+
+    void start(const QString &program, const QStringList &arguments);
+
+private:
+    void setState(Am::RunState newState);
+    void reap();
+
+    qint64 m_pid = 0;
+    int m_pidFd = -1;
+    Am::RunState m_state = Am::NotRunning;
+    QString m_workingDirectory;
+    QStringList m_environment;
+    QVector<int> m_stdioRedirections;
+    QSocketNotifier *m_pidFdNotifier = nullptr;
+    QTimer *m_reapTimer = nullptr;
+};
+
+#endif // Q_OS_LINUX
+
 class ProcessContainer : public AbstractContainer
 {
     Q_OBJECT
@@ -74,6 +120,8 @@ public:
     QString controlGroup() const override;
     bool setControlGroup(const QString &groupName) override;
 
+    bool setFrozen(bool frozen) override;
+
     bool isReady() override;
 
     AbstractContainerProcess *start(const QStringList &arguments,
@@ -81,7 +129,15 @@ public:
                                     const QVariantMap &amConfig) override;
 
 private:
+    void startMemoryWatcher(const QString &groupPath);
+#if defined(Q_OS_LINUX)
+    bool setControlGroupV2(const QString &groupName, const QVariantMap &settings);
+#endif
+
     QString m_currentControlGroup;
+#if defined(Q_OS_LINUX)
+    QString m_controlGroupPath; // the leaf cgroup of the process on cgroup v2
+#endif
     QVector<int> m_stdioRedirections;
     QMap<QString, QString> m_debugWrapperEnvironment;
     QStringList m_debugWrapperCommand;
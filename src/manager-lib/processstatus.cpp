@@ -87,6 +87,32 @@
         \li The amount of memory used by the heap, in bytes. The heap is private, dynamically
             allocated memory, for example through \c malloc or \c mmap on Linux.
     \endtable
+
+    \target control-group-keys
+    If controlGroupAccounting is enabled, the \c memoryControlGroup property provides the memory
+    usage of the application's control group with these keys:
+
+    \table
+    \header
+        \li Key
+        \li Description
+    \row
+        \li \c total
+        \li The total amount of memory charged to the control group, in bytes.
+    \row
+        \li \c anon
+        \li The amount of anonymous memory (e.g. heaps and stacks), in bytes.
+    \row
+        \li \c file
+        \li The amount of memory used by the page cache (including mapped libraries), in bytes.
+    \row
+        \li \c kernel
+        \li The amount of memory used by the kernel on behalf of the group (e.g. kernel stacks
+            and slab allocations), in bytes. Not available with cgroup v1.
+    \row
+        \li \c shmem
+        \li The amount of shared memory (e.g. tmpfs and shared anonymous mappings), in bytes.
+    \endtable
 */
 
 /*!
@@ -119,11 +145,13 @@ ProcessStatus::ProcessStatus(QObject *parent)
     connect(m_reader, &ProcessReader::updated, this, [this]() {
         fetchReadings();
         emit cpuLoadChanged();
+        emit gpuUsageChanged();
         emit memoryReportingChanged(m_memoryVirtual, m_memoryRss, m_memoryPss);
         m_pendingUpdate = false;
     });
     connect(this, &ProcessStatus::processIdChanged, m_reader, &ProcessReader::setProcessId);
     connect(this, &ProcessStatus::memoryReportingEnabledChanged, m_reader, &ProcessReader::enableMemoryReporting);
+    connect(this, &ProcessStatus::controlGroupAccountingChanged, m_reader, &ProcessReader::enableControlGroupAccounting);
 }
 
 ProcessStatus::~ProcessStatus()
@@ -142,7 +170,8 @@ ProcessStatus::~ProcessStatus()
 /*!
     \qmlmethod ProcessStatus::update
 
-    Updates the cpuLoad, memoryVirtual, memoryRss, and memoryPss properties.
+    Updates the cpuLoad, gpuLoad, gpuMemory, memoryVirtual, memoryRss, memoryPss, and
+    memoryControlGroup properties.
 */
 void ProcessStatus::update()
 {
@@ -239,6 +268,9 @@ qint64 ProcessStatus::processId() const
     update() was last called. A value of 0 means the process was idle; a value of 1 means the process used
     the equivalent of one core, which may be split across several cores.
 
+    If controlGroupAccounting is enabled, this is the combined CPU utilization of all processes in
+    the application's control group.
+
     \sa ProcessStatus::update
 */
 qreal ProcessStatus::cpuLoad()
@@ -246,11 +278,46 @@ qreal ProcessStatus::cpuLoad()
     return m_cpuLoad;
 }
 
+/*!
+    \qmlproperty real ProcessStatus::gpuLoad
+    \readonly
+
+    This property holds the process' GPU utilization during the previous measurement interval, when
+    update() was last called, as a value ranging from 0 (idle) to 1 (the busiest GPU engine was
+    fully used by this process).
+
+    This is read from the usage statistics that the kernel's DRM drivers provide in
+    \c{/proc/<pid>/fdinfo}, which are available for most open source drivers since Linux 5.19. On
+    other systems, the value is always 0.
+
+    \sa ProcessStatus::update, gpuMemory
+*/
+qreal ProcessStatus::gpuLoad() const
+{
+    return m_gpuLoad;
+}
+
+/*!
+    \qmlproperty real ProcessStatus::gpuMemory
+    \readonly
+
+    This property holds the amount of GPU memory in bytes, that the process had allocated when
+    update() was last called. The same restrictions as for gpuLoad apply.
+
+    \sa ProcessStatus::update, gpuLoad
+*/
+quint64 ProcessStatus::gpuMemory() const
+{
+    return m_gpuMemory;
+}
+
 void ProcessStatus::fetchReadings()
 {
     QMutexLocker locker(&m_reader->mutex);
 
     m_cpuLoad = m_reader->cpuLoad;
+    m_gpuLoad = m_reader->gpuLoad;
+    m_gpuMemory = m_reader->gpuMemory;
 
     // Although smaps claims to report kB it's actually KiB (2^10 = 1024 Bytes)
     m_memoryVirtual[qSL("total")] = static_cast<quint64>(m_reader->memory.totalVm) << 10;
@@ -262,6 +329,18 @@ void ProcessStatus::fetchReadings()
     m_memoryPss[qSL("total")] = static_cast<quint64>(m_reader->memory.totalPss) << 10;
     m_memoryPss[qSL("text")] = static_cast<quint64>(m_reader->memory.textPss) << 10;
     m_memoryPss[qSL("heap")] = static_cast<quint64>(m_reader->memory.heapPss) << 10;
+
+    if (m_reader->controlGroup.valid) {
+        m_memoryControlGroup = QVariantMap {
+            { qSL("total"), m_reader->controlGroup.memoryTotal },
+            { qSL("anon"), m_reader->controlGroup.memoryAnon },
+            { qSL("file"), m_reader->controlGroup.memoryFile },
+            { qSL("kernel"), m_reader->controlGroup.memoryKernel },
+            { qSL("shmem"), m_reader->controlGroup.memoryShmem }
+        };
+    } else {
+        m_memoryControlGroup.clear();
+    }
 }
 
 /*!
@@ -318,6 +397,28 @@ QVariantMap ProcessStatus::memoryPss() const
     return m_memoryPss;
 }
 
+/*!
+    \qmlproperty var ProcessStatus::memoryControlGroup
+    \readonly
+
+    A map of the memory usage of the application's control group. In contrast to the per-process
+    properties, this includes all helper and child processes of the application. For more
+    information, see the table of \l{control-group-keys}{control group keys}.
+
+    The map is empty, if controlGroupAccounting is disabled or the process is not running in a
+    dedicated control group. A group is only considered dedicated, if all of its processes are
+    the application's process or its descendants: a cgroup v1 mapping that puts several
+    applications into the same group does not qualify, as its totals are not per application.
+
+    Calling ProcessStatus::update() updates the value of this property.
+
+    \sa controlGroupAccounting, ProcessStatus::update()
+*/
+QVariantMap ProcessStatus::memoryControlGroup() const
+{
+    return m_memoryControlGroup;
+}
+
 /*!
     \qmlproperty bool ProcessStatus::memoryReportingEnabled
 
@@ -341,6 +442,33 @@ void ProcessStatus::setMemoryReportingEnabled(bool enabled)
     }
 }
 
+/*!
+    \qmlproperty bool ProcessStatus::controlGroupAccounting
+
+    A boolean value that determines whether the cpuLoad and memoryControlGroup properties are read
+    from the counters of the control group the process is running in. This is only supported on
+    Linux and requires the application to run in a dedicated control group (see
+    \l{control group mapping}{the container's control group mapping}). The default value is \c false.
+
+    The kernel keeps aggregated counters for all processes in a control group, so this is both more
+    complete and a lot cheaper than parsing the \c smaps of a single process: if you only need the
+    totals, consider disabling memoryReportingEnabled at the same time. If the process is not
+    running in a dedicated control group (see memoryControlGroup), the per-process values are
+    reported as usual.
+*/
+bool ProcessStatus::isControlGroupAccountingEnabled() const
+{
+    return m_controlGroupAccountingEnabled;
+}
+
+void ProcessStatus::setControlGroupAccountingEnabled(bool enabled)
+{
+    if (enabled != m_controlGroupAccountingEnabled) {
+        m_controlGroupAccountingEnabled = enabled;
+        emit controlGroupAccountingChanged(m_controlGroupAccountingEnabled);
+    }
+}
+
 /*!
     \qmlproperty list<string> ProcessStatus::roleNames
     \readonly
@@ -351,7 +479,8 @@ void ProcessStatus::setMemoryReportingEnabled(bool enabled)
 */
 QStringList ProcessStatus::roleNames() const
 {
-    return { qSL("cpuLoad"), qSL("memoryVirtual"), qSL("memoryRss"), qSL("memoryPss") };
+    return { qSL("cpuLoad"), qSL("gpuLoad"), qSL("gpuMemory"), qSL("memoryVirtual"), qSL("memoryRss"),
+             qSL("memoryPss"), qSL("memoryControlGroup") };
 }
 
 #include "moc_processstatus.cpp"
@@ -26,11 +26,17 @@ class ProcessStatus : public QObject
     Q_PROPERTY(QString applicationId READ applicationId WRITE setApplicationId NOTIFY applicationIdChanged)
     Q_PROPERTY(qint64 processId READ processId NOTIFY processIdChanged)
     Q_PROPERTY(qreal cpuLoad READ cpuLoad NOTIFY cpuLoadChanged)
+    Q_PROPERTY(qreal gpuLoad READ gpuLoad NOTIFY gpuUsageChanged)
+    Q_PROPERTY(quint64 gpuMemory READ gpuMemory NOTIFY gpuUsageChanged)
     Q_PROPERTY(QVariantMap memoryVirtual READ memoryVirtual NOTIFY memoryReportingChanged)
     Q_PROPERTY(QVariantMap memoryRss READ memoryRss NOTIFY memoryReportingChanged)
     Q_PROPERTY(QVariantMap memoryPss READ memoryPss NOTIFY memoryReportingChanged)
+    Q_PROPERTY(QVariantMap memoryControlGroup READ memoryControlGroup NOTIFY memoryReportingChanged)
     Q_PROPERTY(bool memoryReportingEnabled READ isMemoryReportingEnabled WRITE setMemoryReportingEnabled
                                            NOTIFY memoryReportingEnabledChanged)
+    Q_PROPERTY(bool controlGroupAccounting READ isControlGroupAccountingEnabled
+                                           WRITE setControlGroupAccountingEnabled
+                                           NOTIFY controlGroupAccountingChanged)
     Q_PROPERTY(QStringList roleNames READ roleNames CONSTANT)
 public:
     ProcessStatus(QObject *parent = nullptr);
@@ -46,20 +52,28 @@ public:
     void setApplicationId(const QString &appId);
 
     qreal cpuLoad();
+    qreal gpuLoad() const;
+    quint64 gpuMemory() const;
     QVariantMap memoryVirtual() const;
     QVariantMap memoryRss() const;
     QVariantMap memoryPss() const;
+    QVariantMap memoryControlGroup() const;
 
     bool isMemoryReportingEnabled() const;
     void setMemoryReportingEnabled(bool enabled);
 
+    bool isControlGroupAccountingEnabled() const;
+    void setControlGroupAccountingEnabled(bool enabled);
+
 signals:
     void applicationIdChanged(const QString &applicationId);
     void processIdChanged(qint64 processId);
     void cpuLoadChanged();
+    void gpuUsageChanged();
     void memoryReportingChanged(const QVariantMap &memoryVirtual, const QVariantMap &memoryRss,
                                                                   const QVariantMap &memoryPss);
     void memoryReportingEnabledChanged(bool enabled);
+    void controlGroupAccountingChanged(bool enabled);
 
 private slots:
     void onRunStateChanged(Am::RunState state);
@@ -72,10 +86,14 @@ private:
     qint64 m_pid = 0;
 
     qreal m_cpuLoad = 0;
+    qreal m_gpuLoad = 0;
+    quint64 m_gpuMemory = 0;
     QVariantMap m_memoryVirtual;
     QVariantMap m_memoryRss;
     QVariantMap m_memoryPss;
+    QVariantMap m_memoryControlGroup;
     bool m_memoryReportingEnabled = true;
+    bool m_controlGroupAccountingEnabled = false;
 
     QPointer<Application> m_application;
 
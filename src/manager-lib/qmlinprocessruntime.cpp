@@ -37,12 +37,34 @@ QT_BEGIN_NAMESPACE_AM
 const char *QmlInProcessRuntime::s_runtimeKey = "_am_runtime";
 
 
+class QmlInProcessIncubator : public QQmlIncubator
+{
+public:
+    QmlInProcessIncubator(QmlInProcessRuntime *runtime, IncubationMode mode)
+        : QQmlIncubator(mode)
+        , m_runtime(runtime)
+    { }
+
+protected:
+    void statusChanged(Status status) override
+    {
+        m_runtime->incubatorStatusChanged(status);
+    }
+
+private:
+    QmlInProcessRuntime *m_runtime;
+};
+
+
 QmlInProcessRuntime::QmlInProcessRuntime(Application *app, QmlInProcessRuntimeManager *manager)
     : AbstractRuntime(nullptr, app, manager)
 { }
 
 QmlInProcessRuntime::~QmlInProcessRuntime()
 {
+    // cancels a still running object creation
+    m_incubator.reset();
+
     // if there is still a window present at this point, fire the 'closing' signal (probably) again,
     // because it's still the duty of WindowManager together with qml-ui to free and delete this item!!
     for (int i = m_surfaces.size(); i; --i)
@@ -88,13 +110,20 @@ bool QmlInProcessRuntime::start()
         qCDebug(LogSystem) << "Updated Qml import paths:" << m_inProcessQmlEngine->importPathList();
     }
 
+    // use the QML cache that might have been generated when installing the package
+    seedQmlDiskCache(codeDir + precompiledQmlCacheDirName());
+
     const QUrl qmlFileUrl = filePathToUrl(m_app->info()->absoluteCodeFilePath(), codeDir);
-    QQmlComponent *component = new QQmlComponent(m_inProcessQmlEngine, qmlFileUrl);
+    m_component = new QQmlComponent(m_inProcessQmlEngine, qmlFileUrl, QQmlComponent::Asynchronous, this);
 
-    if (!component->isReady()) {
+    // errors that can be detected right away (e.g. a missing file) still fail the start, but
+    // compilation errors are only reported once the type loader is done
+    if (m_component->isError()) {
         qCCritical(LogSystem).noquote().nospace() << "Failed to load component "
                                                   << m_app->info()->absoluteCodeFilePath()
-                                                  << ":\n" << component->errorString();
+                                                  << ":\n" << m_component->errorString();
+        delete m_component;
+        m_component = nullptr;
         return false;
     }
 
@@ -104,45 +133,103 @@ bool QmlInProcessRuntime::start()
 
     // We are running each application in it's own, separate Qml context.
     // This way, we can export an unique ApplicationInterface object for each app
-    QQmlContext *appContext = new QQmlContext(m_inProcessQmlEngine->rootContext(), this);
+    m_appContext = new QQmlContext(m_inProcessQmlEngine->rootContext(), this);
     m_applicationIf = new QmlInProcessApplicationInterface(this);
-    appContext->setContextProperty(qSL("ApplicationInterface"), m_applicationIf);
+    m_appContext->setContextProperty(qSL("ApplicationInterface"), m_applicationIf);
     connect(m_applicationIf, &QmlInProcessApplicationInterface::quitAcknowledged,
             this, [this]() { finish(0, Am::NormalExit); });
 
-    if (appContext->setProperty(s_runtimeKey, QVariant::fromValue(this)))
+    if (m_appContext->setProperty(s_runtimeKey, QVariant::fromValue(this)))
         qCritical() << "Could not set" << s_runtimeKey << "property in QML context";
 
-    QObject *obj = component->beginCreate(appContext);
-
-    QMetaObject::invokeMethod(this, [component, obj, this]() {
-        component->completeCreate();
-        delete component;
-        if (!obj) {
-            qCCritical(LogSystem) << "could not load" << m_app->info()->absoluteCodeFilePath() << ": no root object";
-            finish(3, Am::NormalExit);
-        } else {
-            if (state() == Am::ShuttingDown) {
-                delete obj;
-                return;
-            }
+    // The runtime stays in StartingUp until the component has been compiled and the root object
+    // has been created. Even if the component is already available (e.g. from the type cache),
+    // the creation is deferred, so that start() returns before any surface is announced.
+    if (m_component->isLoading()) {
+        connect(m_component, &QQmlComponent::statusChanged,
+                this, [this](QQmlComponent::Status status) {
+            if (status != QQmlComponent::Loading)
+                componentLoaded();
+        });
+    } else {
+        QMetaObject::invokeMethod(this, &QmlInProcessRuntime::componentLoaded, Qt::QueuedConnection);
+    }
+    return true;
+}
 
-            if (!qobject_cast<QmlInProcessApplicationManagerWindow*>(obj)) {
-                QQuickItem *item = qobject_cast<QQuickItem*>(obj);
-                if (item) {
-                    auto surfaceItem = new InProcessSurfaceItem;
-                    item->setParentItem(surfaceItem);
-                    addSurfaceItem(QSharedPointer<InProcessSurfaceItem>(surfaceItem));
-                }
-            }
-            m_rootObject = obj;
-            setState(Am::Running);
+void QmlInProcessRuntime::componentLoaded()
+{
+    if (!m_component)
+        return;
 
-            if (!m_document.isEmpty())
-                openDocument(m_document, QString());
-        }
+    disconnect(m_component, &QQmlComponent::statusChanged, this, nullptr);
+
+    if (state() == Am::ShuttingDown) {
+        m_component->deleteLater();
+        m_component = nullptr;
+        return;
+    }
+
+    if (!m_component->isReady()) {
+        qCCritical(LogSystem).noquote().nospace() << "Failed to load component "
+                                                  << m_app->info()->absoluteCodeFilePath()
+                                                  << ":\n" << m_component->errorString();
+        m_component->deleteLater();
+        m_component = nullptr;
+        finish(3, Am::NormalExit);
+        return;
+    }
+
+    // The incubation controller of the System UI's window spends the idle time of each frame on
+    // creating objects, so animations keep running while the app's object tree is built up.
+    // Without a controller (no window yet), an asynchronous incubation would never finish.
+    const auto mode = m_inProcessQmlEngine->incubationController() ? QQmlIncubator::Asynchronous
+                                                                   : QQmlIncubator::Synchronous;
+    m_incubator.reset(new QmlInProcessIncubator(this, mode));
+    m_component->create(*m_incubator, m_appContext);
+}
+
+void QmlInProcessRuntime::incubatorStatusChanged(QQmlIncubator::Status status)
+{
+    if ((status == QQmlIncubator::Loading) || (status == QQmlIncubator::Null))
+        return;
+
+    QObject *obj = (status == QQmlIncubator::Ready) ? m_incubator->object() : nullptr;
+    if (status == QQmlIncubator::Error) {
+        for (const QQmlError &error : m_incubator->errors())
+            qCCritical(LogSystem).noquote() << error.toString();
+    }
+
+    // we are called from within the incubator, so it cannot be deleted right away
+    QMetaObject::invokeMethod(this, [this]() {
+        m_incubator.reset();
+        delete m_component;
+        m_component = nullptr;
     }, Qt::QueuedConnection);
-    return true;
+
+    if (!obj) {
+        qCCritical(LogSystem) << "could not load" << m_app->info()->absoluteCodeFilePath() << ": no root object";
+        finish(3, Am::NormalExit);
+    } else {
+        if (state() == Am::ShuttingDown) {
+            delete obj;
+            return;
+        }
+
+        if (!qobject_cast<QmlInProcessApplicationManagerWindow*>(obj)) {
+            QQuickItem *item = qobject_cast<QQuickItem*>(obj);
+            if (item) {
+                auto surfaceItem = new InProcessSurfaceItem;
+                item->setParentItem(surfaceItem);
+                addSurfaceItem(QSharedPointer<InProcessSurfaceItem>(surfaceItem));
+            }
+        }
+        m_rootObject = obj;
+        setState(Am::Running);
+
+        if (!m_document.isEmpty())
+            openDocument(m_document, QString());
+    }
 }
 
 void QmlInProcessRuntime::stop(bool forceKill)
@@ -150,6 +237,10 @@ void QmlInProcessRuntime::stop(bool forceKill)
     setState(Am::ShuttingDown);
     emit aboutToStop();
 
+    // the app is stopped while its objects are still being created: drop them right away
+    if (m_incubator && m_incubator->isLoading())
+        m_incubator->clear();
+
     for (int i = m_surfaces.size(); i; --i)
         m_surfaces.at(i-1)->setVisibleClientSide(false);
 
@@ -7,13 +7,19 @@
 
 #include <QtAppManManager/abstractruntime.h>
 
+#include <memory>
 #include <QSharedPointer>
+#include <QQmlIncubator>
+
+QT_FORWARD_DECLARE_CLASS(QQmlComponent)
+QT_FORWARD_DECLARE_CLASS(QQmlContext)
 
 QT_BEGIN_NAMESPACE_AM
 
 class QmlInProcessApplicationManagerWindow;
 class QmlInProcessApplicationInterface;
 class InProcessSurfaceItem;
+class QmlInProcessIncubator;
 
 class QmlInProcessRuntimeManager : public AbstractRuntimeManager
 {
@@ -62,6 +68,9 @@ private:
 
     bool m_stopIfNoVisibleSurfaces = false;
 
+    void componentLoaded();
+    void incubatorStatusChanged(QQmlIncubator::Status status);
+
     void loadResources(const QStringList &resources, const QString &baseDir);
     void addPluginPaths(const QStringList &pluginPaths, const QString &baseDir);
     void addImportPaths(const QStringList &importPaths, const QString &baseDir);
@@ -74,7 +83,14 @@ private:
     QObject *m_rootObject = nullptr;
     QList< QSharedPointer<InProcessSurfaceItem> > m_surfaces;
 
+    // the app's QML is compiled on the type loader thread and created via an incubator, so that
+    // starting an app does not block the System UI's render loop
+    QQmlContext *m_appContext = nullptr;
+    QQmlComponent *m_component = nullptr;
+    std::unique_ptr<QmlInProcessIncubator> m_incubator;
+
     friend class QmlInProcessApplicationManagerWindow; // for emitting signals on behalf of this class in onComplete
+    friend class QmlInProcessIncubator;
 };
 
 QT_END_NAMESPACE_AM
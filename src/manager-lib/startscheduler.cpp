@@ -0,0 +1,209 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <algorithm>
+
+#include <QTimer>
+
+#include "global.h"
+#include "logging.h"
+#include "startscheduler.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+StartScheduler::StartScheduler(QObject *parent)
+    : QObject(parent)
+{ }
+
+StartScheduler::~StartScheduler()
+{ }
+
+int StartScheduler::maximumConcurrentStarts() const
+{
+    return m_maximumConcurrentStarts;
+}
+
+void StartScheduler::setMaximumConcurrentStarts(int maximum)
+{
+    m_maximumConcurrentStarts = qMax(0, maximum);
+    processQueue();
+}
+
+int StartScheduler::startTimeout() const
+{
+    return m_startTimeout;
+}
+
+void StartScheduler::setStartTimeout(int msec)
+{
+    m_startTimeout = qMax(0, msec);
+}
+
+bool StartScheduler::schedule(const QString &id, Priority priority, const std::function<bool()> &start,
+                              const std::function<void()> &cancel)
+{
+    if (hasFreeSlot())
+        return run(id, 0, start);
+
+    QueuedStart queuedStart { id, priority, { }, start, cancel };
+    queuedStart.queueTimer.start();
+
+    // user starts pre-empt all queued background starts, but are FIFO among themselves
+    auto pos = m_queue.end();
+    if (priority == UserStart) {
+        pos = std::find_if(m_queue.begin(), m_queue.end(), [](const auto &qs) {
+            return qs.priority == BackgroundStart;
+        });
+    }
+    m_queue.insert(pos, queuedStart);
+
+    qCDebug(LogSystem) << "Queued the" << (priority == UserStart ? "user" : "background")
+                       << "start of application" << id << "(" << m_active.size()
+                       << "starts in progress," << m_queue.size() << "queued)";
+    return true;
+}
+
+bool StartScheduler::isQueued(const QString &id) const
+{
+    return std::any_of(m_queue.cbegin(), m_queue.cend(), [id](const auto &qs) { return qs.id == id; });
+}
+
+bool StartScheduler::isActive(const QString &id) const
+{
+    return m_active.contains(id);
+}
+
+bool StartScheduler::promote(const QString &id)
+{
+    auto it = std::find_if(m_queue.begin(), m_queue.end(), [id](const auto &qs) { return qs.id == id; });
+    if (it == m_queue.end())
+        return false;
+
+    if (it->priority == BackgroundStart) {
+        auto queuedStart = *it;
+        m_queue.erase(it);
+        queuedStart.priority = UserStart;
+        auto pos = std::find_if(m_queue.begin(), m_queue.end(), [](const auto &qs) {
+            return qs.priority == BackgroundStart;
+        });
+        m_queue.insert(pos, queuedStart);
+        qCDebug(LogSystem) << "Promoted the queued start of application" << id << "to a user start";
+    }
+    return true;
+}
+
+bool StartScheduler::cancel(const QString &id)
+{
+    auto it = std::find_if(m_queue.begin(), m_queue.end(), [id](const auto &qs) { return qs.id == id; });
+    if (it == m_queue.end())
+        return false;
+
+    qCDebug(LogSystem) << "Cancelled the queued start of application" << id;
+    const auto cancelFunction = it->cancel;
+    m_queue.erase(it);
+    if (cancelFunction)
+        cancelFunction();
+    return true;
+}
+
+void StartScheduler::cancelAll()
+{
+    while (!m_queue.isEmpty())
+        cancel(m_queue.constFirst().id);
+}
+
+void StartScheduler::finished(const QString &id, bool success)
+{
+    auto it = m_active.find(id);
+    if (it == m_active.end())
+        return;
+
+    const int queueTime = int(it->queueTime);
+    const int startupTime = int(it->startupTimer.elapsed());
+    m_active.erase(it);
+
+    qCDebug(LogSystem) << "Application" << id << (success ? "started" : "failed to start")
+                       << "after" << startupTime << "msec (queued for" << queueTime << "msec)";
+    if (success)
+        emit startTimes(id, queueTime, startupTime);
+
+    // we are called from within a state change: do not start the next app in the middle of it
+    if (!m_processQueuePending && !m_queue.isEmpty()) {
+        m_processQueuePending = true;
+        QMetaObject::invokeMethod(this, [this]() {
+            m_processQueuePending = false;
+            processQueue();
+        }, Qt::QueuedConnection);
+    }
+}
+
+void StartScheduler::remove(const QString &id)
+{
+    cancel(id);
+    if (m_active.remove(id))
+        processQueue();
+}
+
+int StartScheduler::activeCount() const
+{
+    return m_active.size();
+}
+
+QStringList StartScheduler::queuedIds() const
+{
+    QStringList ids;
+    for (const auto &qs : m_queue)
+        ids << qs.id;
+    return ids;
+}
+
+bool StartScheduler::hasFreeSlot() const
+{
+    return (m_maximumConcurrentStarts <= 0) || (m_active.size() < m_maximumConcurrentStarts);
+}
+
+bool StartScheduler::run(const QString &id, qint64 queueTime, const std::function<bool()> &start)
+{
+    const quint64 serial = ++m_nextSerial;
+    ActiveStart activeStart { queueTime, { }, serial };
+    activeStart.startupTimer.start();
+    m_active.insert(id, activeStart);
+
+    // an application that never reaches the Running state (e.g. because it hangs in its
+    // initialization) must not block its slot forever
+    if (m_startTimeout > 0)
+        QTimer::singleShot(m_startTimeout, this, [this, id, serial]() { timeout(id, serial); });
+
+    bool ok = start();
+    if (!ok) {
+        auto it = m_active.find(id);
+        if ((it != m_active.end()) && (it->serial == serial))
+            m_active.erase(it);
+    }
+    return ok;
+}
+
+void StartScheduler::processQueue()
+{
+    while (!m_queue.isEmpty() && hasFreeSlot()) {
+        auto queuedStart = m_queue.takeFirst();
+        run(queuedStart.id, queuedStart.queueTimer.elapsed(), queuedStart.start);
+    }
+}
+
+void StartScheduler::timeout(const QString &id, quint64 serial)
+{
+    auto it = m_active.find(id);
+    if ((it == m_active.end()) || (it->serial != serial))
+        return;
+
+    m_active.erase(it);
+    qCWarning(LogSystem) << "Application" << id << "did not finish starting up within"
+                         << m_startTimeout << "msec - releasing its start slot";
+    emit startTimedOut(id);
+    processQueue();
+}
+
+QT_END_NAMESPACE_AM
+
+#include "moc_startscheduler.cpp"
@@ -0,0 +1,87 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#pragma once
+
+#include <functional>
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+
+#include <QtAppManCommon/global.h>
+
+QT_BEGIN_NAMESPACE_AM
+
+// Limits the number of applications that are starting up at the same time. Starts beyond
+// maximumConcurrentStarts() are queued, with user starts always being placed in front of
+// background starts. A start occupies its slot until finished() is called for it, or until the
+// startTimeout() expires. The actual starting is done by the callbacks of the ApplicationManager.
+class StartScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority {
+        BackgroundStart,
+        UserStart
+    };
+
+    explicit StartScheduler(QObject *parent = nullptr);
+    ~StartScheduler() override;
+
+    int maximumConcurrentStarts() const;
+    void setMaximumConcurrentStarts(int maximum);
+    int startTimeout() const;
+    void setStartTimeout(int msec);
+
+    // returns the result of start(), if it is called right away - true otherwise
+    bool schedule(const QString &id, Priority priority, const std::function<bool()> &start,
+                  const std::function<void()> &cancel = { });
+    bool isQueued(const QString &id) const;
+    bool isActive(const QString &id) const;
+    bool promote(const QString &id);
+    bool cancel(const QString &id);
+    void cancelAll();
+    void finished(const QString &id, bool success);
+    void remove(const QString &id);
+
+    int activeCount() const;
+    QStringList queuedIds() const;
+
+signals:
+    void startTimes(const QString &id, int queueTime, int startupTime);
+    void startTimedOut(const QString &id);
+
+private:
+    bool hasFreeSlot() const;
+    bool run(const QString &id, qint64 queueTime, const std::function<bool()> &start);
+    void processQueue();
+    void timeout(const QString &id, quint64 serial);
+
+    struct QueuedStart
+    {
+        QString id;
+        Priority priority;
+        QElapsedTimer queueTimer;
+        std::function<bool()> start;
+        std::function<void()> cancel;
+    };
+    struct ActiveStart
+    {
+        qint64 queueTime;
+        QElapsedTimer startupTimer;
+        quint64 serial;
+    };
+
+    int m_maximumConcurrentStarts = 0; // unlimited
+    int m_startTimeout = 0; // disabled
+    QList<QueuedStart> m_queue;
+    QHash<QString, ActiveStart> m_active;
+    quint64 m_nextSerial = 0;
+    bool m_processQueuePending = false;
+};
+
+QT_END_NAMESPACE_AM
@@ -11,6 +11,9 @@
 #include <QDataStream>
 #include <qplatformdefs.h>
 #include <QDataStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
 
 #include "logging.h"
 #include "sudo.h"
@@ -19,6 +22,7 @@
 #include "global.h"
 
 #include <errno.h>
+#include <algorithm>
 
 #if defined(Q_OS_LINUX)
 # include "processtitle.h"
@@ -30,6 +34,7 @@
 #  include <sys/ioctl.h>
 #  include <sys/stat.h>
 #  include <sys/prctl.h>
+#  include <sys/syscall.h>
 #  include <linux/capability.h>
 
 // These two functions are implemented in glibc, but the header file is
@@ -215,26 +220,70 @@ SudoInterface::SudoInterface()
 { }
 
 #ifdef Q_OS_LINUX
-bool SudoInterface::sendMessage(int socket, const QByteArray &msg, MessageType type, const QString &errorString)
+bool SudoInterface::sendMessage(int socket, quint32 id, const QByteArray &msg, MessageType type,
+                                const QString &errorString, int fd)
 {
     QByteArray packet;
     QDataStream ds(&packet, QDataStream::WriteOnly);
-    ds << errorString << msg;
+    ds << id << errorString << msg;
     packet.prepend((type == Request) ? "RQST" : "RPLY");
 
-    auto bytesWritten = EINTR_LOOP(write(socket, packet.constData(), static_cast<size_t>(packet.size())));
+    iovec iov { packet.data(), static_cast<size_t>(packet.size()) };
+    msghdr mh;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+
+    char cmsgBuffer[CMSG_SPACE(sizeof(int))];
+    if (fd >= 0) {
+        memset(cmsgBuffer, 0, sizeof(cmsgBuffer));
+        mh.msg_control = cmsgBuffer;
+        mh.msg_controllen = sizeof(cmsgBuffer);
+        cmsghdr *cmsg = CMSG_FIRSTHDR(&mh);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    }
+
+    auto bytesWritten = EINTR_LOOP(sendmsg(socket, &mh, 0));
     return bytesWritten == packet.size();
 }
 
 
-QByteArray SudoInterface::receiveMessage(int socket, MessageType type, QString *errorString)
+QByteArray SudoInterface::receiveMessage(int socket, MessageType type, quint32 *id, QString *errorString, int *fd)
 {
     const int headerSize = 4;
     char recvBuffer[8*1024];
-    auto bytesReceived = EINTR_LOOP(recv(socket, recvBuffer, sizeof(recvBuffer), 0));
+
+    iovec iov { recvBuffer, sizeof(recvBuffer) };
+    char cmsgBuffer[CMSG_SPACE(sizeof(int))];
+    msghdr mh;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    mh.msg_control = cmsgBuffer;
+    mh.msg_controllen = sizeof(cmsgBuffer);
+
+    auto bytesReceived = EINTR_LOOP(recvmsg(socket, &mh, MSG_CMSG_CLOEXEC));
+
+    int receivedFd = -1;
+    if (bytesReceived >= 0) {
+        for (cmsghdr *cmsg = CMSG_FIRSTHDR(&mh); cmsg; cmsg = CMSG_NXTHDR(&mh, cmsg)) {
+            if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_RIGHTS))
+                memcpy(&receivedFd, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+    if (fd)
+        *fd = receivedFd;
+    else if (receivedFd >= 0)
+        QT_CLOSE(receivedFd);
+
+    *id = 0;
 
     if ((bytesReceived < headerSize) || qstrncmp(recvBuffer, (type == Request ? "RQST" : "RPLY"), 4)) {
-        *errorString = qL1S("failed to receive command from the SudoClient process");
+        *errorString = (type == Request) ? qL1S("failed to receive command from the SudoClient process")
+                                         : qL1S("failed to receive reply from the SudoServer process");
         //qCCritical(LogSystem) << *errorString;
         return QByteArray();
     }
@@ -243,7 +292,9 @@ QByteArray SudoInterface::receiveMessage(int socket, MessageType type, QString *
 
     QDataStream ds(&packet, QDataStream::ReadOnly);
     QByteArray msg;
-    ds >> *errorString >> msg;
+    ds >> *id >> *errorString >> msg;
+    if (ds.status() != QDataStream::Ok)
+        *id = 0;
     return msg;
 }
 #endif // Q_OS_LINUX
@@ -274,65 +325,292 @@ SudoClient *SudoClient::createInstance(int socketFd, SudoServer *shortCircuit)
     return s_instance;
 }
 
+// The I/O priority of the calling thread: 0 is the default (derived from the nice value)
+static qint32 threadIoPriority()
+{
+#if defined(SYS_ioprio_get)
+    enum { IoPrioWhoProcess = 1 };
+    return qMax(0, int(::syscall(SYS_ioprio_get, IoPrioWhoProcess, 0 /* calling thread */)));
+#else
+    return 0;
+#endif
+}
 
-// this is not nice, but it prevents a lot of copy/paste errors. (the C++ variadic template version
-// would be equally ugly, since it needs a friend declaration in the public header)
-template <typename R, typename C, typename ...Ps> R returnType(R (C::*)(Ps...));
+// returns the previous I/O priority of the calling thread
+static qint32 setThreadIoPriority(qint32 ioPriority)
+{
+    const qint32 previous = threadIoPriority();
+#if defined(SYS_ioprio_set)
+    enum { IoPrioWhoProcess = 1 };
+    if ((ioPriority != previous)
+            && (::syscall(SYS_ioprio_set, IoPrioWhoProcess, 0 /* calling thread */, ioPriority) < 0)) {
+        qCWarning(LogSystem) << "Could not set the I/O priority of a SudoServer thread:" << strerror(errno);
+    }
+#else
+    Q_UNUSED(ioPriority)
+#endif
+    return previous;
+}
 
-#define CALL(FUNC_NAME, PARAM) \
-    QByteArray msg; \
-    QDataStream(&msg, QDataStream::WriteOnly) << #FUNC_NAME << PARAM; \
-    QByteArray reply = call(msg); \
-    QDataStream result(&reply, QDataStream::ReadOnly); \
-    decltype(returnType(&SudoClient::FUNC_NAME)) r; \
-    result >> r; \
-    return r
+template <typename ...Ps>
+QByteArray SudoClient::request(Function function, const Ps &...params)
+{
+    QByteArray msg;
+    QDataStream ds(&msg, QDataStream::WriteOnly);
+    // The caller's I/O priority (see AsynchronousTask::run()) is passed along, so that the
+    // SudoServer does the work at the same priority as the caller would have done it itself.
+    ds << static_cast<quint8>(function) << threadIoPriority();
+    (ds << ... << params);
+    return msg;
+}
 
 bool SudoClient::removeRecursive(const QString &fileOrDir)
 {
-    CALL(removeRecursive, fileOrDir);
+    return waitForReply(submitRemoveRecursive(fileOrDir));
 }
 
 bool SudoClient::setOwnerAndPermissionsRecursive(const QString &fileOrDir, uid_t user, gid_t group, mode_t permissions)
 {
-    CALL(setOwnerAndPermissionsRecursive, fileOrDir << user << group << permissions);
+    return waitForReply(submitSetOwnerAndPermissionsRecursive(fileOrDir, user, group, permissions));
+}
+
+bool SudoClient::setOwnerAndPermissions(int fd, uid_t user, gid_t group, mode_t permissions)
+{
+    return waitForReply(submitSetOwnerAndPermissions(fd, user, group, permissions));
+}
+
+quint32 SudoClient::submitRemoveRecursive(const QString &fileOrDir)
+{
+    return submit(request(RemoveRecursive, fileOrDir));
+}
+
+quint32 SudoClient::submitSetOwnerAndPermissionsRecursive(const QString &fileOrDir, uid_t user, gid_t group, mode_t permissions)
+{
+    return submit(request(SetOwnerAndPermissionsRecursive, fileOrDir, user, group, permissions));
+}
+
+quint32 SudoClient::submitSetOwnerAndPermissions(int fd, uid_t user, gid_t group, mode_t permissions)
+{
+    return submit(request(SetOwnerAndPermissions, user, group, permissions), fd);
 }
 
 void SudoClient::stopServer()
 {
 #ifdef Q_OS_LINUX
     if (!m_shortCircuit && m_socket >= 0) {
-        QByteArray msg;
-        QDataStream(&msg, QDataStream::WriteOnly) << "stopServer";
-        sendMessage(m_socket, msg, Request);
+        QMutexLocker locker(&m_mutex);
+        sendMessage(m_socket, m_nextRequestId++, request(StopServer), Request);
     }
 #endif
 }
 
-QByteArray SudoClient::call(const QByteArray &msg)
+quint32 SudoClient::submit(const QByteArray &msg, int fd)
 {
     QMutexLocker locker(&m_mutex);
 
+    const quint32 id = m_nextRequestId++;
+    if (!m_nextRequestId) // 0 is reserved for "invalid"
+        m_nextRequestId = 1;
+    m_pendingIds.insert(id);
+
     if (m_shortCircuit) {
-        const QByteArray res = m_shortCircuit->receive(msg);
-        m_errorString = m_shortCircuit->lastError();
-        return res;
+        ReplyData data;
+        data.result = SudoServer::execute(msg, fd, &data.errorString);
+        m_replies.insert(id, data);
+        return id;
     }
 
 #ifdef Q_OS_LINUX
     if (m_socket >= 0) {
-        if (sendMessage(m_socket, msg, Request))
-            return receiveMessage(m_socket, Reply, &m_errorString);
+        // do not let the server queue up an unlimited amount of work
+        while (m_requestsInFlight >= MaxRequestsInFlight) {
+            if (!receiveReply(locker))
+                break;
+        }
+        // Reserve the slot, but do not hold the lock while sending: sendmsg() blocks, if the
+        // server's queue is full, and another thread might need the lock to receive the replies
+        // the server is trying to get rid of.
+        ++m_requestsInFlight;
+        locker.unlock();
+        // the file descriptor is duplicated while in transit: the caller can close it right away
+        const bool sent = sendMessage(m_socket, id, msg, Request, QString(), fd);
+        locker.relock();
+        if (sent)
+            return id;
+        --m_requestsInFlight;
     }
 #else
     Q_UNUSED(m_socket)
 #endif
 
     //qCCritical(LogSystem) << "failed to send command to the SudoServer process";
-    m_errorString = qL1S("failed to send command to the SudoServer process");
-    return QByteArray();
+    m_replies.insert(id, ReplyData { QByteArray(), qL1S("failed to send command to the SudoServer process") });
+    return id;
+}
+
+bool SudoClient::receiveReply(QMutexLocker<QMutex> &locker)
+{
+#ifdef Q_OS_LINUX
+    // only one thread reads from the socket: all others wait for it to store their reply
+    if (m_receiving) {
+        m_replyReceived.wait(&m_mutex);
+        return true;
+    }
+
+    m_receiving = true;
+    locker.unlock();
+    quint32 id;
+    ReplyData data;
+    data.result = receiveMessage(m_socket, Reply, &id, &data.errorString);
+    locker.relock();
+    m_receiving = false;
+
+    if (id) {
+        m_replies.insert(id, data);
+        --m_requestsInFlight;
+    }
+    m_replyReceived.wakeAll();
+    return (id != 0);
+#else
+    Q_UNUSED(locker)
+    return false;
+#endif
+}
+
+bool SudoClient::waitForReply(quint32 requestId, QString *errorString)
+{
+    QMutexLocker locker(&m_mutex);
+
+    ReplyData data;
+    if (!m_pendingIds.remove(requestId)) {
+        // there will never be a reply: waiting for it would block forever
+        data.errorString = QString::fromLatin1("request %1 was never submitted or has already been collected")
+                .arg(requestId);
+    } else {
+        forever {
+            auto it = m_replies.find(requestId);
+            if (it != m_replies.end()) {
+                data = it.value();
+                m_replies.erase(it);
+                break;
+            }
+            if (!receiveReply(locker)) {
+                data.errorString = qL1S("failed to receive reply from the SudoServer process");
+                break;
+            }
+        }
+    }
+
+    bool result = false;
+    QDataStream(&data.result, QDataStream::ReadOnly) >> result;
+
+    m_errorString = data.errorString;
+    if (errorString)
+        *errorString = data.errorString;
+    return result;
+}
+
+
+
+#if defined(Q_OS_LINUX)
+static mode_t directoryMode(mode_t mode)
+{
+    // set the x bit for directories, but only where it makes sense
+    if (mode & 06)
+        mode |= 01;
+    if (mode & 060)
+        mode |= 010;
+    if (mode & 0600)
+        mode |= 0100;
+    return mode;
+}
+#endif
+
+static bool removeRecursiveOperation(const QString &fileOrDir, QString *errorString)
+{
+    try {
+        if (!recursiveOperation(fileOrDir, safeRemove))
+            throw Exception(errno, "could not recursively remove %1").arg(fileOrDir);
+        return true;
+    } catch (const Exception &e) {
+        *errorString = e.errorString();
+        return false;
+    }
+}
+
+static bool setOwnerAndPermissionsRecursiveOperation(const QString &fileOrDir, uid_t user, gid_t group,
+                                                     mode_t permissions, QString *errorString)
+{
+#if defined(Q_OS_LINUX)
+    auto setOwnerAndPermissions =
+            [user, group, permissions](const QString &path, RecursiveOperationType type) -> bool {
+        if (type == RecursiveOperationType::EnterDirectory)
+            return true;
+
+        const QByteArray localPath = path.toLocal8Bit();
+        bool noModeChange = (permissions == static_cast<mode_t>(-1));
+        mode_t mode = permissions;
+
+        if (type == RecursiveOperationType::LeaveDirectory)
+            mode = directoryMode(mode);
+
+        return ((noModeChange ? true : (chmod(localPath, mode) == 0))
+                && (chown(localPath, user, group) == 0));
+    };
+
+    try {
+        if (!recursiveOperation(fileOrDir, setOwnerAndPermissions)) {
+            throw Exception(errno, "could not recursively set owner and permission on %1 to %2:%3 / %4")
+                .arg(fileOrDir).arg(user).arg(group).arg(permissions, 4, 8, QLatin1Char('0'));
+        }
+        return true;
+    } catch (const Exception &e) {
+        *errorString = e.errorString();
+        return false;
+    }
+#else
+    Q_UNUSED(fileOrDir)
+    Q_UNUSED(user)
+    Q_UNUSED(group)
+    Q_UNUSED(permissions)
+    Q_UNUSED(errorString)
+    return false;
+#endif // Q_OS_LINUX
 }
 
+static bool setOwnerAndPermissionsOperation(int fd, uid_t user, gid_t group, mode_t permissions,
+                                            QString *errorString)
+{
+#if defined(Q_OS_LINUX)
+    try {
+        if (fd < 0)
+            throw Exception("no file descriptor was passed to setOwnerAndPermissions");
+
+        QT_STATBUF statBuf;
+        if (QT_FSTAT(fd, &statBuf) != 0)
+            throw Exception(errno, "could not stat the file descriptor %1").arg(fd);
+
+        bool noModeChange = (permissions == static_cast<mode_t>(-1));
+        mode_t mode = S_ISDIR(statBuf.st_mode) ? directoryMode(permissions) : permissions;
+
+        if ((!noModeChange && (fchmod(fd, mode) != 0)) || (fchown(fd, user, group) != 0)) {
+            throw Exception(errno, "could not set owner and permission on file descriptor %1 to %2:%3 / %4")
+                .arg(fd).arg(user).arg(group).arg(permissions, 4, 8, QLatin1Char('0'));
+        }
+        return true;
+    } catch (const Exception &e) {
+        *errorString = e.errorString();
+        return false;
+    }
+#else
+    Q_UNUSED(fd)
+    Q_UNUSED(user)
+    Q_UNUSED(group)
+    Q_UNUSED(permissions)
+    Q_UNUSED(errorString)
+    return false;
+#endif // Q_OS_LINUX
+}
 
 
 SudoServer *SudoServer::s_instance = nullptr;
@@ -353,19 +631,119 @@ SudoServer *SudoServer::createInstance(int socketFd)
     return s_instance;
 }
 
+/*! \internal
+    Returns the path a request operates on, or an empty string, if it works on a file
+    descriptor (or on nothing at all). Requests with overlapping paths are never run in
+    parallel, see run().
+*/
+QString SudoServer::requestPath(const QByteArray &msg, bool *isStop)
+{
+    QDataStream params(msg);
+    quint8 function = 0;
+    qint32 ioPriority = 0;
+    QString path;
+    params >> function >> ioPriority;
+
+    switch (function) {
+    case RemoveRecursive:
+    case SetOwnerAndPermissionsRecursive:
+        params >> path;
+        path = QDir::cleanPath(path);
+        break;
+    default:
+        break;
+    }
+    if (isStop)
+        *isStop = (function == StopServer);
+    return path;
+}
+
 void SudoServer::run()
 {
 #ifdef Q_OS_LINUX
-    QString dummy;
+    // Independent requests are executed in parallel. A request operating on a path only runs
+    // after all earlier requests with an overlapping path have finished, so requests that depend
+    // on each other are still executed in the order they were sent.
+    // This loop never waits for a request to finish: it has to keep draining the socket, since
+    // the client might be blocked sending us more requests, while we are sending it replies.
+
+    static auto overlaps = [](const QString &path1, const QString &path2) {
+        return (path1 == path2) || path1.startsWith(path2 + qL1C('/')) || path2.startsWith(path1 + qL1C('/'));
+    };
+
+    struct PathRequest
+    {
+        quint64 sequence;
+        QString path;
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 8));
+    QMutex mutex;
+    QWaitCondition requestFinished;
+    QVector<PathRequest> busyPaths; // in the order they were received
+    quint64 nextSequence = 0;
 
     forever {
-        QByteArray msg = receiveMessage(m_socket, Request, &dummy);
-        QByteArray reply = receive(msg);
+        quint32 id;
+        QString dummy;
+        int fd = -1;
+        QByteArray msg = receiveMessage(m_socket, Request, &id, &dummy, &fd);
+
+        if (!id) {
+            // we cannot even reply to a request without an id
+            if (fd >= 0)
+                QT_CLOSE(fd);
+            continue;
+        }
 
-        if (m_stop)
+        bool stop = false;
+        const QString path = requestPath(msg, &stop);
+        if (stop) {
+            pool.waitForDone();
             exit(0);
+        }
+
+        const quint64 sequence = nextSequence++;
+        if (!path.isEmpty()) {
+            QMutexLocker locker(&mutex);
+            busyPaths.append({ sequence, path });
+        }
+
+        pool.start([this, id, msg, fd, path, sequence, &mutex, &requestFinished, &busyPaths]() {
+            if (!path.isEmpty()) {
+                // The pool starts its tasks in order, so all the earlier requests we might have
+                // to wait for are already running: this cannot dead-lock, even with all the
+                // threads of the pool waiting here.
+                auto blockedByEarlierRequest = [&]() {
+                    for (const PathRequest &busy : qAsConst(busyPaths)) {
+                        if (busy.sequence == sequence)
+                            break;
+                        if (overlaps(path, busy.path))
+                            return true;
+                    }
+                    return false;
+                };
+                QMutexLocker locker(&mutex);
+                while (blockedByEarlierRequest())
+                    requestFinished.wait(&mutex);
+            }
+
+            QString errorString;
+            QByteArray reply = execute(msg, fd, &errorString);
+            if (fd >= 0)
+                QT_CLOSE(fd); // this is our own copy of the client's file descriptor
+
+            // the request is done, even if the client is not reading its replies right now
+            if (!path.isEmpty()) {
+                QMutexLocker locker(&mutex);
+                busyPaths.erase(std::find_if(busyPaths.begin(), busyPaths.end(),
+                                             [sequence](const PathRequest &busy) { return busy.sequence == sequence; }));
+                requestFinished.wakeAll();
+            }
 
-        sendMessage(m_socket, reply, Reply, m_errorString);
+            sendMessage(m_socket, id, reply, Reply, errorString);
+        });
     }
 #else
     Q_UNUSED(m_socket)
@@ -374,92 +752,73 @@ void SudoServer::run()
 #endif
 }
 
-QByteArray SudoServer::receive(const QByteArray &msg)
+QByteArray SudoServer::execute(const QByteArray &msg, int fd, QString *errorString)
 {
     QDataStream params(msg);
-    char *functionArray;
-    params >> functionArray;
-    QByteArray function(functionArray);
-    delete [] functionArray;
+    quint8 function = 0;
+    qint32 ioPriority = 0;
+    params >> function >> ioPriority;
     QByteArray reply;
     QDataStream result(&reply, QDataStream::WriteOnly);
-    m_errorString.clear();
+    errorString->clear();
+
+    // the threads of the pool in run() are re-used, so the priority has to be restored afterwards
+    const qint32 previousIoPriority = setThreadIoPriority(ioPriority);
 
-    if (function == "removeRecursive") {
+    switch (function) {
+    case RemoveRecursive: {
         QString fileOrDir;
         params >> fileOrDir;
-        result << removeRecursive(fileOrDir);
-    } else if (function == "setOwnerAndPermissionsRecursive") {
+        result << removeRecursiveOperation(fileOrDir, errorString);
+        break;
+    }
+    case SetOwnerAndPermissionsRecursive: {
         QString fileOrDir;
         uid_t user;
         gid_t group;
         mode_t permissions;
         params >> fileOrDir >> user >> group >> permissions;
-        result << setOwnerAndPermissionsRecursive(fileOrDir, user, group, permissions);
-    } else if (function == "stopServer") {
-        m_stop = true;
-    } else {
+        result << setOwnerAndPermissionsRecursiveOperation(fileOrDir, user, group, permissions, errorString);
+        break;
+    }
+    case SetOwnerAndPermissions: {
+        uid_t user;
+        gid_t group;
+        mode_t permissions;
+        params >> user >> group >> permissions;
+        result << setOwnerAndPermissionsOperation(fd, user, group, permissions, errorString);
+        break;
+    }
+    default:
+        reply.truncate(0);
+        *errorString = QString::fromLatin1("unknown function %1 called in SudoServer").arg(function);
+        break;
+    }
+    setThreadIoPriority(previousIoPriority);
+
+    if ((params.status() != QDataStream::Ok) && !reply.isEmpty()) {
         reply.truncate(0);
-        m_errorString = QString::fromLatin1("unknown function '%1' called in SudoServer").arg(qL1S(function));
+        *errorString = QString::fromLatin1("invalid parameters for function %1 in SudoServer").arg(function);
     }
     return reply;
 }
 
 bool SudoServer::removeRecursive(const QString &fileOrDir)
 {
-    try {
-        if (!recursiveOperation(fileOrDir, safeRemove))
-            throw Exception(errno, "could not recursively remove %1").arg(fileOrDir);
-        return true;
-    } catch (const Exception &e) {
-        m_errorString = e.errorString();
-        return false;
-    }
+    m_errorString.clear();
+    return removeRecursiveOperation(fileOrDir, &m_errorString);
 }
 
 bool SudoServer::setOwnerAndPermissionsRecursive(const QString &fileOrDir, uid_t user, gid_t group, mode_t permissions)
 {
-#if defined(Q_OS_LINUX)
-    static auto setOwnerAndPermissions =
-            [user, group, permissions](const QString &path, RecursiveOperationType type) -> bool {
-        if (type == RecursiveOperationType::EnterDirectory)
-            return true;
-
-        const QByteArray localPath = path.toLocal8Bit();
-        bool noModeChange = (permissions == static_cast<mode_t>(-1));
-        mode_t mode = permissions;
-
-        if (type == RecursiveOperationType::LeaveDirectory) {
-            // set the x bit for directories, but only where it makes sense
-            if (mode & 06)
-                mode |= 01;
-            if (mode & 060)
-                mode |= 010;
-            if (mode & 0600)
-                mode |= 0100;
-        }
-
-        return ((noModeChange ? true : (chmod(localPath, mode) == 0))
-                && (chown(localPath, user, group) == 0));
-    };
+    m_errorString.clear();
+    return setOwnerAndPermissionsRecursiveOperation(fileOrDir, user, group, permissions, &m_errorString);
+}
 
-    try {
-        if (!recursiveOperation(fileOrDir, setOwnerAndPermissions)) {
-            throw Exception(errno, "could not recursively set owner and permission on %1 to %2:%3 / %4")
-                .arg(fileOrDir).arg(user).arg(group).arg(permissions, 4, 8, QLatin1Char('0'));
-        }
-        return true;
-    } catch (const Exception &e) {
-        m_errorString = e.errorString();
-        return false;
-    }
-#else
-    Q_UNUSED(fileOrDir)
-    Q_UNUSED(user)
-    Q_UNUSED(group)
-    Q_UNUSED(permissions)
-    return false;
-#endif // Q_OS_LINUX
+bool SudoServer::setOwnerAndPermissions(int fd, uid_t user, gid_t group, mode_t permissions)
+{
+    m_errorString.clear();
+    return setOwnerAndPermissionsOperation(fd, user, group, permissions, &m_errorString);
 }
 
 QT_END_NAMESPACE_AM
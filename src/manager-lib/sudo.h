@@ -8,6 +8,9 @@
 #include <QString>
 #include <QByteArray>
 #include <QMutex>
+#include <QHash>
+#include <QSet>
+#include <QWaitCondition>
 #include <qplatformdefs.h>
 
 #ifdef Q_OS_UNIX
@@ -42,15 +45,27 @@ public:
 
     virtual bool removeRecursive(const QString &fileOrDir) = 0;
     virtual bool setOwnerAndPermissionsRecursive(const QString &fileOrDir, uid_t user, gid_t group, mode_t permissions) = 0;
+    // same as above, but for a single, already opened file or directory (fchown/fchmod)
+    virtual bool setOwnerAndPermissions(int fd, uid_t user, gid_t group, mode_t permissions) = 0;
 
 protected:
     enum MessageType { Request, Reply };
+    enum Function : quint8 {
+        RemoveRecursive = 1,
+        SetOwnerAndPermissionsRecursive,
+        SetOwnerAndPermissions,
+        StopServer
+    };
 
 #ifdef Q_OS_LINUX
-    QByteArray receiveMessage(int socket, MessageType type, QString *errorString);
-    bool sendMessage(int socket, const QByteArray &msg, MessageType type, const QString &errorString = QString());
+    // Every message is a single datagram: "RQST" or "RPLY", followed by the request id, the error
+    // string and the payload. A reply carries the id of its request, so any number of requests
+    // can be in flight at the same time. A file descriptor can optionally be passed along with a
+    // message (SCM_RIGHTS).
+    QByteArray receiveMessage(int socket, MessageType type, quint32 *id, QString *errorString, int *fd = nullptr);
+    bool sendMessage(int socket, quint32 id, const QByteArray &msg, MessageType type,
+                     const QString &errorString = QString(), int fd = -1);
 #endif
-    QByteArray receive(const QByteArray &packet);
 
 protected:
     SudoInterface();
@@ -71,6 +86,15 @@ public:
 
     bool removeRecursive(const QString &fileOrDir) override;
     bool setOwnerAndPermissionsRecursive(const QString &fileOrDir, uid_t user, gid_t group, mode_t permissions) override;
+    bool setOwnerAndPermissions(int fd, uid_t user, gid_t group, mode_t permissions) override;
+
+    // Pipelining: these only send the request and return its id right away. The result has to
+    // be collected via waitForReply(), so many operations can be in flight at the same time,
+    // without a full round trip to the SudoServer for each of them.
+    quint32 submitRemoveRecursive(const QString &fileOrDir);
+    quint32 submitSetOwnerAndPermissionsRecursive(const QString &fileOrDir, uid_t user, gid_t group, mode_t permissions);
+    quint32 submitSetOwnerAndPermissions(int fd, uid_t user, gid_t group, mode_t permissions);
+    bool waitForReply(quint32 requestId, QString *errorString = nullptr);
 
     void stopServer();
 
@@ -79,11 +103,27 @@ public:
 private:
     SudoClient(int socketFd);
 
-    QByteArray call(const QByteArray &msg);
+    template <typename ...Ps> static QByteArray request(Function function, const Ps &...params);
+    quint32 submit(const QByteArray &msg, int fd = -1);
+    bool receiveReply(QMutexLocker<QMutex> &locker);
+
+    struct ReplyData
+    {
+        QByteArray result;
+        QString errorString;
+    };
+
+    static constexpr int MaxRequestsInFlight = 64;
 
     int m_socket;
     QString m_errorString;
     QMutex m_mutex;
+    QWaitCondition m_replyReceived;
+    quint32 m_nextRequestId = 1;
+    int m_requestsInFlight = 0;
+    bool m_receiving = false;
+    QHash<quint32, ReplyData> m_replies;
+    QSet<quint32> m_pendingIds; // submitted, but not collected via waitForReply() yet
     SudoServer *m_shortCircuit;
 
     static SudoClient *s_instance;
@@ -98,6 +138,7 @@ public:
 
     bool removeRecursive(const QString &fileOrDir) override;
     bool setOwnerAndPermissionsRecursive(const QString &fileOrDir, uid_t user, gid_t group, mode_t permissions) override;
+    bool setOwnerAndPermissions(int fd, uid_t user, gid_t group, mode_t permissions) override;
 
     QString lastError() const { return m_errorString; }
 
@@ -106,12 +147,13 @@ public:
 private:
     SudoServer(int socketFd);
 
-    QByteArray receive(const QByteArray &msg);
+    // thread-safe: used for concurrent requests in run() as well as by a short-circuited client
+    static QByteArray execute(const QByteArray &msg, int fd, QString *errorString);
+    static QString requestPath(const QByteArray &msg, bool *isStop = nullptr);
     friend class SudoClient;
 
     int m_socket;
     QString m_errorString;
-    bool m_stop = false;
 
     static SudoServer *s_instance;
 };
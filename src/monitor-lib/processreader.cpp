@@ -3,10 +3,12 @@
 // Copyright (C) 2018 Pelagicore AG
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
+#include <QFile>
 #include <QMutexLocker>
 #include "processreader.h"
 
 #include "logging.h"
+#include "systemreader.h"
 
 #if defined(Q_OS_MACOS)
 #  include <mach/mach.h>
@@ -21,6 +23,10 @@ void ProcessReader::setProcessId(qint64 pid)
     m_pid = pid;
     if (pid)
         openCpuLoad();
+#if defined(Q_OS_LINUX)
+    m_groupPath.clear();
+    m_gpuReader.setProcessId(pid);
+#endif
 }
 
 void ProcessReader::enableMemoryReporting(bool enabled)
@@ -30,19 +36,56 @@ void ProcessReader::enableMemoryReporting(bool enabled)
         memory = Memory();
 }
 
+void ProcessReader::enableControlGroupAccounting(bool enabled)
+{
+    m_controlGroupAccountingEnabled = enabled;
+    if (!m_controlGroupAccountingEnabled) {
+        QMutexLocker locker(&mutex);
+        controlGroup = ControlGroup();
+    }
+}
+
 void ProcessReader::update()
 {
-    qreal load = readCpuLoad();
+    qreal load = 0;
+    ControlGroup group;
+
+#if defined(Q_OS_LINUX)
+    // the control group covers all the processes of an application (including helpers and
+    // children), so we report its CPU load instead of the one of the main process
+    if (m_controlGroupAccountingEnabled && openControlGroup()) {
+        load = readControlGroupCpuLoad();
+        group.valid = readControlGroupMemory(group);
+    } else
+#endif
+    {
+        load = readCpuLoad();
+    }
+
+    qreal gpu = 0;
+    quint64 gpuMem = 0;
+#if defined(Q_OS_LINUX)
+    if (m_pid) {
+        gpu = m_gpuReader.readLoadValue();
+        gpuMem = m_gpuReader.memoryUsed();
+    }
+#endif
 
     if (m_memoryReportingEnabled) {
         Memory mem;
         bool memRead = readMemory(mem);
         QMutexLocker locker(&mutex);
         memory = memRead ? mem : Memory();
+        controlGroup = group;
         cpuLoad = load;
+        gpuLoad = gpu;
+        gpuMemory = gpuMem;
     } else {
         QMutexLocker locker(&mutex);
+        controlGroup = group;
         cpuLoad = load;
+        gpuLoad = gpu;
+        gpuMemory = gpuMem;
     }
 
     emit updated();
@@ -274,6 +317,177 @@ bool ProcessReader::testReadSmaps(const QByteArray &smapsFile)
     return readSmaps(smapsFile, memory);
 }
 
+bool ProcessReader::openControlGroup()
+{
+    if (!m_pid)
+        return false;
+
+    // the process might have been moved to another group since the last update, but reading
+    // /proc/$PID/cgroup is still a lot cheaper than walking the smaps
+    const bool v2 = isCGroupV2();
+    const auto groups = fetchCGroupProcessInfo(m_pid);
+    const QByteArray path = groups.value(v2 ? QByteArray() : QByteArray("memory"));
+
+    // in the root group we would be accounting for the whole system
+    if (path.isEmpty() || path == "/") {
+        m_groupPath.clear();
+        return false;
+    }
+    if (path != m_groupPath) {
+        m_groupPath = path;
+        m_groupV2 = v2;
+        m_groupShared = false;
+        const QByteArray baseDir = cGroupBaseDir().toLocal8Bit();
+        if (v2) {
+            const QByteArray groupDir = baseDir + path.mid(1) + '/';
+            m_groupMemoryCurrentReader.reset(new SysFsReader(groupDir + "memory.current", 32));
+            m_groupMemoryStatReader.reset(new SysFsReader(groupDir + "memory.stat", 4096));
+            m_groupProcsReader.reset(new SysFsReader(groupDir + "cgroup.procs", 4096));
+            m_groupCpuReader.reset(new SysFsReader(groupDir + "cpu.stat", 512));
+        } else {
+            const QByteArray memoryDir = baseDir + "memory" + path + '/';
+            m_groupMemoryCurrentReader.reset(new SysFsReader(memoryDir + "memory.usage_in_bytes", 32));
+            m_groupMemoryStatReader.reset(new SysFsReader(memoryDir + "memory.stat", 4096));
+            m_groupProcsReader.reset(new SysFsReader(memoryDir + "cgroup.procs", 4096));
+            QByteArray cpuPath = groups.value("cpu,cpuacct", groups.value("cpuacct"));
+            if (!cpuPath.isEmpty())
+                m_groupCpuReader.reset(new SysFsReader(baseDir + "cpuacct" + cpuPath + "/cpuacct.usage", 32));
+            else
+                m_groupCpuReader.reset();
+        }
+        m_lastGroupCpuUsage = 0;
+        m_groupElapsedTime.invalidate();
+
+        if (!m_groupMemoryCurrentReader->isOpen()) {
+            qCWarning(LogSystem) << "Cannot read the memory usage of control group" << path
+                                 << "- falling back to per-process accounting";
+            return false;
+        }
+    } else if (!m_groupMemoryCurrentReader || !m_groupMemoryCurrentReader->isOpen()) {
+        return false;
+    }
+
+    // The cgroup v1 mappings of the containers typically put all the applications of a class
+    // into the same group: its totals are not the application's, so they are not reported at all.
+    // The membership has to be checked on every update, as other applications can join any time.
+    const bool shared = !isControlGroupDedicated();
+    if (shared && !m_groupShared) {
+        qCWarning(LogSystem) << "Control group" << path << "is shared with other processes than"
+                             << m_pid << "and its children - falling back to per-process accounting";
+    }
+    m_groupShared = shared;
+    return !shared;
+}
+
+// returns -1, if the process does not exist (anymore)
+static qint64 parentProcessId(qint64 pid)
+{
+    QFile file(qSL("%1/proc/%2/stat").arg(g_systemRootDir).arg(pid));
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    // the process name is in parentheses, but may contain blanks and parentheses itself
+    const QByteArray stat = file.read(512);
+    const int pos = stat.lastIndexOf(')');
+    if (pos < 0)
+        return -1;
+    const QList<QByteArray> fields = stat.mid(pos + 2).split(' '); // state, ppid, ...
+    return (fields.size() >= 2) ? fields.at(1).toLongLong() : -1;
+}
+
+bool ProcessReader::isControlGroupDedicated() const
+{
+    if (!m_groupProcsReader || !m_groupProcsReader->isOpen())
+        return false;
+
+    const QList<QByteArray> procs = m_groupProcsReader->readValue().split('\n');
+    for (const QByteArray &proc : procs) {
+        qint64 pid = proc.toLongLong();
+        if (pid <= 0)
+            continue;
+
+        // every process in the group has to be the application itself or one of its descendants
+        // (the depth limit is just a safe-guard against bogus data)
+        int depth = 0;
+        while ((pid > 1) && (pid != m_pid) && (++depth < 64))
+            pid = parentProcessId(pid);
+        // processes that exited in the meantime do not count
+        if ((pid != m_pid) && (pid >= 0))
+            return false;
+    }
+    return true;
+}
+
+static quint64 controlGroupStatValue(const QByteArray &stat, const QByteArray &key)
+{
+    // the key has to be matched at the start of a line (e.g. "anon" vs. "active_anon")
+    int pos = stat.startsWith(key + ' ') ? 0 : stat.indexOf('\n' + key + ' ');
+    if (pos < 0)
+        return 0;
+    if (pos > 0)
+        ++pos;
+    return ::strtoull(stat.constData() + pos + key.size() + 1, nullptr, 10);
+}
+
+qreal ProcessReader::readControlGroupCpuLoad()
+{
+    if (!m_groupCpuReader || !m_groupCpuReader->isOpen())
+        return 0.0;
+
+    qint64 elapsed;
+    if (m_groupElapsedTime.isValid()) {
+        elapsed = m_groupElapsedTime.restart();
+    } else {
+        elapsed = 0;
+        m_groupElapsedTime.start();
+    }
+
+    const QByteArray str = m_groupCpuReader->readValue();
+    quint64 usage = m_groupV2 ? controlGroupStatValue(str, "usage_usec")
+                              : (::strtoull(str.constData(), nullptr, 10) / 1000); // nsecs in v1
+
+    qreal load = (elapsed != 0 && usage >= m_lastGroupCpuUsage)
+            ? ((usage - m_lastGroupCpuUsage) / 1000.0 / elapsed) : 0.0;
+    m_lastGroupCpuUsage = usage;
+    return load;
+}
+
+bool ProcessReader::readControlGroupMemory(ControlGroup &group)
+{
+    if (!m_groupMemoryCurrentReader || !m_groupMemoryCurrentReader->isOpen())
+        return false;
+
+    group.memoryTotal = ::strtoull(m_groupMemoryCurrentReader->readValue().constData(), nullptr, 10);
+
+    if (m_groupMemoryStatReader->isOpen()) {
+        const QByteArray stat = m_groupMemoryStatReader->readValue();
+        if (m_groupV2) {
+            group.memoryAnon = controlGroupStatValue(stat, "anon");
+            group.memoryFile = controlGroupStatValue(stat, "file");
+            group.memoryShmem = controlGroupStatValue(stat, "shmem");
+            group.memoryKernel = controlGroupStatValue(stat, "kernel");
+            if (!group.memoryKernel) { // only available since Linux 5.18
+                group.memoryKernel = controlGroupStatValue(stat, "kernel_stack")
+                        + controlGroupStatValue(stat, "slab");
+            }
+        } else {
+            group.memoryAnon = controlGroupStatValue(stat, "total_rss");
+            group.memoryFile = controlGroupStatValue(stat, "total_cache");
+            group.memoryShmem = controlGroupStatValue(stat, "total_shmem");
+        }
+    }
+    return true;
+}
+
+bool ProcessReader::testReadControlGroup(qint64 pid)
+{
+    m_pid = pid;
+    m_groupPath.clear();
+    controlGroup = ControlGroup();
+    controlGroup.valid = openControlGroup() && readControlGroupMemory(controlGroup);
+    return controlGroup.valid;
+}
+
 #elif defined(Q_OS_MACOS)
 
 void ProcessReader::openCpuLoad()
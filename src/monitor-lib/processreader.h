@@ -14,6 +14,7 @@
 #if defined(Q_OS_LINUX)
 #  include <memory>
 #  include <QtAppManMonitor/sysfsreader.h>
+#  include <QtAppManMonitor/systemreader.h>
 #endif
 
 QT_BEGIN_NAMESPACE_AM
@@ -24,6 +25,8 @@ class ProcessReader : public QObject {
 public:
     QMutex mutex;
     qreal cpuLoad;
+    qreal gpuLoad = 0;
+    quint64 gpuMemory = 0; // bytes
     struct Memory {
         quint32 totalVm = 0;
         quint32 totalRss = 0;
@@ -35,16 +38,27 @@ public:
         quint32 heapRss = 0;
         quint32 heapPss = 0;
     } memory;
+    // aggregated over all processes in the control group, in bytes
+    struct ControlGroup {
+        bool valid = false;
+        quint64 memoryTotal = 0;
+        quint64 memoryAnon = 0;
+        quint64 memoryFile = 0;
+        quint64 memoryKernel = 0;
+        quint64 memoryShmem = 0;
+    } controlGroup;
 
 #if defined(Q_OS_LINUX)
     // solely for testing purposes
     bool testReadSmaps(const QByteArray &smapsFile);
+    bool testReadControlGroup(qint64 pid);
 #endif
 
 public slots:
     void update();
     void setProcessId(qint64 pid);
     void enableMemoryReporting(bool enabled);
+    void enableControlGroupAccounting(bool enabled);
 
 signals:
     void updated();
@@ -56,14 +70,30 @@ private:
 
 #if defined(Q_OS_LINUX)
     bool readSmaps(const QByteArray &smapsFile, Memory &mem);
+    bool openControlGroup();
+    bool isControlGroupDedicated() const;
+    qreal readControlGroupCpuLoad();
+    bool readControlGroupMemory(ControlGroup &group);
 
     std::unique_ptr<SysFsReader> m_statReader;
     QElapsedTimer m_elapsedTime;
     quint64 m_lastCpuUsage = 0.0;
+    DrmFdInfoReader m_gpuReader;
+
+    QByteArray m_groupPath;
+    bool m_groupV2 = false;
+    bool m_groupShared = false; // shared with processes of other applications
+    std::unique_ptr<SysFsReader> m_groupMemoryCurrentReader;
+    std::unique_ptr<SysFsReader> m_groupMemoryStatReader;
+    std::unique_ptr<SysFsReader> m_groupProcsReader;
+    std::unique_ptr<SysFsReader> m_groupCpuReader;
+    QElapsedTimer m_groupElapsedTime;
+    quint64 m_lastGroupCpuUsage = 0; // usecs
 #endif
 
     qint64 m_pid = 0;
     bool m_memoryReportingEnabled = true;
+    bool m_controlGroupAccountingEnabled = false;
 };
 
 QT_END_NAMESPACE_AM
@@ -30,8 +30,10 @@ QT_END_NAMESPACE_AM
 #  include "sysfsreader.h"
 #  include <qplatformdefs.h>
 #  include <QElapsedTimer>
+#  include <QDir>
 #  include <QFile>
 #  include <QSocketNotifier>
+#  include <QTimer>
 #  include <QProcess>
 #  include <QCoreApplication>
 #  include <QAtomicInteger>
@@ -263,6 +265,195 @@ private:
     qreal m_lastValue = 0;
 };
 
+static quint64 parseDrmMemory(const char *value)
+{
+    char *endPtr = nullptr;
+    quint64 memory = ::strtoull(value, &endPtr, 10);
+    while (isblank(*endPtr))
+        ++endPtr;
+    if (!qstrncmp(endPtr, "KiB", 3))
+        memory <<= 10;
+    else if (!qstrncmp(endPtr, "MiB", 3))
+        memory <<= 20;
+    else if (!qstrncmp(endPtr, "GiB", 3))
+        memory <<= 30;
+    return memory;
+}
+
+DrmFdInfoReader::DrmFdInfoReader(qint64 pid)
+    : m_pid(pid)
+{ }
+
+void DrmFdInfoReader::setProcessId(qint64 pid)
+{
+    m_pid = pid;
+    m_lastEngineTime.clear();
+    m_elapsedTime.invalidate();
+    m_drmFdInfos.clear();
+    m_readsUntilRescan = 0;
+}
+
+bool DrmFdInfoReader::parseFdInfo(const QByteArray &fdInfo, Client &client)
+{
+    // drm-driver:  i915
+    // drm-client-id:  7
+    // drm-engine-render:  5231263000 ns
+    // drm-engine-capacity-video:  2
+    // drm-resident-system0:  32768 KiB
+    bool isDrm = false;
+    bool hasResident = false;
+    quint64 residentMemory = 0;
+    quint64 legacyMemory = 0;
+
+    for (const QByteArray &line : fdInfo.split('\n')) {
+        if (!line.startsWith("drm-"))
+            continue;
+        int colon = line.indexOf(':');
+        if (colon < 0)
+            continue;
+
+        const QByteArray key = line.left(colon);
+        const char *value = line.constData() + colon + 1;
+
+        if (key == "drm-client-id") {
+            client.id = QByteArray(value).trimmed();
+            isDrm = true;
+        } else if (key == "drm-pdev") {
+            client.device = QByteArray(value).trimmed();
+        } else if (key.startsWith("drm-engine-capacity-")) {
+            client.engineCapacity.insert(key.mid(20), int(::strtol(value, nullptr, 10)));
+        } else if (key.startsWith("drm-engine-")) {
+            client.engineTime.insert(key.mid(11), ::strtoull(value, nullptr, 10));
+        } else if (key.startsWith("drm-resident-")) {
+            hasResident = true;
+            residentMemory += parseDrmMemory(value);
+        } else if (key.startsWith("drm-memory-")) {
+            legacyMemory += parseDrmMemory(value);
+        }
+    }
+    client.memory = hasResident ? residentMemory : legacyMemory;
+    return isDrm;
+}
+
+void DrmFdInfoReader::scanProcess(qint64 pid, QHash<QByteArray, Client> &clients)
+{
+    const QString procDir = g_systemRootDir + qSL("/proc/") + QString::number(pid);
+    const QDir fdInfoDir(procDir + qSL("/fdinfo"));
+    const QStringList fds = fdInfoDir.entryList(QDir::Files);
+    QStringList drmFdInfos;
+
+    for (const QString &fd : fds) {
+        // only read the fdinfo of DRM device nodes: a readlink is a lot cheaper than parsing
+        // the fdinfo of every socket and file
+        const QString target = QFile::symLinkTarget(procDir + qSL("/fd/") + fd);
+        if (!target.isEmpty() && !target.startsWith(qSL("/dev/dri/")))
+            continue;
+
+        const QString fdInfoPath = fdInfoDir.absoluteFilePath(fd);
+        if (readClient(fdInfoPath, clients))
+            drmFdInfos << fdInfoPath;
+    }
+    if (!drmFdInfos.isEmpty())
+        m_drmFdInfos.insert(pid, drmFdInfos);
+}
+
+bool DrmFdInfoReader::readClient(const QString &fdInfoPath, QHash<QByteArray, Client> &clients)
+{
+    QFile file(fdInfoPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    Client client;
+    if (!parseFdInfo(file.read(4096), client) || client.id.isEmpty())
+        return false;
+
+    // duplicated and inherited file descriptors share the same client
+    clients.insert(client.device + ':' + client.id, client);
+    return true;
+}
+
+qreal DrmFdInfoReader::readLoadValue()
+{
+    QHash<QByteArray, Client> clients;
+
+    if (--m_readsUntilRescan < 0) {
+        m_readsUntilRescan = RescanInterval - 1;
+        m_drmFdInfos.clear();
+
+        if (m_pid) {
+            scanProcess(m_pid, clients);
+        } else {
+            const QStringList pids = QDir(g_systemRootDir + qSL("/proc")).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+            for (const QString &pidStr : pids) {
+                bool ok = false;
+                qint64 pid = pidStr.toLongLong(&ok);
+                if (ok)
+                    scanProcess(pid, clients);
+            }
+        }
+    } else {
+        for (const QStringList &fdInfos : qAsConst(m_drmFdInfos)) {
+            for (const QString &fdInfo : fdInfos) {
+                // the process exited or closed (or reused) the fd: find out on the next read
+                if (!readClient(fdInfo, clients))
+                    m_readsUntilRescan = 0;
+            }
+        }
+    }
+
+    qint64 elapsed = 0;
+    if (m_elapsedTime.isValid())
+        elapsed = m_elapsedTime.nsecsElapsed();
+    m_elapsedTime.start();
+
+    QHash<QByteArray, quint64> engineTime;
+    QHash<QByteArray, quint64> busyTime;
+    QHash<QByteArray, int> capacity;
+    quint64 memory = 0;
+
+    for (auto it = clients.cbegin(); it != clients.cend(); ++it) {
+        memory += it->memory;
+        for (auto engine = it->engineTime.cbegin(); engine != it->engineTime.cend(); ++engine) {
+            const QByteArray key = it.key() + '/' + engine.key();
+            engineTime.insert(key, engine.value());
+
+            // clients that were not around for the last read are only used as a baseline
+            auto last = m_lastEngineTime.constFind(key);
+            if ((last != m_lastEngineTime.cend()) && (engine.value() >= *last))
+                busyTime[engine.key()] += engine.value() - *last;
+            capacity[engine.key()] = qMax(capacity.value(engine.key(), 1),
+                                          it->engineCapacity.value(engine.key(), 1));
+        }
+    }
+
+    m_hasEngineStatistics = !engineTime.isEmpty();
+    m_lastEngineTime = engineTime;
+    m_memoryUsed = memory;
+    m_clientCount = clients.size();
+
+    qreal load = 0;
+    if (elapsed > 0) {
+        for (auto it = busyTime.cbegin(); it != busyTime.cend(); ++it)
+            load = qMax(load, qreal(it.value()) / (qreal(elapsed) * capacity.value(it.key(), 1)));
+    }
+    return qMin(load, qreal(1));
+}
+
+quint64 DrmFdInfoReader::memoryUsed() const
+{
+    return m_memoryUsed;
+}
+
+int DrmFdInfoReader::clientCount() const
+{
+    return m_clientCount;
+}
+
+bool DrmFdInfoReader::hasEngineStatistics() const
+{
+    return m_hasEngineStatistics;
+}
+
 GpuTool *GpuReader::s_gpuToolProcess = nullptr;
 
 GpuReader::GpuReader()
@@ -270,6 +461,22 @@ GpuReader::GpuReader()
 
 void GpuReader::setActive(bool enabled)
 {
+    // the DRM fdinfo is available for most open source drivers since Linux 5.19: this does not
+    // need an extra process and also works for GPUs that are not supported by the vendor tools
+    if (m_drmReader) {
+        if (!enabled)
+            m_drmReader.reset();
+        return;
+    }
+    if (enabled && !m_toolActive) {
+        std::unique_ptr<DrmFdInfoReader> drmReader(new DrmFdInfoReader);
+        drmReader->readLoadValue(); // also establishes the baseline
+        if (drmReader->hasEngineStatistics()) {
+            m_drmReader = std::move(drmReader);
+            return;
+        }
+    }
+
     if (!s_gpuToolProcess)
         s_gpuToolProcess = new GpuTool();
 
@@ -280,29 +487,198 @@ void GpuReader::setActive(bool enabled)
             s_gpuToolProcess->ref();
         else
             s_gpuToolProcess->deref();
+        m_toolActive = enabled;
     }
 }
 
 bool GpuReader::isActive() const
 {
+    if (m_drmReader)
+        return true;
     return s_gpuToolProcess ? s_gpuToolProcess->isRunning() : false;
 }
 
 qreal GpuReader::readLoadValue()
 {
+    if (m_drmReader)
+        return m_drmReader->readLoadValue();
     return s_gpuToolProcess ? s_gpuToolProcess->loadValue() : -1;
 }
 
+quint64 GpuReader::memoryUsed() const
+{
+    return m_drmReader ? m_drmReader->memoryUsed() : 0;
+}
+
+PressureReader::PressureReader(Resource resource)
+{
+    static const char *names[] = { "cpu", "memory", "io" };
+    const QByteArray path = g_systemRootDir.toLocal8Bit() + "/proc/pressure/" + names[resource];
+
+    m_sysFs.reset(new SysFsReader(path, 256));
+    if (!m_sysFs->isOpen())
+        qCDebug(LogSystem) << "Pressure stall information is not available at" << path << "(is CONFIG_PSI enabled?)";
+}
+
+bool PressureReader::isAvailable() const
+{
+    return m_sysFs->isOpen();
+}
+
+PressureReader::Values PressureReader::readValues()
+{
+    // some avg10=0.12 avg60=0.05 avg300=0.01 total=123456
+    // full avg10=0.00 avg60=0.00 avg300=0.00 total=2345
+    Values v;
+    if (!m_sysFs->isOpen())
+        return v;
+
+    const QByteArray str = m_sysFs->readValue();
+    quint64 someTotal = 0;
+    quint64 fullTotal = 0;
+
+    for (const QByteArray &line : str.split('\n')) {
+        const bool some = line.startsWith("some ");
+        const bool full = line.startsWith("full ");
+        if (!some && !full)
+            continue;
+
+        qreal avg10 = 0;
+        quint64 total = 0;
+        int pos = line.indexOf("avg10=");
+        if (pos >= 0)
+            avg10 = ::strtod(line.constData() + pos + 6, nullptr) / 100.0;
+        pos = line.indexOf("total=");
+        if (pos >= 0)
+            total = ::strtoull(line.constData() + pos + 6, nullptr, 10);
+
+        if (some) {
+            v.someAvg10 = avg10;
+            someTotal = total;
+        } else {
+            v.fullAvg10 = avg10;
+            fullTotal = total;
+        }
+    }
+
+    if (!m_firstRead) {
+        v.someDelta = (someTotal >= m_lastSomeTotal) ? (someTotal - m_lastSomeTotal) : 0;
+        v.fullDelta = (fullTotal >= m_lastFullTotal) ? (fullTotal - m_lastFullTotal) : 0;
+    }
+    m_lastSomeTotal = someTotal;
+    m_lastFullTotal = fullTotal;
+    m_firstRead = false;
+    return v;
+}
+
+CpuCoresReader::CpuCoresReader()
+{
+    const QByteArray statPath = g_systemRootDir.toLocal8Bit() + "/proc/stat";
+
+    // the number of cores known to the kernel might differ from the number of cores we can use
+    QFile stat(QString::fromLocal8Bit(statPath));
+    if (stat.open(QIODevice::ReadOnly)) {
+        char line[256];
+        while ((stat.readLine(line, sizeof(line)) > 0) && !qstrncmp(line, "cpu", 3)) {
+            if (isdigit(line[3]))
+                m_coreCount = qMax(m_coreCount, int(::strtol(line + 3, nullptr, 10)) + 1);
+        }
+    }
+
+    // the per-core lines are at the start of /proc/stat, so there is no need to read the whole file
+    m_statReader.reset(new SysFsReader(statPath, 128 * (m_coreCount + 1)));
+    if (!m_statReader->isOpen())
+        qCWarning(LogSystem) << "WARNING: could not read CPU statistics from" << m_statReader->fileName();
+
+    m_lastIdle.fill(0, m_coreCount);
+    m_lastTotal.fill(0, m_coreCount);
+
+    for (int core = 0; core < m_coreCount; ++core) {
+        m_frequencyReaders.emplace_back(new SysFsReader(g_systemRootDir.toLocal8Bit()
+                                                        + "/sys/devices/system/cpu/cpu" + QByteArray::number(core)
+                                                        + "/cpufreq/scaling_cur_freq", 32));
+    }
+}
+
+int CpuCoresReader::coreCount() const
+{
+    return m_coreCount;
+}
+
+QVector<qreal> CpuCoresReader::readLoadValues()
+{
+    // cpu0 user nice system idle iowait irq softirq steal guest guest_nice
+    QVector<qreal> loads(m_coreCount, qreal(0));
+    const QByteArray str = m_statReader->readValue();
+
+    for (const QByteArray &line : str.split('\n')) {
+        if (!line.startsWith("cpu") || (line.size() <= 3) || !isdigit(line.at(3)))
+            continue;
+
+        char *endPtr = nullptr;
+        int core = int(::strtol(line.constData() + 3, &endPtr, 10));
+        if (core < 0 || core >= m_coreCount)
+            continue;
+
+        qint64 values[8] = { };
+        for (int i = 0; i < 8; ++i)
+            values[i] = ::strtoll(endPtr, &endPtr, 10);
+
+        // guest times are already accounted for in user and nice
+        qint64 total = 0;
+        for (qint64 value : values)
+            total += value;
+        qint64 idle = values[3] + values[4]; // idle + iowait
+
+        if (total > m_lastTotal.at(core)) {
+            loads[core] = qreal(1) - (qreal(idle - m_lastIdle.at(core))
+                                      / qreal(total - m_lastTotal.at(core)));
+        }
+        m_lastIdle[core] = idle;
+        m_lastTotal[core] = total;
+    }
+    return loads;
+}
+
+QVector<qreal> CpuCoresReader::readFrequencies()
+{
+    QVector<qreal> frequencies(m_coreCount, qreal(0));
+    for (int core = 0; core < m_coreCount; ++core) {
+        const auto &reader = m_frequencyReaders.at(size_t(core));
+        if (reader->isOpen())
+            frequencies[core] = ::strtoull(reader->readValue(), nullptr, 10) / qreal(1000); // kHz
+    }
+    return frequencies;
+}
+
 // TODO: can we always expect cgroup FS to be mounted on /sys/fs/cgroup?
 static const QString cGroupsMemoryBaseDir = qSL("/sys/fs/cgroup/memory/");
 
+QString cGroupBaseDir()
+{
+    return g_systemRootDir + qSL("/sys/fs/cgroup/");
+}
+
+bool isCGroupV2()
+{
+    // the root of the unified hierarchy is the only place where this file exists
+    return QFile::exists(cGroupBaseDir() + qSL("cgroup.controllers"));
+}
+
 MemoryReader::MemoryReader() : MemoryReader(QString())
 { }
 
 MemoryReader::MemoryReader(const QString &groupPath)
     : m_groupPath(groupPath)
+    , m_cgroupV2(isCGroupV2())
 {
-    const QString path = g_systemRootDir + cGroupsMemoryBaseDir + m_groupPath + qSL("/memory.stat");
+    QString path;
+    if (!m_cgroupV2)
+        path = g_systemRootDir + cGroupsMemoryBaseDir + m_groupPath + qSL("/memory.stat");
+    else if (m_groupPath.isEmpty()) // the v2 root group has no memory.stat
+        path = g_systemRootDir + qSL("/proc/meminfo");
+    else
+        path = cGroupBaseDir() + m_groupPath + qSL("/memory.stat");
 
     m_sysFs.reset(new SysFsReader(path.toLocal8Bit(), 1500));
     if (!m_sysFs->isOpen()) {
@@ -326,19 +702,45 @@ MemoryReader::MemoryReader(const QString &groupPath)
 
 quint64 MemoryReader::groupLimit()
 {
-    QString path = g_systemRootDir + cGroupsMemoryBaseDir + m_groupPath + qSL("/memory.limit_in_bytes");
-    QByteArray ba = SysFsReader(path.toLocal8Bit(), 41).readValue();
-    return ::strtoull(ba, nullptr, 10);
+    if (!m_cgroupV2) {
+        QString path = g_systemRootDir + cGroupsMemoryBaseDir + m_groupPath + qSL("/memory.limit_in_bytes");
+        QByteArray ba = SysFsReader(path.toLocal8Bit(), 41).readValue();
+        return ::strtoull(ba, nullptr, 10);
+    }
+
+    // memory.max is the hard limit, but the kernel already starts to throttle at memory.high
+    for (const char *limitFile : { "/memory.high", "/memory.max" }) {
+        QString path = cGroupBaseDir() + m_groupPath + qL1S(limitFile);
+        QByteArray ba = SysFsReader(path.toLocal8Bit(), 41).readValue();
+        if (!ba.isEmpty() && isdigit(ba.at(0)))
+            return ::strtoull(ba, nullptr, 10);
+    }
+    return totalValue(); // both are set to "max"
 }
 
 quint64 MemoryReader::readUsedValue() const
 {
     QByteArray buffer = m_sysFs->readValue();
 
-    int i = buffer.indexOf("total_rss ");
+    if (m_cgroupV2 && m_groupPath.isEmpty()) {
+        // /proc/meminfo
+        auto readKb = [&buffer](const char *key) -> quint64 {
+            int i = buffer.indexOf(key);
+            return (i == -1) ? 0 : ::strtoull(buffer.data() + i + qstrlen(key), nullptr, 10) * 1024;
+        };
+        quint64 total = readKb("MemTotal:");
+        quint64 available = readKb("MemAvailable:");
+        return (available < total) ? (total - available) : 0;
+    }
+
+    // "anon" in v2 corresponds to "total_rss" in v1 (make sure not to match e.g. "active_anon")
+    const QByteArray key = m_cgroupV2 ? "anon " : "total_rss ";
+    int i = buffer.startsWith(key) ? 0 : buffer.indexOf('\n' + key);
+    if (i > 0)
+        ++i;
     if (i == -1)
         return 0;
-    return ::strtoull(buffer.data() + i + sizeof("total_rss ")-1, nullptr, 10);
+    return ::strtoull(buffer.data() + i + key.size(), nullptr, 10);
 }
 
 
@@ -400,6 +802,10 @@ MemoryThreshold::MemoryThreshold(const QList<qreal> &thresholds)
 
 MemoryThreshold::~MemoryThreshold()
 {
+    if (m_eventsFd != -1)
+        QT_CLOSE(m_eventsFd);
+    if (m_pressureFd != -1)
+        QT_CLOSE(m_pressureFd);
     if (m_usageFd != -1)
         QT_CLOSE(m_usageFd);
     if (m_controlFd != -1)
@@ -429,7 +835,9 @@ bool MemoryThreshold::setEnabled(bool enabled, const QString &groupPath, MemoryR
     if (m_enabled == enabled)
         return true;
 
-    if (enabled && !m_initialized) {
+    if (enabled && !m_initialized && isCGroupV2()) {
+        return setEnabledV2(groupPath);
+    } else if (enabled && !m_initialized) {
         quint64 limit = groupPath.isEmpty() ? reader->totalValue() : reader->groupLimit();
         const QString cGroup = cGroupsMemoryBaseDir + groupPath;
 
@@ -480,12 +888,77 @@ bool MemoryThreshold::setEnabled(bool enabled, const QString &groupPath, MemoryR
         return false;
     } else {
         m_enabled = enabled;
-        m_notifier->setEnabled(enabled);
+        if (m_notifier)
+            m_notifier->setEnabled(enabled);
+        if (m_eventsNotifier)
+            m_eventsNotifier->setEnabled(enabled);
+        if (m_pollTimer) {
+            if (enabled)
+                m_pollTimer->start();
+            else
+                m_pollTimer->stop();
+        }
 
         return true;
     }
 }
 
+bool MemoryThreshold::setEnabledV2(const QString &groupPath)
+{
+    // cgroup v2 has no usage thresholds anymore: instead we get notified, whenever the group (or
+    // the whole system) is stalling on memory (PSI) and whenever the group hits its memory.high or
+    // memory.max limits (memory.events). The actual percentages are then checked by the receiver
+    // of thresholdTriggered().
+
+    const QString pressurePath = groupPath.isEmpty() ? g_systemRootDir + qSL("/proc/pressure/memory")
+                                                     : cGroupBaseDir() + groupPath + qSL("/memory.pressure");
+    m_pressureFd = QT_OPEN(pressurePath.toLocal8Bit().constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (m_pressureFd >= 0) {
+        // trigger if tasks are stalled for more than 200ms within a 2sec window (unprivileged
+        // processes are only allowed to use window sizes that are a multiple of 2sec)
+        static const char trigger[] = "some 200000 2000000";
+        if (QT_WRITE(m_pressureFd, trigger, sizeof(trigger)) < 0) {
+            qCWarning(LogSystem) << "Could not register a PSI trigger on" << pressurePath << ":" << strerror(errno);
+            QT_CLOSE(m_pressureFd);
+            m_pressureFd = -1;
+        } else {
+            m_notifier = new QSocketNotifier(m_pressureFd, QSocketNotifier::Exception, this);
+            connect(m_notifier, &QSocketNotifier::activated, this, &MemoryThreshold::thresholdTriggered);
+        }
+    } else {
+        qCWarning(LogSystem) << "Cannot open" << pressurePath << "(is CONFIG_PSI enabled?)";
+    }
+
+    if (!groupPath.isEmpty()) {
+        const QString eventsPath = cGroupBaseDir() + groupPath + qSL("/memory.events");
+        m_eventsFd = QT_OPEN(eventsPath.toLocal8Bit().constData(), QT_OPEN_RDONLY | O_CLOEXEC);
+        if (m_eventsFd >= 0) {
+            char buffer[256];
+            (void) QT_READ(m_eventsFd, buffer, sizeof(buffer)); // arm the notification
+
+            m_eventsNotifier = new QSocketNotifier(m_eventsFd, QSocketNotifier::Exception, this);
+            connect(m_eventsNotifier, &QSocketNotifier::activated, this, [this]() {
+                char buffer[256];
+                if (QT_LSEEK(m_eventsFd, 0, SEEK_SET) == 0)
+                    (void) QT_READ(m_eventsFd, buffer, sizeof(buffer)); // re-arm
+                emit thresholdTriggered();
+            });
+        } else {
+            qCWarning(LogSystem) << "Cannot open" << eventsPath;
+        }
+    }
+
+    if (m_pressureFd < 0) {
+        // without PSI we would only get notified when hitting the hard limits, so we have to poll
+        qCInfo(LogSystem) << "Falling back to polling the memory usage every 2sec";
+        m_pollTimer = new QTimer(this);
+        m_pollTimer->setInterval(2000);
+        connect(m_pollTimer, &QTimer::timeout, this, &MemoryThreshold::thresholdTriggered);
+        m_pollTimer->start();
+    }
+    return m_initialized = m_enabled = true;
+}
+
 void MemoryThreshold::readEventFd()
 {
     if (m_eventFd >= 0) {
@@ -756,6 +1229,11 @@ qreal GpuReader::readLoadValue()
     return 0;
 }
 
+quint64 GpuReader::memoryUsed() const
+{
+    return 0;
+}
+
 IoReader::IoReader(const char *device)
 {
     Q_UNUSED(device)
@@ -6,16 +6,21 @@
 #pragma once
 
 #include <QByteArray>
+#include <QHash>
 #include <QPair>
 #include <QElapsedTimer>
 #include <QObject>
+#include <QStringList>
+#include <QVector>
 #include <QtAppManCommon/global.h>
 
 #include <memory>
+#include <vector>
 
 #if defined(Q_OS_LINUX)
 #  include <QtAppManMonitor/sysfsreader.h>
 QT_FORWARD_DECLARE_CLASS(QSocketNotifier)
+QT_FORWARD_DECLARE_CLASS(QTimer)
 #endif
 
 QT_BEGIN_NAMESPACE_AM
@@ -50,6 +55,53 @@ private:
     static Vendor s_vendor;
 };
 
+#if defined(Q_OS_LINUX)
+// Reads the GPU usage of DRM clients from the fdinfo of their file descriptors, either for a
+// single process or for the whole system (pid 0). See the kernel's Documentation/gpu/drm-usage-stats.rst
+class DrmFdInfoReader
+{
+public:
+    struct Client
+    {
+        QByteArray device;                     // drm-pdev
+        QByteArray id;                         // drm-client-id
+        QHash<QByteArray, quint64> engineTime; // drm-engine-<name>: nsecs
+        QHash<QByteArray, int> engineCapacity; // drm-engine-capacity-<name>
+        quint64 memory = 0;                    // bytes: drm-resident-* or legacy drm-memory-*
+    };
+
+    DrmFdInfoReader(qint64 pid = 0);
+    void setProcessId(qint64 pid);
+
+    // busy time of the busiest engine since the last call, ranging from 0 to 1
+    qreal readLoadValue();
+    // as of the last readLoadValue() call
+    quint64 memoryUsed() const;
+    int clientCount() const;
+    bool hasEngineStatistics() const;
+
+    static bool parseFdInfo(const QByteArray &fdInfo, Client &client);
+
+private:
+    void scanProcess(qint64 pid, QHash<QByteArray, Client> &clients);
+    static bool readClient(const QString &fdInfoPath, QHash<QByteArray, Client> &clients);
+
+    // walking /proc/*/fd is expensive, so the fdinfo paths of the DRM fds are cached per pid
+    // and only rescanned every RescanInterval reads (or whenever a cached fd went away)
+    static constexpr int RescanInterval = 10;
+    QHash<qint64, QStringList> m_drmFdInfos;
+    int m_readsUntilRescan = 0;
+
+    qint64 m_pid = 0;
+    QElapsedTimer m_elapsedTime;
+    QHash<QByteArray, quint64> m_lastEngineTime;
+    quint64 m_memoryUsed = 0;
+    int m_clientCount = 0;
+    bool m_hasEngineStatistics = false;
+    Q_DISABLE_COPY(DrmFdInfoReader)
+};
+#endif
+
 class GpuTool;
 
 class GpuReader
@@ -59,10 +111,13 @@ public:
     void setActive(bool enabled);
     bool isActive() const;
     qreal readLoadValue();
+    quint64 memoryUsed() const; // bytes, 0 if unknown
 
 private:
 #if defined(Q_OS_LINUX)
     static GpuTool *s_gpuToolProcess;
+    std::unique_ptr<DrmFdInfoReader> m_drmReader;
+    bool m_toolActive = false;
 #endif
     Q_DISABLE_COPY(GpuReader)
 };
@@ -84,6 +139,7 @@ private:
 #if defined(Q_OS_LINUX)
     std::unique_ptr<SysFsReader> m_sysFs;
     const QString m_groupPath;
+    bool m_cgroupV2 = false;
 #elif defined(Q_OS_MACOS) || defined(Q_OS_IOS)
     static int s_pageSize;
 #endif
@@ -107,6 +163,52 @@ private:
     Q_DISABLE_COPY(IoReader)
 };
 
+#if defined(Q_OS_LINUX)
+// Reads the kernel's pressure stall information (PSI) from /proc/pressure/{cpu,memory,io}
+class PressureReader
+{
+public:
+    enum Resource { Cpu, Memory, Io };
+
+    struct Values
+    {
+        qreal someAvg10 = 0;      // share of time (0..1) at least one task was stalled
+        qreal fullAvg10 = 0;      // share of time (0..1) all non-idle tasks were stalled
+        quint64 someDelta = 0;    // usecs of "some" stall time since the last read
+        quint64 fullDelta = 0;    // usecs of "full" stall time since the last read
+    };
+
+    PressureReader(Resource resource);
+    bool isAvailable() const;
+    Values readValues();
+
+private:
+    std::unique_ptr<SysFsReader> m_sysFs;
+    quint64 m_lastSomeTotal = 0;
+    quint64 m_lastFullTotal = 0;
+    bool m_firstRead = true;
+    Q_DISABLE_COPY(PressureReader)
+};
+
+// Reads the utilization of each CPU core from /proc/stat and their current frequency from sysfs
+class CpuCoresReader
+{
+public:
+    CpuCoresReader();
+    int coreCount() const;
+    QVector<qreal> readLoadValues();
+    QVector<qreal> readFrequencies(); // MHz, 0 if unknown
+
+private:
+    int m_coreCount = 0;
+    std::unique_ptr<SysFsReader> m_statReader;
+    QVector<qint64> m_lastIdle;
+    QVector<qint64> m_lastTotal;
+    std::vector<std::unique_ptr<SysFsReader>> m_frequencyReaders;
+    Q_DISABLE_COPY(CpuCoresReader)
+};
+#endif
+
 class MemoryThreshold : public QObject
 {
     Q_OBJECT
@@ -135,10 +237,18 @@ private slots:
     void readEventFd();
 
 private:
+    bool setEnabledV2(const QString &groupPath);
+
     int m_eventFd = -1;
     int m_controlFd = -1;
     int m_usageFd = -1;
     QSocketNotifier *m_notifier = nullptr;
+
+    // cgroup v2: PSI trigger on memory.pressure and change notifications on memory.events
+    int m_pressureFd = -1;
+    int m_eventsFd = -1;
+    QSocketNotifier *m_eventsNotifier = nullptr;
+    QTimer *m_pollTimer = nullptr; // fallback, if no PSI trigger could be registered
 #endif
 };
 
@@ -167,6 +277,12 @@ private:
 };
 
 #if defined(Q_OS_LINUX)
+// Returns true, if only the cgroup v2 (unified) hierarchy is mounted on /sys/fs/cgroup
+bool isCGroupV2();
+
+// The mount point of the cgroup hierarchies (v1) or the unified hierarchy (v2)
+QString cGroupBaseDir();
+
 // Parses the file /proc/$PID/cgroup, returning a map groupName->path
 // eg: map["memory"] == "/user.slice"
 QMap<QByteArray, QByteArray> fetchCGroupProcessInfo(qint64 pid);
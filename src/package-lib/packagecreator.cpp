@@ -9,10 +9,18 @@
 #include <QFile>
 #include <QDebug>
 #include <QCryptographicHash>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
 #include <qplatformdefs.h>
 
+#include <deque>
+#include <functional>
+
 #include <archive.h>
 #include <archive_entry.h>
+#include <zlib.h>
 
 #include "packageutilities_p.h"
 #include "packagecreator.h"
@@ -50,6 +58,173 @@ static void fixed_archive_entry_set_pathname(archive_entry *entry, const QString
     delete[] wchars;
 }
 
+/*! \internal
+  Compresses \a data into a complete, self-contained gzip member. The header does not contain a
+  timestamp or platform dependent fields, so the result only depends on the input.
+  Returns a null QByteArray on errors.
+*/
+static QByteArray gzipMember(const QByteArray &data)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16 /* gzip */, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return { };
+    }
+    gz_header header;
+    memset(&header, 0, sizeof(header));
+    header.os = 3; // Unix, just like libarchive's gzip filter
+    deflateSetHeader(&zs, &header);
+
+    QByteArray result(qsizetype(deflateBound(&zs, uLong(data.size()))), Qt::Uninitialized);
+    zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+    zs.avail_in = uInt(data.size());
+    zs.next_out = reinterpret_cast<Bytef *>(result.data());
+    zs.avail_out = uInt(result.size());
+
+    const int ret = deflate(&zs, Z_FINISH);
+    deflateEnd(&zs);
+    if (ret != Z_STREAM_END)
+        return { };
+    result.truncate(qsizetype(zs.total_out));
+    return result;
+}
+
+/*! \internal
+  The uncompressed tar stream generated by libarchive is cut into fixed size blocks, which are
+  compressed in parallel into independent gzip members. These are written to the output in order:
+  concatenated gzip members are a valid gzip stream, which the PackageExtractor (and every other
+  gzip implementation) can read. The block boundaries only depend on the input, so the output is
+  the same, regardless of the number of threads used.
+*/
+class ParallelGzipWriter
+{
+public:
+    static constexpr qsizetype BlockSize = 1024 * 1024;
+
+    ParallelGzipWriter(QIODevice *output, int threadCount)
+        : m_output(output)
+        , m_maxPending(2 * threadCount)
+    {
+        m_pool.setMaxThreadCount(threadCount);
+        m_block.reserve(BlockSize);
+    }
+
+    // called from libarchive: must not throw
+    bool write(const char *data, qsizetype size)
+    {
+        while (size > 0) {
+            const qsizetype chunk = qMin(size, BlockSize - m_block.size());
+            m_block.append(data, chunk);
+            data += chunk;
+            size -= chunk;
+
+            if (m_block.size() == BlockSize) {
+                if (!submitBlock())
+                    return false;
+            }
+        }
+        return !m_failed;
+    }
+
+    bool finish()
+    {
+        if (!m_block.isEmpty() && !submitBlock())
+            return false;
+        while (!m_pending.empty()) {
+            if (!writeNextMember())
+                return false;
+        }
+        return !m_failed;
+    }
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    bool submitBlock()
+    {
+        m_pending.push_back(QtConcurrent::run(&m_pool, gzipMember, m_block));
+        m_block.clear();
+        m_block.reserve(BlockSize);
+
+        // limit the memory usage, in case the output is slower than the compression
+        if (int(m_pending.size()) > m_maxPending)
+            return writeNextMember();
+        return true;
+    }
+
+    bool writeNextMember()
+    {
+        const QByteArray member = m_pending.front().result();
+        m_pending.pop_front();
+
+        if (member.isNull())
+            return fail(qSL("could not compress data"));
+
+        // this could be simpler, if we had an event loop ... but we do not
+        if (m_output->write(member) != member.size())
+            return fail(qSL("could not write to output: %1").arg(m_output->errorString()));
+        m_output->waitForBytesWritten(-1);
+        return true;
+    }
+
+    bool fail(const QString &errorString)
+    {
+        if (!m_failed) {
+            m_failed = true;
+            m_errorString = errorString;
+        }
+        return false;
+    }
+
+    QThreadPool m_pool; // destroyed last: waits for all the running jobs
+    QIODevice *m_output;
+    int m_maxPending;
+    QByteArray m_block;
+    std::deque<QFuture<QByteArray>> m_pending;
+    bool m_failed = false;
+    QString m_errorString;
+};
+
+/*! \internal
+  Calculates the package digest on a separate thread, while the next chunk of data is read and
+  compressed. The jobs are executed strictly in the order they were added.
+*/
+class PipelinedDigest
+{
+public:
+    PipelinedDigest()
+        : m_hash(QCryptographicHash::Sha256)
+    {
+        m_pool.setMaxThreadCount(1);
+    }
+
+    ~PipelinedDigest()
+    {
+        m_pool.waitForDone();
+    }
+
+    void add(const std::function<void(QCryptographicHash &)> &job)
+    {
+        m_budget.acquire();
+        m_pool.start([this, job]() {
+            job(m_hash);
+            m_budget.release();
+        });
+    }
+
+    QByteArray result()
+    {
+        m_pool.waitForDone();
+        return m_hash.result();
+    }
+
+private:
+    QThreadPool m_pool;
+    QCryptographicHash m_hash;
+    QSemaphore m_budget { 32 }; // jobs queued at most
+};
+
 
 PackageCreator::PackageCreator(const QDir &sourceDir, QIODevice *output, const InstallationReport &report, QObject *parent)
     : QObject(parent)
@@ -73,6 +248,20 @@ void PackageCreator::setSourceDirectory(const QDir &sourceDir)
     d->m_sourcePath = sourceDir.absolutePath() + QLatin1Char('/');
 }
 
+/*! \internal
+  The maximum number of threads used to compress the package. The default (0) is to use
+  QThread::idealThreadCount(). The created package is the same, regardless of this setting.
+*/
+int PackageCreator::maximumThreadCount() const
+{
+    return d->m_maximumThreadCount;
+}
+
+void PackageCreator::setMaximumThreadCount(int count)
+{
+    d->m_maximumThreadCount = qMax(0, count);
+}
+
 bool PackageCreator::create()
 {
     if (!wasCanceled())
@@ -134,13 +323,14 @@ PackageCreatorPrivate::PackageCreatorPrivate(PackageCreator *creator, QIODevice
 bool PackageCreatorPrivate::create()
 {
     struct archive *ar = nullptr;
-    char buffer[64 * 1024];
+    const int threadCount = m_maximumThreadCount ? m_maximumThreadCount : qMax(1, QThread::idealThreadCount());
+    ParallelGzipWriter writer(m_output, threadCount);
 
     try {
         if (m_report.packageId().isNull())
             throw Exception("package identifier is null");
 
-        QCryptographicHash digest(QCryptographicHash::Sha256);
+        PipelinedDigest digest;
 
         QVariantMap headerFormat {
             { qSL("formatType"), qSL("am-package-header") },
@@ -156,7 +346,9 @@ bool PackageCreatorPrivate::create()
         if (!m_report.extraSignedMetaData().isEmpty())
             m_metaData[qSL("extraSigned")] = m_report.extraSignedMetaData();
 
-        PackageUtilities::addHeaderDataToDigest(m_metaData, digest);
+        digest.add([metaData = m_metaData](QCryptographicHash &hash) {
+            PackageUtilities::addHeaderDataToDigest(metaData, hash);
+        });
 
         emit q->progress(0);
 
@@ -167,22 +359,22 @@ bool PackageCreatorPrivate::create()
             throw ArchiveException(ar, "could not set the archive format to USTAR");
         if (archive_write_set_options(ar, "hdrcharset=UTF-8") != ARCHIVE_OK)
             throw ArchiveException(ar, "could not set the HDRCHARSET option");
-        if (archive_write_add_filter_gzip(ar) != ARCHIVE_OK)
-            throw ArchiveException(ar, "could not enable GZIP compression");
+        // the GZIP compression is done by the ParallelGzipWriter
+        if (archive_write_add_filter_none(ar) != ARCHIVE_OK)
+            throw ArchiveException(ar, "could not disable the archive filters");
 // disabled for now -- see libarchive.pro
 //        if (archive_write_add_filter_xz(ar) != ARCHIVE_OK)
 //            throw ArchiveException(ar, "could not enable XZ compression");
 
         auto dummyCallback = [](archive *, void *){ return ARCHIVE_OK; };
         auto writeCallback = [](archive *, void *user, const void *buffer, size_t size) {
-            // this could be simpler, if we had an event loop ... but we do not
-            QIODevice *output = reinterpret_cast<QIODevice *>(user);
-            qint64 written = output->write(static_cast<const char *>(buffer), size);
-            output->waitForBytesWritten(-1);
-            return static_cast<__LA_SSIZE_T>(written);
+            auto *writer = reinterpret_cast<ParallelGzipWriter *>(user);
+            if (!writer->write(static_cast<const char *>(buffer), qsizetype(size)))
+                return static_cast<__LA_SSIZE_T>(-1);
+            return static_cast<__LA_SSIZE_T>(size);
         };
 
-        if (archive_write_open(ar, m_output, dummyCallback, writeCallback, dummyCallback) != ARCHIVE_OK)
+        if (archive_write_open(ar, &writer, dummyCallback, writeCallback, dummyCallback) != ARCHIVE_OK)
             throw ArchiveException(ar, "could not open archive.");
 
         // Add the metadata header
@@ -268,15 +460,20 @@ bool PackageCreatorPrivate::create()
                     if (q->wasCanceled())
                         throw Exception(Error::Canceled);
 
-                    qint64 bytesRead = f.read(buffer, sizeof(buffer));
+                    QByteArray buffer(256 * 1024, Qt::Uninitialized);
+                    qint64 bytesRead = f.read(buffer.data(), buffer.size());
                     if (bytesRead < 0)
                         throw Exception(f, "could not read from file");
+                    buffer.truncate(qsizetype(bytesRead));
                     fileSize += bytesRead;
 
-                    if (archive_write_data(ar, buffer, static_cast<size_t>(bytesRead)) == -1)
+                    if (archive_write_data(ar, buffer.constData(), static_cast<size_t>(bytesRead)) == -1) {
+                        if (!writer.errorString().isEmpty())
+                            throw Exception(Error::Archive, "could not write to archive: %1").arg(writer.errorString());
                         throw ArchiveException(ar, "could not write to archive");
+                    }
 
-                    digest.addData({ buffer, qsizetype(bytesRead) });
+                    digest.add([buffer](QCryptographicHash &hash) { hash.addData(buffer); });
                 }
 
                 if (fileSize != fi.size())
@@ -286,7 +483,9 @@ bool PackageCreatorPrivate::create()
             }
 
             // Just to be on the safe side, we also add the file's meta-data to the digest
-            PackageUtilities::addFileMetadataToDigest(file, fi, digest);
+            digest.add([file, fi](QCryptographicHash &hash) {
+                PackageUtilities::addFileMetadataToDigest(file, fi, hash);
+            });
 
             int progress = allFilesSize ? int(packagedSize * 100 / allFilesSize) : 0;
             if (progress != lastProgress ) {
@@ -336,8 +535,12 @@ bool PackageCreatorPrivate::create()
             m_metaData.insert(footerStoreSig);
         }
 
-        if (archive_write_free(ar) != ARCHIVE_OK)
+        if (archive_write_close(ar) != ARCHIVE_OK)
             throw ArchiveException(ar, "could not close archive");
+        if (!writer.finish())
+            throw Exception(Error::Archive, "could not write archive: %1").arg(writer.errorString());
+        archive_write_free(ar);
+        ar = nullptr;
 
 
         emit q->progress(1);
@@ -364,7 +567,7 @@ bool PackageCreatorPrivate::addVirtualFile(struct archive *ar, const QString &fi
         fixed_archive_entry_set_pathname(entry, file);
         archive_entry_set_mode(entry, S_IFREG | S_IREAD);
         archive_entry_set_size(entry, data.size());
-        archive_entry_set_mtime(entry, time(nullptr), 0);
+        archive_entry_set_mtime(entry, 0, 0); // keep the package reproducible
 
         if (archive_write_header(ar, entry) == ARCHIVE_OK) {
             if (archive_write_data(ar, data.constData(), static_cast<size_t>(data.size())) == data.size())
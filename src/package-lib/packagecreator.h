@@ -30,6 +30,9 @@ public:
     QDir sourceDirectory() const;
     void setSourceDirectory(const QDir &sourceDir);
 
+    int maximumThreadCount() const;
+    void setMaximumThreadCount(int count);
+
     bool create();
 
     QByteArray createdDigest() const;
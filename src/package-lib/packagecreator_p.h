@@ -27,6 +27,7 @@ private:
 
     QIODevice *m_output;
     QString m_sourcePath;
+    int m_maximumThreadCount = 0; // 0: QThread::idealThreadCount()
     bool m_failed = false;
     QAtomicInt m_canceled;
     Error m_errorCode = Error::None;
@@ -13,9 +13,15 @@
 #include <QDebug>
 #include <QCryptographicHash>
 
+#include <limits>
+
 #include <archive.h>
 #include <archive_entry.h>
 
+#if defined(Q_OS_LINUX)
+#  include <fcntl.h>
+#endif
+
 #include "packageutilities_p.h"
 #include "packageextractor.h"
 #include "packageextractor_p.h"
@@ -62,6 +68,41 @@ void PackageExtractor::setFileExtractedCallback(const std::function<void(const Q
     d->m_fileExtractedCallback = callback;
 }
 
+/*! \internal
+    The \a callback is called for every file and directory, right after it has been written. For
+    files, the second parameter is the still open file descriptor; it is -1 for directories.
+    This makes it possible to change the owner and permissions of each entry via fchown() and
+    fchmod(), without a second pass over the extracted tree.
+*/
+void PackageExtractor::setEntryWrittenCallback(const std::function<void(const QString &, int)> &callback)
+{
+    d->m_entryWrittenCallback = callback;
+}
+
+quint64 PackageExtractor::writeBandwidthLimit() const
+{
+    return d->m_writeBandwidthLimit;
+}
+
+/*! \internal
+    Limits the rate at which the extracted files are written to \a bytesPerSecond, so that
+    installing a big package does not starve everybody else who needs to access the same storage
+    device. Short bursts are still allowed. A value of \c 0 (the default) disables the limit.
+*/
+void PackageExtractor::setWriteBandwidthLimit(quint64 bytesPerSecond)
+{
+    d->m_writeBandwidthLimit = bytesPerSecond;
+}
+
+/*! \internal
+    Returns the time in milliseconds that extract() was sleeping in order to stay within the
+    writeBandwidthLimit().
+*/
+qint64 PackageExtractor::throttledTime() const
+{
+    return d->m_throttledTime / 1000000;
+}
+
 const InstallationReport &PackageExtractor::installationReport() const
 {
     return d->m_report;
@@ -185,6 +226,42 @@ qint64 PackageExtractorPrivate::readTar(struct archive *ar, const void **archive
     }
 }
 
+void PackageExtractorPrivate::throttle(qint64 bytesWritten)
+{
+    if (!m_writeBandwidthLimit)
+        return;
+
+    const qint64 limit = qint64(qMin(m_writeBandwidthLimit, quint64(std::numeric_limits<int>::max())));
+    // allow bursts of 250ms worth of data, but at least one full read buffer
+    const qint64 burst = qMax(limit / 4, qint64(m_buffer.size()));
+
+    if (!m_throttleClock.isValid()) {
+        m_throttleClock.start();
+        m_throttleLastRefill = 0;
+        m_throttleTokens = burst;
+    } else {
+        const qint64 now = m_throttleClock.nsecsElapsed();
+        // one second is more than enough to completely refill the bucket
+        const qint64 elapsed = qMin(now - m_throttleLastRefill, qint64(1000000000));
+        m_throttleLastRefill = now;
+        m_throttleTokens = qMin(burst, m_throttleTokens + elapsed * limit / 1000000000);
+    }
+
+    m_throttleTokens -= bytesWritten;
+    if (m_throttleTokens >= 0)
+        return;
+
+    // wait until the bucket is not in debt anymore: the next call will refill it
+    qint64 waitTime = -m_throttleTokens * 1000000000 / limit;
+    m_throttledTime += waitTime;
+
+    while ((waitTime > 0) && !q->wasCanceled()) {
+        const qint64 chunk = qMin(waitTime, qint64(100000000)); // stay responsive to cancel()
+        QThread::usleep(static_cast<unsigned long>(chunk / 1000));
+        waitTime -= chunk;
+    }
+}
+
 void PackageExtractorPrivate::extract()
 {
     struct archive *ar = nullptr;
@@ -354,6 +431,7 @@ void PackageExtractorPrivate::extract()
 
                         if (!f.write(buffer, bytesRead))
                             throw Exception(f, "could not write to file");
+                        throttle(qint64(bytesRead));
                         break;
                     case PackageEntry_Header:
                         header.append(buffer, int(bytesRead));
@@ -376,10 +454,23 @@ void PackageExtractorPrivate::extract()
                 break;
 
             case PackageEntry_File:
+                if (!f.flush())
+                    throw Exception(f, "could not write to file");
+#if defined(Q_OS_LINUX)
+                // Start the write-back right away instead of leaving all the data in the page cache:
+                // the installer has to make the package durable at the end and this way there
+                // is not much left to do for the final fsync()s.
+                ::sync_file_range(f.handle(), 0, 0, SYNC_FILE_RANGE_WRITE);
+#endif
+                if (m_entryWrittenCallback)
+                    m_entryWrittenCallback(entryPath, f.handle());
                 f.close();
                 Q_FALLTHROUGH();
 
             case PackageEntry_Dir: {
+                if ((packageEntryType == PackageEntry_Dir) && m_entryWrittenCallback)
+                    m_entryWrittenCallback(entryPath, -1);
+
                 // Just to be on the safe side, we also add the file's meta-data to the digest
                 PackageUtilities::addFileMetadataToDigest(entryPath, QFileInfo(m_destinationPath + entryPath), digest);
 
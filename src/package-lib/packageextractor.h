@@ -31,6 +31,11 @@ public:
     void setDestinationDirectory(const QDir &destinationDir);
 
     void setFileExtractedCallback(const std::function<void(const QString &)> &callback);
+    void setEntryWrittenCallback(const std::function<void(const QString &, int)> &callback);
+
+    quint64 writeBandwidthLimit() const;
+    void setWriteBandwidthLimit(quint64 bytesPerSecond);
+    qint64 throttledTime() const;
 
     bool extract();
 
@@ -8,6 +8,7 @@
 #include <QObject>
 #include <QNetworkReply>
 #include <QEventLoop>
+#include <QElapsedTimer>
 
 #include <archive.h>
 
@@ -38,6 +39,7 @@ private slots:
 private:
     void setError(Error errorCode, const QString &errorString);
     qint64 readTar(struct archive *ar, const void **archiveBuffer);
+    void throttle(qint64 bytesWritten);
     void processMetaData(const QByteArray &metadata, QCryptographicHash &digest, bool isHeader) Q_DECL_NOEXCEPT_EXPR(false);
 
 private:
@@ -46,6 +48,7 @@ private:
     QUrl m_url;
     QString m_destinationPath;
     std::function<void(const QString &)> m_fileExtractedCallback;
+    std::function<void(const QString &, int)> m_entryWrittenCallback;
     bool m_failed = false;
     QAtomicInt m_canceled;
     Error m_errorCode = Error::None;
@@ -62,6 +65,13 @@ private:
     qint64 m_bytesReadTotal = 0;
     qint64 m_lastProgress = 0;
 
+    // token bucket for the write bandwidth limit
+    quint64 m_writeBandwidthLimit = 0;
+    QElapsedTimer m_throttleClock;
+    qint64 m_throttleLastRefill = 0; // nsec
+    qint64 m_throttleTokens = 0;     // bytes
+    qint64 m_throttledTime = 0;      // nsec
+
     friend class PackageExtractor;
 };
 
@@ -41,6 +41,8 @@ ContainerManagerInterface::~ContainerManagerInterface() { }
     \value Running      The application is running.
     \value ShuttingDown The application has been stopped and is cleaning up (in multi-process mode
                         this state is only reached if the application is terminating gracefully).
+    \value Suspended    The application has been frozen and does not get any CPU time until it is
+                        thawed again.
 
     \sa ApplicationObject::runState, QProcess::ProcessState
 */
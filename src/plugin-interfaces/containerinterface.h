@@ -29,6 +29,7 @@ public:
         StartingUp,
         Running,
         ShuttingDown,
+        Suspended,
     };
     Q_ENUM(RunState)
 
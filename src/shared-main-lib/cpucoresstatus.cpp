@@ -0,0 +1,133 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "cpucoresstatus.h"
+
+#include <QThread>
+
+/*!
+    \qmltype CpuCoresStatus
+    \inqmlmodule QtApplicationManager
+    \ingroup common-instantiatable
+    \brief Provides information on the status of the individual CPU cores.
+
+    While CpuStatus only provides the overall CPU utilization, CpuCoresStatus provides the
+    utilization and the current clock frequency of every single CPU core. This helps to spot
+    single-threaded bottlenecks as well as throttled cores. Its property values are updated
+    whenever the method update() is called.
+
+    You can use this component as a MonitorModel data source if you want to plot its
+    previous values over time.
+
+    \qml
+    import QtQuick 2.11
+    import QtApplicationManager 2.0
+    ...
+    MonitorModel {
+        CpuCoresStatus {}
+    }
+    \endqml
+
+    \note This is only supported on Linux.
+*/
+
+QT_USE_NAMESPACE_AM
+
+CpuCoresStatus::CpuCoresStatus(QObject *parent)
+    : QObject(parent)
+#if defined(Q_OS_LINUX)
+    , m_reader(new CpuCoresReader)
+#endif
+{ }
+
+CpuCoresStatus::~CpuCoresStatus()
+{ }
+
+/*!
+    \qmlproperty int CpuCoresStatus::coreCount
+    \readonly
+
+    The number of CPU cores known to the system.
+*/
+int CpuCoresStatus::coreCount() const
+{
+#if defined(Q_OS_LINUX)
+    return m_reader->coreCount();
+#else
+    return QThread::idealThreadCount();
+#endif
+}
+
+/*!
+    \qmlproperty list<real> CpuCoresStatus::coreLoads
+    \readonly
+
+    Holds the utilization of each CPU core at the point when update() was last called, as values
+    ranging from 0 (inclusive, completely idle) to 1 (inclusive, fully busy). Time spent waiting
+    for I/O is counted as idle time.
+
+    \sa update
+*/
+QVariantList CpuCoresStatus::coreLoads() const
+{
+    return m_coreLoads;
+}
+
+/*!
+    \qmlproperty list<real> CpuCoresStatus::coreFrequencies
+    \readonly
+
+    Holds the clock frequency of each CPU core in MHz at the point when update() was last called.
+    The frequency is \c 0 for cores that do not report it (e.g. if the kernel has no \c cpufreq
+    support).
+
+    \sa update
+*/
+QVariantList CpuCoresStatus::coreFrequencies() const
+{
+    return m_coreFrequencies;
+}
+
+/*!
+    \qmlproperty list<string> CpuCoresStatus::roleNames
+    \readonly
+
+    Names of the roles provided by CpuCoresStatus when used as a MonitorModel data source.
+
+    \sa MonitorModel
+*/
+QStringList CpuCoresStatus::roleNames() const
+{
+    return { qSL("coreLoads"), qSL("coreFrequencies") };
+}
+
+/*!
+    \qmlmethod CpuCoresStatus::update
+
+    Updates the coreLoads and coreFrequencies properties.
+*/
+void CpuCoresStatus::update()
+{
+#if defined(Q_OS_LINUX)
+    auto toVariantList = [](const QVector<qreal> &values) {
+        QVariantList list;
+        list.reserve(values.size());
+        for (qreal value : values)
+            list << value;
+        return list;
+    };
+
+    QVariantList loads = toVariantList(m_reader->readLoadValues());
+    if (loads != m_coreLoads) {
+        m_coreLoads = loads;
+        emit coreLoadsChanged();
+    }
+    QVariantList frequencies = toVariantList(m_reader->readFrequencies());
+    if (frequencies != m_coreFrequencies) {
+        m_coreFrequencies = frequencies;
+        emit coreFrequenciesChanged();
+    }
+#endif
+}
+
+#include "moc_cpucoresstatus.cpp"
@@ -0,0 +1,51 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#pragma once
+
+#include <memory>
+
+#include <QObject>
+#include <QVariantList>
+
+#include <QtAppManCommon/global.h>
+#include <QtAppManMonitor/systemreader.h>
+
+
+QT_BEGIN_NAMESPACE_AM
+
+class CpuCoresStatus : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("AM-QmlType", "QtApplicationManager/CpuCoresStatus 2.0")
+    Q_PROPERTY(int coreCount READ coreCount CONSTANT)
+    Q_PROPERTY(QVariantList coreLoads READ coreLoads NOTIFY coreLoadsChanged)
+    Q_PROPERTY(QVariantList coreFrequencies READ coreFrequencies NOTIFY coreFrequenciesChanged)
+
+    Q_PROPERTY(QStringList roleNames READ roleNames CONSTANT)
+
+public:
+    CpuCoresStatus(QObject *parent = nullptr);
+    ~CpuCoresStatus() override;
+
+    int coreCount() const;
+    QVariantList coreLoads() const;
+    QVariantList coreFrequencies() const;
+
+    QStringList roleNames() const;
+
+    Q_INVOKABLE void update();
+
+signals:
+    void coreLoadsChanged();
+    void coreFrequenciesChanged();
+
+private:
+#if defined(Q_OS_LINUX)
+    std::unique_ptr<CpuCoresReader> m_reader;
+#endif
+    QVariantList m_coreLoads;
+    QVariantList m_coreFrequencies;
+};
+
+QT_END_NAMESPACE_AM
@@ -5,7 +5,9 @@
 
 #include "frametimer.h"
 
+#include <QDateTime>
 #include <QQuickWindow>
+#include <QtMath>
 #include <qqmlinfo.h>
 
 /*!
@@ -59,6 +61,35 @@
 
     Please note that when using FrameTimer as a MonitorModel data source there's no need to set it
     to \l{FrameTimer::running}{running} as MonitorModel will already call update() as needed.
+
+    Average frame rates tend to hide the occasional long frame that users perceive as a stutter.
+    FrameTimer therefore also keeps a histogram of the frame times within each interval, providing
+    percentiles like frameTimeP99, the number of framesOverBudget and the jankCount. Every
+    single long frame is reported via the jank() signal:
+
+    \qml
+    FrameTimer {
+        window: toplevelWindow
+        jankThreshold: 50
+        onJank: (timestamp, duration) => {
+            console.warn("Frame took", duration, "ms at", new Date(timestamp))
+        }
+    }
+    \endqml
+
+    \note A window that does not render anything for a while will report the first frame after
+          such a pause as a long frame.
+*/
+
+/*!
+    \qmlsignal FrameTimer::jank(real timestamp, real duration)
+
+    This signal is emitted for every frame that took at least \l jankThreshold milliseconds to
+    render. The \a timestamp is the time the frame was presented in milliseconds since the epoch
+    (a 64-bit integer, which does not fit into an \c int) and the \a duration is the frame time in
+    milliseconds.
+
+    \sa jankThreshold, jankCount
 */
 
 QT_BEGIN_NAMESPACE_AM
@@ -76,12 +107,26 @@ void FrameTimer::newFrame()
 {
     int frameTime = m_timer.isValid() ? qMax(1, int(m_timer.nsecsElapsed() / 1000)) : IdealFrameTime;
     m_timer.restart();
+    addFrame(frameTime);
+}
 
+void FrameTimer::addFrame(int frameTime)
+{
     m_count++;
     m_sum += frameTime;
     m_min = qMin(m_min, frameTime);
     m_max = qMax(m_max, frameTime);
     m_jitter += qAbs(MicrosInSec / IdealFrameTime - MicrosInSec / frameTime);
+
+    ++m_histogram[size_t(qMin(frameTime / 1000, HistogramSize - 1))];
+    for (int i = 0; i < m_budgets.size(); ++i) {
+        if (frameTime > m_budgets.at(i))
+            ++m_overBudget[i];
+    }
+    if (frameTime >= m_jankThreshold) {
+        ++m_jankCount;
+        emit jank(QDateTime::currentMSecsSinceEpoch(), frameTime / qreal(1000));
+    }
 }
 
 void FrameTimer::reset()
@@ -89,6 +134,27 @@ void FrameTimer::reset()
     m_count = m_sum = m_max = 0;
     m_jitter = 0;
     m_min = std::numeric_limits<int>::max();
+    m_jankCount = 0;
+    m_histogram.fill(0);
+    m_overBudget.fill(0);
+}
+
+qreal FrameTimer::percentile(qreal p) const
+{
+    if (!m_count)
+        return 0;
+
+    const int rank = qMax(1, qCeil(p * m_count));
+    int frames = 0;
+    for (int i = 0; i < HistogramSize; ++i) {
+        frames += m_histogram[size_t(i)];
+        if (frames >= rank) {
+            // the upper bound of the bucket, but never more than the longest frame
+            const qreal maxFrameTime = m_max / qreal(1000);
+            return (i == HistogramSize - 1) ? maxFrameTime : qMin(qreal(i + 1), maxFrameTime);
+        }
+    }
+    return m_max / qreal(1000);
 }
 
 /*!
@@ -147,6 +213,148 @@ qreal FrameTimer::jitterFps() const
     return m_jitterFps;
 }
 
+/*!
+    \qmlproperty real FrameTimer::frameTimeP50
+    \readonly
+
+    The median frame time of the given \l window in milliseconds, since update() was last called:
+    half of the frames took at most this long to render.
+
+    The percentiles are calculated from the frameTimeHistogram, so they have a resolution of one
+    millisecond.
+
+    \sa frameTimeP95, frameTimeP99, frameTimeHistogram
+*/
+qreal FrameTimer::frameTimeP50() const
+{
+    return m_frameTimeP50;
+}
+
+/*!
+    \qmlproperty real FrameTimer::frameTimeP95
+    \readonly
+
+    The 95th percentile of the frame times of the given \l window in milliseconds, since update()
+    was last called: 95% of the frames took at most this long to render.
+
+    \sa frameTimeP50, frameTimeP99
+*/
+qreal FrameTimer::frameTimeP95() const
+{
+    return m_frameTimeP95;
+}
+
+/*!
+    \qmlproperty real FrameTimer::frameTimeP99
+    \readonly
+
+    The 99th percentile of the frame times of the given \l window in milliseconds, since update()
+    was last called: 99% of the frames took at most this long to render.
+
+    \sa frameTimeP50, frameTimeP95
+*/
+qreal FrameTimer::frameTimeP99() const
+{
+    return m_frameTimeP99;
+}
+
+/*!
+    \qmlproperty list<int> FrameTimer::frameTimeHistogram
+    \readonly
+
+    The histogram of the frame times of the given \l window, since update() was last called. Each
+    entry is the number of frames that took \e n to \e n+1 milliseconds to render, with \e n being
+    the index into the list. The last entry (index 100) counts all frames that took 100
+    milliseconds or longer.
+
+    This property is not provided as a MonitorModel role.
+*/
+QList<int> FrameTimer::frameTimeHistogram() const
+{
+    return m_frameTimeHistogram;
+}
+
+/*!
+    \qmlproperty list<real> FrameTimer::frameBudgets
+
+    A list of frame time budgets in milliseconds. For each budget, framesOverBudget provides the
+    number of frames that took longer to render. The default is \c{[16.667, 33.334]}, which
+    corresponds to missing one or two vertical refreshes on a 60Hz display.
+
+    \sa framesOverBudget
+*/
+QList<qreal> FrameTimer::frameBudgets() const
+{
+    QList<qreal> budgets;
+    for (int budget : m_budgets)
+        budgets << budget / qreal(1000);
+    return budgets;
+}
+
+void FrameTimer::setFrameBudgets(const QList<qreal> &budgets)
+{
+    QVector<int> usecs;
+    for (qreal budget : budgets)
+        usecs << qRound(budget * 1000);
+    if (usecs == m_budgets)
+        return;
+
+    m_budgets = usecs;
+    m_overBudget.fill(0, m_budgets.size());
+    m_framesOverBudget = QList<int>(m_budgets.size(), 0);
+    emit frameBudgetsChanged();
+}
+
+/*!
+    \qmlproperty list<int> FrameTimer::framesOverBudget
+    \readonly
+
+    For each entry in frameBudgets, the number of frames of the given \l window that took longer
+    to render than this budget, since update() was last called.
+
+    \sa frameBudgets
+*/
+QList<int> FrameTimer::framesOverBudget() const
+{
+    return m_framesOverBudget;
+}
+
+/*!
+    \qmlproperty real FrameTimer::jankThreshold
+
+    The frame time in milliseconds, from which on a frame is reported via the jank() signal and
+    counted in jankCount. The default is \c 50.
+
+    \sa jank(), jankCount
+*/
+qreal FrameTimer::jankThreshold() const
+{
+    return m_jankThreshold / qreal(1000);
+}
+
+void FrameTimer::setJankThreshold(qreal threshold)
+{
+    int usecs = qRound(threshold * 1000);
+    if (usecs != m_jankThreshold) {
+        m_jankThreshold = usecs;
+        emit jankThresholdChanged();
+    }
+}
+
+/*!
+    \qmlproperty int FrameTimer::jankCount
+    \readonly
+
+    The number of frames of the given \l window that took at least \l jankThreshold milliseconds to
+    render, since update() was last called.
+
+    \sa jank(), jankThreshold
+*/
+int FrameTimer::jankCount() const
+{
+    return m_lastJankCount;
+}
+
 /*!
     \qmlproperty Object FrameTimer::window
 
@@ -209,13 +417,16 @@ void FrameTimer::disconnectFromAppManWindow()
 */
 QStringList FrameTimer::roleNames() const
 {
-    return { qSL("averageFps"), qSL("minimumFps"), qSL("maximumFps"), qSL("jitterFps") };
+    return { qSL("averageFps"), qSL("minimumFps"), qSL("maximumFps"), qSL("jitterFps"),
+             qSL("frameTimeP50"), qSL("frameTimeP95"), qSL("frameTimeP99"), qSL("framesOverBudget"),
+             qSL("jankCount") };
 }
 
 /*!
     \qmlmethod FrameTimer::update
 
-    Updates the properties averageFps, minimumFps, maximumFps and jitterFps. Then resets internal
+    Updates the properties averageFps, minimumFps, maximumFps, jitterFps, the frame time
+    percentiles, frameTimeHistogram, framesOverBudget and jankCount. Then resets internal
     counters so that new numbers can be taken for the new time period starting from the moment
     this method is called.
 
@@ -231,6 +442,13 @@ void FrameTimer::update()
     m_maximumFps = m_min ? MicrosInSec / m_min : qreal(0);
     m_jitterFps = m_count ? m_jitter / m_count :  qreal(0);
 
+    m_frameTimeP50 = percentile(qreal(0.5));
+    m_frameTimeP95 = percentile(qreal(0.95));
+    m_frameTimeP99 = percentile(qreal(0.99));
+    m_frameTimeHistogram = QList<int>(m_histogram.cbegin(), m_histogram.cend());
+    m_framesOverBudget = QList<int>(m_overBudget.cbegin(), m_overBudget.cend());
+    m_lastJankCount = m_jankCount;
+
     // Start counting again for the next sampling period but keep m_timer running because
     // we still need the diff between the last rendered frame and the upcoming one.
     reset();
@@ -9,7 +9,9 @@
 #include <QObject>
 #include <QPointer>
 #include <QTimer>
+#include <QVector>
 #include <QtAppManCommon/global.h>
+#include <array>
 #include <limits>
 
 
@@ -25,6 +27,15 @@ class FrameTimer : public QObject
     Q_PROPERTY(qreal maximumFps READ maximumFps NOTIFY updated)
     Q_PROPERTY(qreal jitterFps READ jitterFps NOTIFY updated)
 
+    Q_PROPERTY(qreal frameTimeP50 READ frameTimeP50 NOTIFY updated)
+    Q_PROPERTY(qreal frameTimeP95 READ frameTimeP95 NOTIFY updated)
+    Q_PROPERTY(qreal frameTimeP99 READ frameTimeP99 NOTIFY updated)
+    Q_PROPERTY(QList<int> frameTimeHistogram READ frameTimeHistogram NOTIFY updated)
+    Q_PROPERTY(QList<qreal> frameBudgets READ frameBudgets WRITE setFrameBudgets NOTIFY frameBudgetsChanged)
+    Q_PROPERTY(QList<int> framesOverBudget READ framesOverBudget NOTIFY updated)
+    Q_PROPERTY(qreal jankThreshold READ jankThreshold WRITE setJankThreshold NOTIFY jankThresholdChanged)
+    Q_PROPERTY(int jankCount READ jankCount NOTIFY updated)
+
     Q_PROPERTY(QObject* window READ window WRITE setWindow NOTIFY windowChanged)
 
     Q_PROPERTY(int interval READ interval WRITE setInterval NOTIFY intervalChanged)
@@ -44,6 +55,19 @@ public:
     qreal maximumFps() const;
     qreal jitterFps() const;
 
+    qreal frameTimeP50() const;
+    qreal frameTimeP95() const;
+    qreal frameTimeP99() const;
+    QList<int> frameTimeHistogram() const;
+
+    QList<qreal> frameBudgets() const;
+    void setFrameBudgets(const QList<qreal> &budgets);
+    QList<int> framesOverBudget() const;
+
+    qreal jankThreshold() const;
+    void setJankThreshold(qreal threshold);
+    int jankCount() const;
+
     QObject *window() const;
     void setWindow(QObject *value);
 
@@ -58,11 +82,15 @@ signals:
     void intervalChanged();
     void runningChanged();
     void windowChanged();
+    void frameBudgetsChanged();
+    void jankThresholdChanged();
+    void jank(qint64 timestamp, qreal duration);
 
 protected slots:
     void newFrame();
 
 protected:
+    void addFrame(int frameTime); // usec
     virtual bool connectToAppManWindow();
     virtual void disconnectFromAppManWindow();
 
@@ -71,12 +99,22 @@ protected:
 private:
     void reset();
     bool connectToQuickWindow();
+    qreal percentile(qreal p) const;
 
     int m_count = 0;
     int m_sum = 0;
     int m_min = std::numeric_limits<int>::max();
     int m_max = 0;
     qreal m_jitter = 0.0;
+    int m_jankCount = 0;
+
+    // one bucket per msec, the last one collects all the frames that took longer
+    static const int HistogramSize = 101;
+    std::array<int, HistogramSize> m_histogram { };
+
+    QVector<int> m_budgets { IdealFrameTime, 2 * IdealFrameTime }; // usec
+    QVector<int> m_overBudget { 0, 0 };
+    int m_jankThreshold = 50000; // usec
 
     QElapsedTimer m_timer;
 
@@ -86,6 +124,12 @@ private:
     qreal m_minimumFps;
     qreal m_maximumFps;
     qreal m_jitterFps;
+    qreal m_frameTimeP50 = 0;
+    qreal m_frameTimeP95 = 0;
+    qreal m_frameTimeP99 = 0;
+    QList<int> m_frameTimeHistogram;
+    QList<int> m_framesOverBudget { 0, 0 };
+    int m_lastJankCount = 0;
 
     static const int IdealFrameTime = 16667; // usec - could be made configurable via an env variable
     static const qreal MicrosInSec;
@@ -64,11 +64,16 @@ GpuStatus::GpuStatus(QObject *parent)
     GPU utilization when update() was last called, as a value ranging from 0 (inclusive,
     completely idle) to 1 (inclusive, fully busy).
 
-    \note This is dependent on tools from the graphics hardware vendor and might not work on
-          every system.
+    On \e Linux, the GPU usage statistics that the kernel's DRM drivers provide for every client
+    in \c{/proc/<pid>/fdinfo} are used. This is supported by most open source drivers (e.g. \c i915,
+    \c amdgpu, \c msm and \c panfrost) since Linux 5.19. The value is the utilization of
+    the busiest engine (e.g. \e render or \e video) accumulated over all processes.
 
-    Currently, this only works on \e Linux with either \e Intel or \e NVIDIA chipsets, plus the
-    tools from the respective vendors have to be installed:
+    \note If the DRM drivers do not provide these statistics, this is dependent on tools from
+    the graphics hardware vendor and might not work on every system.
+
+    As a fallback, this only works with either \e Intel or \e NVIDIA chipsets, plus the tools from
+    the respective vendors have to be installed:
 
     \table
     \header
@@ -94,12 +99,27 @@ qreal GpuStatus::gpuLoad() const
     return m_gpuLoad;
 }
 
+/*!
+    \qmlproperty real GpuStatus::gpuMemoryUsed
+    \readonly
+
+    The amount of GPU memory in bytes, that all processes had allocated when update() was last
+    called. This is only available if the DRM driver provides usage statistics (see gpuLoad) and
+    is \c 0 otherwise.
+
+    \sa update
+*/
+quint64 GpuStatus::gpuMemoryUsed() const
+{
+    return m_gpuMemoryUsed;
+}
+
 /*!
     \qmlmethod GpuStatus::update
 
-    Updates the gpuLoad property.
+    Updates the gpuLoad and gpuMemoryUsed properties.
 
-    \sa gpuLoad
+    \sa gpuLoad, gpuMemoryUsed
 */
 void GpuStatus::update()
 {
@@ -108,6 +128,11 @@ void GpuStatus::update()
         m_gpuLoad = newLoad;
         emit gpuLoadChanged();
     }
+    quint64 newMemoryUsed = m_gpuReader->memoryUsed();
+    if (newMemoryUsed != m_gpuMemoryUsed) {
+        m_gpuMemoryUsed = newMemoryUsed;
+        emit gpuMemoryUsedChanged();
+    }
 }
 
 /*!
@@ -120,7 +145,7 @@ void GpuStatus::update()
 */
 QStringList GpuStatus::roleNames() const
 {
-    return { qSL("gpuLoad") };
+    return { qSL("gpuLoad"), qSL("gpuMemoryUsed") };
 }
 
 
@@ -19,6 +19,7 @@ class GpuStatus : public QObject
     Q_OBJECT
     Q_CLASSINFO("AM-QmlType", "QtApplicationManager/GpuStatus 2.0")
     Q_PROPERTY(qreal gpuLoad READ gpuLoad NOTIFY gpuLoadChanged)
+    Q_PROPERTY(quint64 gpuMemoryUsed READ gpuMemoryUsed NOTIFY gpuMemoryUsedChanged)
 
     Q_PROPERTY(QStringList roleNames READ roleNames CONSTANT)
 
@@ -26,6 +27,7 @@ public:
     GpuStatus(QObject *parent = nullptr);
 
     qreal gpuLoad() const;
+    quint64 gpuMemoryUsed() const;
 
     QStringList roleNames() const;
 
@@ -33,10 +35,12 @@ public:
 
 signals:
     void gpuLoadChanged();
+    void gpuMemoryUsedChanged();
 
 private:
     std::unique_ptr<GpuReader> m_gpuReader;
     qreal m_gpuLoad;
+    quint64 m_gpuMemoryUsed = 0;
 };
 
 QT_END_NAMESPACE_AM
@@ -10,6 +10,8 @@
 #include <qqmlinfo.h>
 
 #include <QDebug>
+#include <QtMath>
+#include <algorithm>
 #include <QQmlProperty>
 #include <QJSValue>
 #include <QQmlEngine>
@@ -105,10 +107,12 @@
     QtApplicationManager comes with a number of components that are readily usable as data sources, namely:
     \list
     \li CpuStatus
+    \li CpuCoresStatus
     \li FrameTimer
     \li GpuStatus
     \li IoStatus
     \li MemoryStatus
+    \li PressureStatus
     \li ProcessStatus
     \endlist
 
@@ -118,6 +122,30 @@
     is discarded whenever a new row comes in, so that \l{MonitorModel::count}{count} doesn't exceed
     \l{MonitorModel::maximumCount}{maximumCount}. New rows are always appended to the model, so rows are
     ordered chronologically from oldest (index 0) to newest (index count-1).
+
+    The history is kept in fixed-size ring buffers, one per role, so adding a row does not allocate
+    any memory once \l{MonitorModel::maximumCount}{maximumCount} rows have been collected. Numeric
+    values are stored as plain numbers, which also makes it cheap to retrieve the complete history
+    of a role via series() (e.g. for plotting it in a chart), instead of querying every single row.
+
+    For long-term trends, keeping a very high \l{MonitorModel::maximumCount}{maximumCount} is not
+    advisable, as memory usage grows and charts would have to cope with thousands of rows. Instead,
+    you can add coarser \l{MonitorModel::resolutions}{resolutions}: every row at such a resolution
+    aggregates the minimum, maximum and average values of a number of raw rows. Each resolution
+    keeps up to \l{MonitorModel::maximumCount}{maximumCount} rows and the one that is exposed
+    as the model's rows is selected via the \l{MonitorModel::resolution}{resolution} property:
+
+    \qml
+    MonitorModel {
+        running: true
+        interval: 1000
+        maximumCount: 120
+        // 2 minutes of raw data, plus 2 hours at 1 minute and 1 day at 12 minutes resolution
+        resolutions: [ 60, 720 ]
+        resolution: hourView.checked ? 60 : 1
+        CpuStatus {}
+    }
+    \endqml
 */
 
 QT_USE_NAMESPACE_AM
@@ -131,7 +159,7 @@ MonitorModel::MonitorModel(QObject *parent)
 
 MonitorModel::~MonitorModel()
 {
-    qDeleteAll(m_rows);
+    qDeleteAll(m_dataSources);
 }
 
 /*!
@@ -183,6 +211,7 @@ void MonitorModel::clearDataSources()
     m_roleNameToIndex.clear();
 
     clear();
+    m_columns.clear();
 }
 
 void MonitorModel::appendDataSource(QObject *dataSourceObj)
@@ -194,6 +223,8 @@ void MonitorModel::appendDataSource(QObject *dataSourceObj)
     if (!extractRoleNamesFromJsArray(dataSource)
             && !extractRoleNamesFromStringList(dataSource))
         qmlWarning(this) << "Could not find a roleNames property containing an array or list of strings.";
+
+    reallocateColumns();
 }
 
 bool MonitorModel::extractRoleNamesFromJsArray(DataSource *dataSource)
@@ -259,7 +290,7 @@ void MonitorModel::addRoleName(QByteArray roleName, DataSource *dataSource)
 */
 int MonitorModel::count() const
 {
-    return m_rows.count();
+    return (m_currentLevel >= 0) ? m_levels.at(m_currentLevel).count : m_count;
 }
 
 int MonitorModel::rowCount(const QModelIndex &parent) const
@@ -274,10 +305,16 @@ int MonitorModel::rowCount(const QModelIndex &parent) const
 
 QVariant MonitorModel::data(const QModelIndex &index, int role) const
 {
-    if (index.parent().isValid() || !index.isValid() || index.row() < 0 || index.row() >= m_rows.count())
+    if (index.parent().isValid() || !index.isValid() || index.row() < 0 || index.row() >= count()
+            || role < 0 || role >= m_columns.size())
         return QVariant();
 
-    return m_rows.at(index.row())->dataFromRoleIndex[role];
+    if (m_currentLevel >= 0) {
+        const Level &level = m_levels.at(m_currentLevel);
+        const qreal average = level.average.at(role * m_capacity + (level.head + index.row()) % m_capacity);
+        return qIsNaN(average) ? QVariant() : QVariant(average);
+    }
+    return value(m_columns.at(role), slotForRow(index.row()));
 }
 
 QHash<int, QByteArray> MonitorModel::roleNames() const
@@ -339,53 +376,262 @@ void MonitorModel::setInterval(int value)
 
 void MonitorModel::readDataSourcesAndAddRow()
 {
-    if (m_dataSources.count() == 0)
+    if (m_dataSources.count() == 0 || m_capacity == 0)
         return;
 
-    if (m_rows.count() < m_maximumCount) {
-        // create a new row
-        DataRow *dataRow = new DataRow;
-        fillDataRow(dataRow);
-        beginInsertRows(QModelIndex(), /* first */ m_rows.count(), /* last */ m_rows.count());
-        m_rows.append(dataRow);
-        endInsertRows();
-        emit countChanged();
+    int slot = appendRow(m_head, m_count, m_currentLevel < 0, [this](int slot) { fillDataRow(slot); });
+    rollUp(slot);
+}
+
+// Appends a row to the ring buffer described by head and count and returns its slot. The model
+// signals are only emitted, if the ring buffer is the one exposed as model rows.
+int MonitorModel::appendRow(int &head, int &count, bool exposed, const std::function<void(int)> &fill)
+{
+    int slot;
+
+    if (count < m_capacity) {
+        // use the next free slot
+        slot = (head + count) % m_capacity;
+        fill(slot);
+        if (exposed)
+            beginInsertRows(QModelIndex(), /* first */ count, /* last */ count);
+        ++count;
+        if (exposed) {
+            endInsertRows();
+            emit countChanged();
+        }
     } else {
-        // recycle the oldest row
-        beginMoveRows(QModelIndex(), /* sourceFirst */ 0, /* sourceLast */ 0,
-                QModelIndex(), /* destination */ m_rows.count());
-        m_rows.append(m_rows.takeFirst());
-        endMoveRows();
-
-        {
-            fillDataRow(m_rows.last());
-            QModelIndex modelIndex = index(m_rows.count() - 1 /* row */, 0 /* column */);
+        // recycle the oldest row: advancing the head turns it into the newest one. A single row
+        // stays where it is: Qt rejects this no-op move, so it is just updated in place.
+        const bool moved = exposed && (count > 1)
+                && beginMoveRows(QModelIndex(), /* sourceFirst */ 0, /* sourceLast */ 0,
+                                 QModelIndex(), /* destination */ count);
+        slot = head;
+        head = (head + 1) % m_capacity;
+        if (moved)
+            endMoveRows();
+
+        fill(slot);
+        if (exposed) {
+            QModelIndex modelIndex = index(count - 1 /* row */, 0 /* column */);
             emit dataChanged(modelIndex, modelIndex);
         }
     }
+    return slot;
+}
+
+void MonitorModel::rollUp(int rawSlot)
+{
+    for (int levelIndex = 0; levelIndex < m_levels.size(); ++levelIndex) {
+        Level &level = m_levels[levelIndex];
+
+        for (int role = 0; role < m_columns.size(); ++role) {
+            const Column &column = m_columns.at(role);
+            if (!column.numeric)
+                continue;
+            const qreal number = column.numbers.at(rawSlot);
+            if (qIsNaN(number))
+                continue;
+
+            if (level.pendingSamples.at(role) == 0) {
+                level.pendingSum[role] = number;
+                level.pendingMin[role] = number;
+                level.pendingMax[role] = number;
+            } else {
+                level.pendingSum[role] += number;
+                level.pendingMin[role] = qMin(level.pendingMin.at(role), number);
+                level.pendingMax[role] = qMax(level.pendingMax.at(role), number);
+            }
+            ++level.pendingSamples[role];
+        }
+
+        if (++level.pending < level.factor)
+            continue;
+
+        appendRow(level.head, level.count, levelIndex == m_currentLevel, [this, &level](int slot) {
+            for (int role = 0; role < m_columns.size(); ++role) {
+                const int i = role * m_capacity + slot;
+                const int samples = level.pendingSamples.at(role);
+                level.minimum[i] = samples ? level.pendingMin.at(role) : qQNaN();
+                level.maximum[i] = samples ? level.pendingMax.at(role) : qQNaN();
+                level.average[i] = samples ? (level.pendingSum.at(role) / samples) : qQNaN();
+                level.pendingSamples[role] = 0;
+            }
+        });
+        level.pending = 0;
+    }
 }
 
-void MonitorModel::fillDataRow(DataRow *dataRow)
+void MonitorModel::resetLevel(Level &level)
+{
+    const int roles = m_roleNamesList.size();
+
+    level.head = 0;
+    level.count = 0;
+    level.pending = 0;
+    level.minimum.fill(qQNaN(), roles * m_capacity);
+    level.maximum.fill(qQNaN(), roles * m_capacity);
+    level.average.fill(qQNaN(), roles * m_capacity);
+    level.pendingSum.fill(0, roles);
+    level.pendingMin.fill(0, roles);
+    level.pendingMax.fill(0, roles);
+    level.pendingSamples.fill(0, roles);
+}
+
+void MonitorModel::fillDataRow(int slot)
 {
     for (int i = 0; i < m_dataSources.count(); ++i) {
-        readDataSource(m_dataSources[i], dataRow);
+        readDataSource(m_dataSources[i], slot);
     }
 }
 
-void MonitorModel::readDataSource(DataSource *dataSource, DataRow *dataRow)
+void MonitorModel::readDataSource(DataSource *dataSource, int slot)
 {
     // TODO: check if successful
     QMetaObject::invokeMethod(dataSource->obj, "update", Qt::DirectConnection);
 
     for (int i = 0; i < dataSource->roleNames.count(); i++) {
-        // TODO: check index exists
-        int roleIndex = m_roleNameToIndex[dataSource->roleNames[i]];
+        int roleIndex = m_roleNameToIndex.value(dataSource->roleNames[i], -1);
+        if (roleIndex < 0 || roleIndex >= m_columns.size())
+            continue;
 
         QVariant variant = QQmlProperty::read(dataSource->obj, QLatin1String(dataSource->roleNames[i]));
-        dataRow->dataFromRoleIndex[roleIndex] = variant;
+        setValue(m_columns[roleIndex], slot, variant);
+    }
+}
+
+static bool isNumericType(int typeId)
+{
+    switch (typeId) {
+    case QMetaType::Double:
+    case QMetaType::Float:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+        return true;
+    default:
+        return false;
     }
 }
 
+void MonitorModel::setValue(Column &column, int slot, const QVariant &value)
+{
+    const int typeId = value.typeId();
+
+    if (column.numeric) {
+        if (isNumericType(typeId)) {
+            // a column that has mixed numeric types is reported as double
+            if (column.typeId == QMetaType::UnknownType)
+                column.typeId = typeId;
+            else if (column.typeId != typeId)
+                column.typeId = QMetaType::Double;
+            column.numbers[slot] = value.toDouble();
+            return;
+        } else if (!value.isValid()) {
+            column.numbers[slot] = qQNaN();
+            return;
+        }
+
+        // this role does not provide numbers: convert the column once
+        column.variants.resize(m_capacity);
+        for (int i = 0; i < m_capacity; ++i)
+            column.variants[i] = this->value(column, i);
+        column.numbers.clear();
+        column.numbers.squeeze();
+        column.numeric = false;
+    }
+    column.variants[slot] = value;
+}
+
+QVariant MonitorModel::value(const Column &column, int slot) const
+{
+    if (!column.numeric)
+        return column.variants.at(slot);
+
+    const qreal number = column.numbers.at(slot);
+    if (qIsNaN(number))
+        return QVariant();
+
+    switch (column.typeId) {
+    case QMetaType::Float: return float(number);
+    case QMetaType::Int: return int(number);
+    case QMetaType::UInt: return uint(number);
+    case QMetaType::LongLong: return qint64(number);
+    case QMetaType::ULongLong: return quint64(number);
+    default: return number;
+    }
+}
+
+void MonitorModel::reallocateColumns()
+{
+    // keeps the rows, but moves the oldest one to the first slot. If the raw rows are not exposed,
+    // there might be more of them than the new capacity: only the newest ones are kept in that case
+    const int capacity = qMax(0, m_maximumCount);
+    const int keepRaw = qMin(m_count, capacity);
+    const int skipRaw = m_count - keepRaw;
+    QVector<Column> columns(m_roleNamesList.size());
+
+    for (int role = 0; role < columns.size(); ++role) {
+        Column &column = columns[role];
+
+        if (role < m_columns.size()) {
+            const Column &oldColumn = m_columns.at(role);
+            column.numeric = oldColumn.numeric;
+            column.typeId = oldColumn.typeId;
+        }
+        if (column.numeric)
+            column.numbers.fill(qQNaN(), capacity);
+        else
+            column.variants.resize(capacity);
+
+        if (role < m_columns.size()) {
+            const Column &oldColumn = m_columns.at(role);
+            for (int row = 0; row < keepRaw; ++row) {
+                if (column.numeric)
+                    column.numbers[row] = oldColumn.numbers.at(slotForRow(skipRaw + row));
+                else
+                    column.variants[row] = oldColumn.variants.at(slotForRow(skipRaw + row));
+            }
+        }
+    }
+
+    // same for the rolled-up levels, but these might have more rows than the new capacity if they
+    // are not exposed: only the newest ones are kept in that case
+    const int roles = m_roleNamesList.size();
+    const int oldRoles = m_columns.size();
+
+    for (Level &level : m_levels) {
+        const int keep = qMin(level.count, capacity);
+        const int skip = level.count - keep;
+
+        auto relayout = [&](const QVector<qreal> &oldValues) {
+            QVector<qreal> values(roles * capacity, qQNaN());
+            for (int role = 0; role < qMin(roles, oldRoles); ++role) {
+                for (int row = 0; row < keep; ++row) {
+                    values[role * capacity + row] =
+                            oldValues.at(role * m_capacity + (level.head + skip + row) % m_capacity);
+                }
+            }
+            return values;
+        };
+        level.minimum = relayout(level.minimum);
+        level.maximum = relayout(level.maximum);
+        level.average = relayout(level.average);
+        level.head = 0;
+        level.count = keep;
+        level.pendingSum.resize(roles);
+        level.pendingMin.resize(roles);
+        level.pendingMax.resize(roles);
+        level.pendingSamples.resize(roles);
+    }
+
+    m_columns = columns;
+    m_capacity = capacity;
+    m_head = 0;
+    m_count = keepRaw;
+}
+
 /*!
     \qmlproperty int MonitorModel::maximumCount
 
@@ -404,23 +650,140 @@ void MonitorModel::setMaximumCount(int value)
     if (m_maximumCount == value)
         return;
 
+    trimHistory(qMax(0, value));
     m_maximumCount = value;
-    trimHistory();
+    reallocateColumns();
     emit maximumCountChanged();
 }
 
-void MonitorModel::trimHistory()
+void MonitorModel::trimHistory(int maximumCount)
+{
+    // only the rows exposed by the model need the signals, the raw rows and all the other levels
+    // are trimmed silently (reallocateColumns() relies on none of them exceeding maximumCount)
+    auto trim = [this, maximumCount](int &head, int &count, bool exposed) {
+        int excess = count - maximumCount;
+        if (excess <= 0)
+            return;
+
+        if (exposed)
+            beginRemoveRows(QModelIndex(), /* first */ 0, /* last */ excess - 1);
+        head = (head + excess) % m_capacity;
+        count -= excess;
+        if (exposed) {
+            endRemoveRows();
+            emit countChanged();
+        }
+    };
+
+    trim(m_head, m_count, m_currentLevel < 0);
+    for (int i = 0; i < m_levels.size(); ++i)
+        trim(m_levels[i].head, m_levels[i].count, m_currentLevel == i);
+}
+
+/*!
+    \qmlproperty list<int> MonitorModel::resolutions
+
+    A list of additional, coarser resolutions that the MonitorModel keeps a history for. Each
+    value is the number of raw rows that are aggregated into one row at this resolution: e.g. with
+    an \l interval of 1000 and a resolution of \c 60, every row covers one minute.
+
+    For every role that provides numbers, the minimum, maximum and average value within each row
+    is kept. Each resolution keeps up to \l maximumCount rows, so even a long history only takes
+    up a few kilobytes. The default is an empty list, meaning only the raw rows are kept.
+
+    Newly added resolutions start out empty.
+
+    \sa resolution, seriesMinimum, seriesMaximum
+*/
+QList<int> MonitorModel::resolutions() const
+{
+    QList<int> factors;
+    factors.reserve(m_levels.size());
+    for (const Level &level : m_levels)
+        factors << level.factor;
+    return factors;
+}
+
+void MonitorModel::setResolutions(const QList<int> &resolutions)
+{
+    QList<int> factors;
+    for (int factor : resolutions) {
+        if (factor <= 1)
+            qmlWarning(this) << "Ignoring invalid resolution" << factor << "(must be greater than 1)";
+        else if (!factors.contains(factor))
+            factors << factor;
+    }
+    std::sort(factors.begin(), factors.end());
+
+    if (factors == this->resolutions())
+        return;
+
+    const int oldResolution = resolution();
+    const bool wasExposed = (m_currentLevel >= 0);
+    if (wasExposed)
+        beginResetModel();
+
+    // keep the history of the resolutions that are still in use
+    QVector<Level> levels(factors.size());
+    for (int i = 0; i < factors.size(); ++i) {
+        auto it = std::find_if(m_levels.begin(), m_levels.end(), [&](const Level &level) {
+            return level.factor == factors.at(i);
+        });
+        if (it != m_levels.end()) {
+            levels[i] = std::move(*it);
+        } else {
+            levels[i].factor = factors.at(i);
+            resetLevel(levels[i]);
+        }
+    }
+    m_levels = levels;
+    m_currentLevel = factors.indexOf(oldResolution);
+
+    if (wasExposed) {
+        endResetModel();
+        emit countChanged();
+    }
+    emit resolutionsChanged();
+    if (resolution() != oldResolution)
+        emit resolutionChanged();
+}
+
+/*!
+    \qmlproperty int MonitorModel::resolution
+
+    The resolution of the rows that the model provides. This is either \c 1 (the default) for the
+    raw rows or one of the values in \l resolutions. At a coarser resolution, the roles
+    of the model provide the average value within each row, while the minimum and maximum values
+    can be retrieved via seriesMinimum() and seriesMaximum().
+
+    \sa resolutions
+*/
+int MonitorModel::resolution() const
+{
+    return (m_currentLevel >= 0) ? m_levels.at(m_currentLevel).factor : 1;
+}
+
+void MonitorModel::setResolution(int resolution)
 {
-    int excess = m_rows.count() - m_maximumCount;
-    if (excess <= 0)
+    if (resolution == this->resolution())
         return;
 
-    beginRemoveRows(QModelIndex(), /* first */ 0, /* last */ excess - 1);
+    int levelIndex = -1;
+    if (resolution != 1) {
+        levelIndex = resolutions().indexOf(resolution);
+        if (levelIndex < 0) {
+            qmlWarning(this) << "Resolution" << resolution << "is not one of the resolutions"
+                             << resolutions();
+            return;
+        }
+    }
 
-    while (m_rows.count() > m_maximumCount)
-        delete m_rows.takeFirst();
+    beginResetModel();
+    m_currentLevel = levelIndex;
+    endResetModel();
 
-    endRemoveRows();
+    emit countChanged();
+    emit resolutionChanged();
 }
 
 /*!
@@ -433,8 +796,11 @@ void MonitorModel::trimHistory()
 void MonitorModel::clear()
 {
     beginResetModel();
-    qDeleteAll(m_rows);
-    m_rows.clear();
+    // the slots are kept allocated and will simply be overwritten
+    m_head = 0;
+    m_count = 0;
+    for (Level &level : m_levels)
+        resetLevel(level);
     endResetModel();
 
     emit countChanged();
@@ -461,4 +827,100 @@ QVariantMap MonitorModel::get(int row) const
     return map;
 }
 
+/*!
+    \qmlmethod list<real> MonitorModel::series(string roleName)
+
+    Returns the values of the role \a roleName of all rows as a list of numbers, ordered from the
+    oldest to the newest row. This is a lot more efficient than calling get() for every single row,
+    if you need the complete history, e.g. to plot it in a chart.
+
+    At a coarser \l{MonitorModel::resolution}{resolution}, the average values within each row are
+    returned.
+
+    Rows without a value for this role, as well as values that cannot be converted to a number,
+    are returned as \c NaN. An empty list is returned, if there is no role named \a roleName.
+
+    \sa seriesMinimum, seriesMaximum
+*/
+QList<qreal> MonitorModel::series(const QString &roleName) const
+{
+    return series(roleForSeries(roleName), Average);
+}
+
+/*!
+    \qmlmethod list<real> MonitorModel::seriesMinimum(string roleName)
+
+    Returns the minimum values of the role \a roleName of all rows at the current
+    \l{MonitorModel::resolution}{resolution}, ordered from the oldest to the newest row. At the
+    raw resolution, this is the same as series().
+
+    \sa series, seriesMaximum
+*/
+QList<qreal> MonitorModel::seriesMinimum(const QString &roleName) const
+{
+    return series(roleForSeries(roleName), Minimum);
+}
+
+/*!
+    \qmlmethod list<real> MonitorModel::seriesMaximum(string roleName)
+
+    Returns the maximum values of the role \a roleName of all rows at the current
+    \l{MonitorModel::resolution}{resolution}, ordered from the oldest to the newest row. At the
+    raw resolution, this is the same as series().
+
+    \sa series, seriesMinimum
+*/
+QList<qreal> MonitorModel::seriesMaximum(const QString &roleName) const
+{
+    return series(roleForSeries(roleName), Maximum);
+}
+
+int MonitorModel::roleForSeries(const QString &roleName) const
+{
+    int role = m_roleNameToIndex.value(roleName.toLatin1(), -1);
+    if (role < 0)
+        qmlWarning(this) << "MonitorModel::series: there is no role named" << roleName;
+    return role;
+}
+
+QList<qreal> MonitorModel::series(int role) const
+{
+    return series(role, Average);
+}
+
+QList<qreal> MonitorModel::series(int role, Aggregate aggregate) const
+{
+    QList<qreal> result;
+    if (role < 0 || role >= m_columns.size() || count() == 0)
+        return result;
+
+    if (m_currentLevel >= 0) {
+        const Level &level = m_levels.at(m_currentLevel);
+        const QVector<qreal> &values = (aggregate == Minimum) ? level.minimum
+                                                              : (aggregate == Maximum) ? level.maximum
+                                                                                       : level.average;
+        result.resize(level.count);
+        for (int row = 0; row < level.count; ++row)
+            result[row] = values.at(role * m_capacity + (level.head + row) % m_capacity);
+        return result;
+    }
+
+    const Column &column = m_columns.at(role);
+    result.resize(m_count);
+
+    if (column.numeric) {
+        // the rows are stored in at most two contiguous blocks
+        const int firstBlock = qMin(m_count, m_capacity - m_head);
+        std::copy_n(column.numbers.constData() + m_head, firstBlock, result.data());
+        std::copy_n(column.numbers.constData(), m_count - firstBlock, result.data() + firstBlock);
+    } else {
+        for (int row = 0; row < m_count; ++row) {
+            bool ok = false;
+            qreal number = column.variants.at(slotForRow(row)).toDouble(&ok);
+            result[row] = ok ? number : qQNaN();
+        }
+    }
+    return result;
+}
+
 #include "moc_monitormodel.cpp"
@@ -9,9 +9,12 @@
 #include <QtAppManCommon/global.h>
 #include <QtQml/qqmllist.h>
 #include <QList>
+#include <QMetaType>
 #include <QStringList>
 #include <QTimer>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE_AM
 
 class MonitorModel : public QAbstractListModel
@@ -24,6 +27,8 @@ class MonitorModel : public QAbstractListModel
 
     Q_PROPERTY(int count READ count NOTIFY countChanged)
     Q_PROPERTY(int maximumCount READ maximumCount WRITE setMaximumCount  NOTIFY maximumCountChanged)
+    Q_PROPERTY(QList<int> resolutions READ resolutions WRITE setResolutions NOTIFY resolutionsChanged)
+    Q_PROPERTY(int resolution READ resolution WRITE setResolution NOTIFY resolutionChanged)
 
     Q_PROPERTY(int interval READ interval WRITE setInterval NOTIFY intervalChanged)
     Q_PROPERTY(bool running READ running WRITE setRunning NOTIFY runningChanged)
@@ -54,8 +59,19 @@ public:
     int maximumCount() const;
     void setMaximumCount(int value);
 
+    QList<int> resolutions() const;
+    void setResolutions(const QList<int> &resolutions);
+
+    int resolution() const;
+    void setResolution(int resolution);
+
     Q_INVOKABLE void clear();
     Q_INVOKABLE QVariantMap get(int row) const;
+    Q_INVOKABLE QList<qreal> series(const QString &roleName) const;
+    Q_INVOKABLE QList<qreal> seriesMinimum(const QString &roleName) const;
+    Q_INVOKABLE QList<qreal> seriesMaximum(const QString &roleName) const;
+
+    QList<qreal> series(int role) const;
 
 signals:
     void countChanged();
@@ -63,15 +79,40 @@ signals:
     void runningChanged();
     void maximumCountChanged();
     void dataSourcesChanged();
+    void resolutionsChanged();
+    void resolutionChanged();
 
 private slots:
     void readDataSourcesAndAddRow();
 
 private:
-    struct DataRow {
-        QHash<int, QVariant> dataFromRoleIndex;
+    // The history of one role, stored in a ring buffer shared by all columns: numbers are kept
+    // as plain doubles, while all other values (e.g. maps) are kept as QVariants.
+    struct Column {
+        bool numeric = true;
+        int typeId = QMetaType::UnknownType; // of the numeric values, to convert them back in data()
+        QVector<qreal> numbers;              // NaN: no value
+        QVector<QVariant> variants;
     };
 
+    // A rolled-up history of the numeric roles, in which every row (bucket) aggregates 'factor'
+    // raw rows. The buckets are stored role by role: [role * m_capacity + slot]
+    struct Level {
+        int factor = 1;
+        int head = 0;
+        int count = 0;
+        int pending = 0;             // raw rows aggregated into the next bucket so far
+        QVector<qreal> minimum;      // NaN: no value
+        QVector<qreal> maximum;
+        QVector<qreal> average;
+        QVector<qreal> pendingSum;   // indexed by role
+        QVector<qreal> pendingMin;
+        QVector<qreal> pendingMax;
+        QVector<int> pendingSamples;
+    };
+
+    enum Aggregate { Minimum, Maximum, Average };
+
     struct DataSource {
         QObject *obj;
         QVector<QByteArray> roleNames;
@@ -79,9 +120,18 @@ private:
 
     void clearDataSources();
     void appendDataSource(QObject *dataSource);
-    void fillDataRow(DataRow *dataRow);
-    void readDataSource(DataSource *dataSource, DataRow *dataRow);
-    void trimHistory();
+    void fillDataRow(int slot);
+    void readDataSource(DataSource *dataSource, int slot);
+    void trimHistory(int maximumCount);
+    void reallocateColumns();
+    void setValue(Column &column, int slot, const QVariant &value);
+    QVariant value(const Column &column, int slot) const;
+    inline int slotForRow(int row) const { return (m_head + row) % m_capacity; }
+    int appendRow(int &head, int &count, bool exposed, const std::function<void(int)> &fill);
+    void rollUp(int rawSlot);
+    void resetLevel(Level &level);
+    QList<qreal> series(int role, Aggregate aggregate) const;
+    int roleForSeries(const QString &roleName) const;
     bool extractRoleNamesFromJsArray(DataSource *dataSource);
     bool extractRoleNamesFromStringList(DataSource *dataSource);
     void addRoleName(QByteArray roleName, DataSource *dataSource);
@@ -90,7 +140,13 @@ private:
     QList<QByteArray> m_roleNamesList; // also maps a role index to its name
     QHash<QByteArray, int> m_roleNameToIndex;
 
-    QList<DataRow*> m_rows;
+    QVector<Column> m_columns; // indexed by role
+    int m_capacity = 0;        // number of allocated slots per column
+    int m_head = 0;            // slot of the oldest row
+    int m_count = 0;
+
+    QVector<Level> m_levels;   // sorted by factor
+    int m_currentLevel = -1;   // the level exposed as model rows; -1: the raw rows
 
     QTimer m_timer;
     int m_maximumCount = 10;
@@ -0,0 +1,163 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "pressurestatus.h"
+
+/*!
+    \qmltype PressureStatus
+    \inqmlmodule QtApplicationManager
+    \ingroup common-instantiatable
+    \brief Provides information on the CPU, memory and I/O pressure of the system.
+
+    PressureStatus provides the Linux kernel's pressure stall information (PSI), which tells how
+    much time tasks had to wait for a resource. This makes it possible to find out whether stutters
+    in the UI are caused by CPU contention, memory reclaim or slow I/O. Its property values are
+    updated whenever the method update() is called.
+
+    You can use this component as a MonitorModel data source if you want to plot its
+    previous values over time.
+
+    \qml
+    import QtQuick 2.11
+    import QtApplicationManager 2.0
+    ...
+    MonitorModel {
+        PressureStatus {}
+    }
+    \endqml
+
+    \note This is only supported on Linux kernels that have been built with \c CONFIG_PSI.
+*/
+
+QT_USE_NAMESPACE_AM
+
+PressureStatus::PressureStatus(QObject *parent)
+    : QObject(parent)
+{
+#if defined(Q_OS_LINUX)
+    m_readers[0].reset(new PressureReader(PressureReader::Cpu));
+    m_readers[1].reset(new PressureReader(PressureReader::Memory));
+    m_readers[2].reset(new PressureReader(PressureReader::Io));
+#endif
+}
+
+PressureStatus::~PressureStatus()
+{ }
+
+/*!
+    \qmlproperty bool PressureStatus::available
+    \readonly
+
+    Holds whether the pressure stall information is available on this system.
+*/
+bool PressureStatus::isAvailable() const
+{
+#if defined(Q_OS_LINUX)
+    return m_readers[0]->isAvailable();
+#else
+    return false;
+#endif
+}
+
+/*!
+    \qmlproperty var PressureStatus::cpuPressure
+    \readonly
+
+    The CPU pressure at the point when update() was last called. This is a JavaScript object with
+    the following properties:
+
+    \table
+    \header
+        \li Name
+        \li Description
+    \row
+        \li \c some
+        \li The share of time in the last 10 seconds, in which at least one task was waiting for
+            the resource, as a value ranging from 0 to 1.
+    \row
+        \li \c full
+        \li The share of time in the last 10 seconds, in which all non-idle tasks were waiting for
+            the resource at the same time, as a value ranging from 0 to 1.
+    \row
+        \li \c someStallTime
+        \li The time in microseconds, in which at least one task was waiting for the resource
+            since the previous call to update().
+    \row
+        \li \c fullStallTime
+        \li The time in microseconds, in which all non-idle tasks were waiting for the resource
+            since the previous call to update().
+    \endtable
+
+    \sa update
+*/
+QVariantMap PressureStatus::cpuPressure() const
+{
+    return m_pressure[0];
+}
+
+/*!
+    \qmlproperty var PressureStatus::memoryPressure
+    \readonly
+
+    The memory pressure at the point when update() was last called. See cpuPressure for the
+    available properties.
+
+    \sa update
+*/
+QVariantMap PressureStatus::memoryPressure() const
+{
+    return m_pressure[1];
+}
+
+/*!
+    \qmlproperty var PressureStatus::ioPressure
+    \readonly
+
+    The I/O pressure at the point when update() was last called. See cpuPressure for the
+    available properties.
+
+    \sa update
+*/
+QVariantMap PressureStatus::ioPressure() const
+{
+    return m_pressure[2];
+}
+
+/*!
+    \qmlproperty list<string> PressureStatus::roleNames
+    \readonly
+
+    Names of the roles provided by PressureStatus when used as a MonitorModel data source.
+
+    \sa MonitorModel
+*/
+QStringList PressureStatus::roleNames() const
+{
+    return { qSL("cpuPressure"), qSL("memoryPressure"), qSL("ioPressure") };
+}
+
+/*!
+    \qmlmethod PressureStatus::update
+
+    Updates the cpuPressure, memoryPressure and ioPressure properties.
+*/
+void PressureStatus::update()
+{
+#if defined(Q_OS_LINUX)
+    for (int i = 0; i < 3; ++i) {
+        if (!m_readers[i]->isAvailable())
+            continue;
+
+        const PressureReader::Values v = m_readers[i]->readValues();
+        m_pressure[i] = QVariantMap {
+            { qSL("some"), v.someAvg10 },
+            { qSL("full"), v.fullAvg10 },
+            { qSL("someStallTime"), v.someDelta },
+            { qSL("fullStallTime"), v.fullDelta }
+        };
+    }
+    emit pressureChanged();
+#endif
+}
+
+#include "moc_pressurestatus.cpp"
@@ -0,0 +1,51 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#pragma once
+
+#include <memory>
+
+#include <QObject>
+#include <QVariantMap>
+
+#include <QtAppManCommon/global.h>
+#include <QtAppManMonitor/systemreader.h>
+
+
+QT_BEGIN_NAMESPACE_AM
+
+class PressureStatus : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("AM-QmlType", "QtApplicationManager/PressureStatus 2.0")
+    Q_PROPERTY(bool available READ isAvailable CONSTANT)
+    Q_PROPERTY(QVariantMap cpuPressure READ cpuPressure NOTIFY pressureChanged)
+    Q_PROPERTY(QVariantMap memoryPressure READ memoryPressure NOTIFY pressureChanged)
+    Q_PROPERTY(QVariantMap ioPressure READ ioPressure NOTIFY pressureChanged)
+
+    Q_PROPERTY(QStringList roleNames READ roleNames CONSTANT)
+
+public:
+    PressureStatus(QObject *parent = nullptr);
+    ~PressureStatus() override;
+
+    bool isAvailable() const;
+    QVariantMap cpuPressure() const;
+    QVariantMap memoryPressure() const;
+    QVariantMap ioPressure() const;
+
+    QStringList roleNames() const;
+
+    Q_INVOKABLE void update();
+
+signals:
+    void pressureChanged();
+
+private:
+#if defined(Q_OS_LINUX)
+    std::unique_ptr<PressureReader> m_readers[3];
+#endif
+    QVariantMap m_pressure[3];
+};
+
+QT_END_NAMESPACE_AM
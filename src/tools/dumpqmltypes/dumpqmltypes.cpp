@@ -27,9 +27,11 @@
 #include <QtAppManIntentClient/intentclientrequest.h>
 #include <QtAppManIntentClient/intenthandler.h>
 #include <QtAppManSharedMain/cpustatus.h>
+#include <QtAppManSharedMain/cpucoresstatus.h>
 #include <QtAppManSharedMain/gpustatus.h>
 #include <QtAppManSharedMain/memorystatus.h>
 #include <QtAppManSharedMain/iostatus.h>
+#include <QtAppManSharedMain/pressurestatus.h>
 #include <QtAppManManager/processstatus.h>
 #include <QtAppManSharedMain/frametimer.h>
 #include <QtAppManSharedMain/monitormodel.h>
@@ -75,9 +77,11 @@ static const QVector<const QMetaObject *> all = {
 
     // monitor-lib
     &CpuStatus::staticMetaObject,
+    &CpuCoresStatus::staticMetaObject,
     &GpuStatus::staticMetaObject,
     &MemoryStatus::staticMetaObject,
     &IoStatus::staticMetaObject,
+    &PressureStatus::staticMetaObject,
     &ProcessStatus::staticMetaObject,
     &FrameTimer::staticMetaObject,
     &MonitorModel::staticMetaObject
@@ -54,12 +54,14 @@
 #include "launcher-qml_p.h"
 
 // shared-main-lib
+#include "cpucoresstatus.h"
 #include "cpustatus.h"
 #include "frametimer.h"
 #include "gpustatus.h"
 #include "iostatus.h"
 #include "memorystatus.h"
 #include "monitormodel.h"
+#include "pressurestatus.h"
 
 #if defined(AM_WIDGETS_SUPPORT)
 #  include <QApplication>
@@ -170,11 +172,13 @@ Controller::Controller(LauncherMain *launcher, bool quickLaunched, const QPair<Q
 
     // monitor-lib
     qmlRegisterType<CpuStatus>("QtApplicationManager", 2, 0, "CpuStatus");
+    qmlRegisterType<CpuCoresStatus>("QtApplicationManager", 2, 0, "CpuCoresStatus");
     qmlRegisterType<FrameTimer>("QtApplicationManager", 2, 0, "FrameTimer");
     qmlRegisterType<GpuStatus>("QtApplicationManager", 2, 0, "GpuStatus");
     qmlRegisterType<IoStatus>("QtApplicationManager", 2, 0, "IoStatus");
     qmlRegisterType<MemoryStatus>("QtApplicationManager", 2, 0, "MemoryStatus");
     qmlRegisterType<MonitorModel>("QtApplicationManager", 2, 0, "MonitorModel");
+    qmlRegisterType<PressureStatus>("QtApplicationManager", 2, 0, "PressureStatus");
 
     // monitor-lib
     qmlRegisterType<CpuStatus>("QtApplicationManager", 1, 0, "CpuStatus");
@@ -376,6 +380,9 @@ void Controller::startApplication(const QString &baseDir, const QString &qmlFile
     const QUrl qmlFileUrl = filePathToUrl(qmlFile, baseDir);
     const QString qmlFileStr = urlToLocalFilePath(qmlFileUrl);
 
+    // use the QML cache that might have been generated when installing the package
+    seedQmlDiskCache(QDir(baseDir).absoluteFilePath(precompiledQmlCacheDirName()));
+
     if (!QFile::exists(qmlFileStr)) {
         qCCritical(LogQmlRuntime) << "could not load" << qmlFile << ": file does not exist";
         QCoreApplication::exit(2);
@@ -4,6 +4,7 @@
 
 #include <QPointer>
 #include <QDir>
+#include <QTemporaryDir>
 #include <QRegularExpression>
 #include <QAbstractEventDispatcher>
 #if defined(Q_OS_LINUX)
@@ -81,6 +82,20 @@ bool AmTest::dirExists(const QString &dir)
     return QDir(dir).exists();
 }
 
+QString AmTest::createTemporaryDir()
+{
+    QTemporaryDir tmp;
+    if (!tmp.isValid())
+        return QString();
+    tmp.setAutoRemove(false); // removed via removeDir()
+    return tmp.path();
+}
+
+bool AmTest::removeDir(const QString &dir)
+{
+    return QDir(dir).removeRecursively();
+}
+
 #if defined(Q_OS_LINUX)
 QString AmTest::ps(int pid)
 {
@@ -30,6 +30,8 @@ public:
     Q_INVOKABLE int observeObjectDestroyed(QObject *obj);
     Q_INVOKABLE void aboutToBlock();
     Q_INVOKABLE bool dirExists(const QString &dir);
+    Q_INVOKABLE QString createTemporaryDir();
+    Q_INVOKABLE bool removeDir(const QString &dir);
 #if defined(Q_OS_LINUX)
     Q_INVOKABLE QString ps(int pid);
     Q_INVOKABLE QString cmdLine(int pid);
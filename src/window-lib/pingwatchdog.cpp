@@ -0,0 +1,212 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTimer>
+
+#include "logging.h"
+#include "pingwatchdog.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+static PingWatchdog::Thresholds parseThresholds(const QVariantMap &map,
+                                                const PingWatchdog::Thresholds &defaults)
+{
+    PingWatchdog::Thresholds t;
+    t.pingInterval = qMax(0, map.value(qSL("pingInterval"), defaults.pingInterval).toInt());
+    t.pongTimeout = qMax(0, map.value(qSL("pongTimeout"), defaults.pongTimeout).toInt());
+    return t;
+}
+
+PingWatchdog::PingWatchdog(QObject *parent)
+    : QObject(parent)
+    , m_wheel(WheelSize)
+    , m_tickTimer(new QTimer(this))
+{
+    m_tickTimer->setInterval(TickInterval);
+    connect(m_tickTimer, &QTimer::timeout, this, &PingWatchdog::tick);
+}
+
+PingWatchdog::~PingWatchdog()
+{ }
+
+bool PingWatchdog::isEnabled() const
+{
+    return m_enabled;
+}
+
+void PingWatchdog::setEnabled(bool enabled)
+{
+    if (enabled == m_enabled)
+        return;
+    m_enabled = enabled;
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it)
+        updateClient(it.key(), it.value());
+}
+
+void PingWatchdog::setConfiguration(const QVariantMap &configuration)
+{
+    m_defaultThresholds = parseThresholds(configuration, Thresholds { });
+    m_overrides.clear();
+
+    const QVariantList overrides = configuration.value(qSL("overrides")).toList();
+    for (const QVariant &v : overrides) {
+        const QVariantMap map = v.toMap();
+        Override o;
+        o.applicationIds = map.value(qSL("applications")).toStringList();
+        o.categories = map.value(qSL("categories")).toStringList();
+        o.thresholds = parseThresholds(map, m_defaultThresholds);
+        if (o.applicationIds.isEmpty() && o.categories.isEmpty()) {
+            qCWarning(LogGraphics) << "Ignoring a UI watchdog override that neither specifies "
+                                      "applications nor categories";
+            continue;
+        }
+        // the patterns are matched against every new client: only compile them once
+        for (const QString &pattern : qAsConst(o.applicationIds))
+            o.applicationIdPatterns << QRegularExpression(QRegularExpression::wildcardToRegularExpression(pattern));
+        m_overrides << o;
+    }
+
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it)
+        updateClient(it.key(), it.value());
+}
+
+PingWatchdog::Thresholds PingWatchdog::thresholds(const QString &applicationId,
+                                                  const QStringList &categories) const
+{
+    if (!applicationId.isEmpty()) {
+        for (const Override &o : m_overrides) {
+            for (int i = 0; i < o.applicationIds.size(); ++i) {
+                if ((o.applicationIds.at(i) == applicationId)
+                        || o.applicationIdPatterns.at(i).match(applicationId).hasMatch()) {
+                    return o.thresholds;
+                }
+            }
+            for (const QString &category : o.categories) {
+                if (categories.contains(category))
+                    return o.thresholds;
+            }
+        }
+    }
+    return m_defaultThresholds;
+}
+
+void PingWatchdog::setClient(QObject *object, bool pingable, const QString &applicationId,
+                             const QStringList &categories)
+{
+    Client &client = m_clients[object];
+    client.pingable = pingable;
+    client.applicationId = applicationId;
+    client.categories = categories;
+    updateClient(object, client);
+}
+
+void PingWatchdog::removeClient(QObject *object)
+{
+    auto it = m_clients.find(object);
+    if (it == m_clients.end())
+        return;
+    if (it->active)
+        setActive(it.value(), false);
+    m_clients.erase(it);
+}
+
+void PingWatchdog::pongReceived(QObject *object)
+{
+    auto it = m_clients.find(object);
+    if ((it == m_clients.end()) || !it->awaitingPong)
+        return;
+
+    it->awaitingPong = false;
+    schedule(object, it.value(), it->thresholds.pingInterval);
+}
+
+bool PingWatchdog::isActive(QObject *object) const
+{
+    return m_clients.value(object).active;
+}
+
+bool PingWatchdog::isAwaitingPong(QObject *object) const
+{
+    return m_clients.value(object).awaitingPong;
+}
+
+void PingWatchdog::updateClient(QObject *object, Client &client)
+{
+    client.thresholds = thresholds(client.applicationId, client.categories);
+
+    const bool active = m_enabled && client.pingable && !client.timedOut
+            && (client.thresholds.pongTimeout > 0);
+    if (active == client.active)
+        return;
+
+    setActive(client, active);
+    if (active)
+        sendPing(object, client);
+}
+
+void PingWatchdog::setActive(Client &client, bool active)
+{
+    client.active = active;
+    if (active) {
+        if (!m_activeCount++)
+            m_tickTimer->start();
+    } else {
+        // the entry on the wheel is dropped lazily, when its slot is processed the next time
+        ++client.generation;
+        client.awaitingPong = false;
+        if (!--m_activeCount)
+            m_tickTimer->stop();
+    }
+}
+
+void PingWatchdog::schedule(QObject *object, Client &client, int msec)
+{
+    const int ticks = qMax(1, (msec + TickInterval - 1) / TickInterval);
+
+    ++client.generation;
+    client.deadline = m_currentTick + quint64(ticks);
+    m_wheel[int(client.deadline % WheelSize)].append({ object, client.generation });
+}
+
+void PingWatchdog::sendPing(QObject *object, Client &client)
+{
+    if (ping(object)) {
+        client.awaitingPong = true;
+        schedule(object, client, client.thresholds.pongTimeout);
+    } else {
+        schedule(object, client, client.thresholds.pingInterval);
+    }
+}
+
+void PingWatchdog::tick()
+{
+    // Deliberately counting ticks instead of measuring the real time: if the System UI itself
+    // was blocked, the clients' pongs are most likely still waiting in our socket.
+    ++m_currentTick;
+
+    QVector<WheelEntry> entries;
+    entries.swap(m_wheel[int(m_currentTick % WheelSize)]);
+
+    for (const WheelEntry &entry : qAsConst(entries)) {
+        auto it = m_clients.find(entry.client);
+        if ((it == m_clients.end()) || !it->active || (it->generation != entry.generation))
+            continue; // stale entry
+
+        if (it->deadline > m_currentTick) {
+            // more than one revolution of the wheel away
+            m_wheel[int(m_currentTick % WheelSize)].append(entry);
+        } else if (it->awaitingPong) {
+            // do not ping this client again: it is either going away or is not managed by us
+            setActive(it.value(), false);
+            it->timedOut = true;
+            // the subclass might remove the client right away
+            pongTimedOut(entry.client, it->thresholds.pongTimeout);
+        } else {
+            sendPing(it.key(), it.value());
+        }
+    }
+}
+
+QT_END_NAMESPACE_AM
+
+#include "moc_pingwatchdog.cpp"
@@ -0,0 +1,108 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#pragma once
+
+#include <QtAppManCommon/global.h>
+#include <QObject>
+#include <QHash>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+
+QT_FORWARD_DECLARE_CLASS(QTimer)
+
+QT_BEGIN_NAMESPACE_AM
+
+// Detects hanging clients via a ping/pong mechanism. This class only does the book-keeping: the
+// actual protocol (sending a ping) and the reaction to a missing pong are implemented by
+// subclasses (see WaylandPingWatchdog).
+// All the ping and pong deadlines are kept on a single, coarse timer wheel, so the number of
+// timers does not depend on the number of clients.
+
+class PingWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Thresholds
+    {
+        int pingInterval = 1000; // msec between a pong and the next ping
+        int pongTimeout = 2000;  // msec until a client is considered to be hanging; 0: disabled
+    };
+
+    explicit PingWatchdog(QObject *parent = nullptr);
+    ~PingWatchdog() override;
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+    void setConfiguration(const QVariantMap &configuration);
+    Thresholds thresholds(const QString &applicationId, const QStringList &categories) const;
+
+    // A client is only pinged while it is pingable (e.g. it has visible content and is not
+    // suspended). The application id and categories are used to find the matching thresholds.
+    void setClient(QObject *client, bool pingable, const QString &applicationId = QString(),
+                   const QStringList &categories = QStringList());
+    void removeClient(QObject *client);
+    void pongReceived(QObject *client);
+
+    bool isActive(QObject *client) const;
+    bool isAwaitingPong(QObject *client) const;
+
+    static constexpr int TickInterval = 100; // msec
+    static constexpr int WheelSize = 64;     // ticks
+
+protected:
+    // returns false, if the client could not be pinged right now: it is retried after pingInterval
+    virtual bool ping(QObject *client) = 0;
+    // the client will not be pinged anymore, until it is removed and added again
+    virtual void pongTimedOut(QObject *client, int pongTimeout) = 0;
+
+    // driven by a timer every TickInterval msec
+    void tick();
+
+private:
+    struct Client
+    {
+        bool pingable = false;
+        bool timedOut = false;
+        QString applicationId;
+        QStringList categories;
+        Thresholds thresholds;
+        bool active = false;
+        bool awaitingPong = false;
+        quint64 deadline = 0;   // tick
+        quint32 generation = 0; // invalidates the entries of previous deadlines on the wheel
+    };
+    struct Override
+    {
+        QStringList applicationIds; // wildcards are allowed
+        QVector<QRegularExpression> applicationIdPatterns;
+        QStringList categories;
+        Thresholds thresholds;
+    };
+    struct WheelEntry
+    {
+        QObject *client;
+        quint32 generation;
+    };
+
+    void updateClient(QObject *object, Client &client);
+    void setActive(Client &client, bool active);
+    void schedule(QObject *object, Client &client, int msec);
+    void sendPing(QObject *object, Client &client);
+
+    bool m_enabled = true;
+    Thresholds m_defaultThresholds;
+    QVector<Override> m_overrides;
+
+    QHash<QObject *, Client> m_clients;
+
+    QVector<QVector<WheelEntry>> m_wheel;
+    quint64 m_currentTick = 0;
+    int m_activeCount = 0;
+    QTimer *m_tickTimer;
+};
+
+QT_END_NAMESPACE_AM
@@ -8,6 +8,7 @@
 #include <QWaylandOutput>
 #include <QWaylandSeat>
 #include <QWaylandKeymap>
+#include <QWaylandClient>
 
 #include "global.h"
 #include "logging.h"
@@ -15,6 +16,7 @@
 #include "application.h"
 #include "applicationmanager.h"
 #include "waylandcompositor.h"
+#include "waylandpingwatchdog.h"
 
 #include <QWaylandWlShell>
 #include <QWaylandXdgShell>
@@ -23,6 +25,7 @@
 #include <QWaylandQtTextInputMethodManager>
 #include <QWaylandQtWindowManager>
 #include "waylandqtamserverextension_p.h"
+#include <private/qwaylandsurface_p.h>
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -30,14 +33,18 @@ WindowSurface::WindowSurface(WaylandCompositor *comp, QWaylandClient *client, ui
     : QWaylandQuickSurface(comp, client, id, version)
     , m_surface(this)
     , m_compositor(comp)
-{ }
+{
+    m_statsTimer.start();
+    connect(this, &QWaylandSurface::redraw, this, &WindowSurface::onCommitted);
+}
 
 void WindowSurface::setShellSurface(QWaylandWlShellSurface *shellSurface)
 {
     Q_ASSERT(!m_xdgSurface);
     m_wlSurface = shellSurface;
-    connect(m_wlSurface, &QWaylandWlShellSurface::pong,
-            this, &WindowSurface::pong);
+    connect(m_wlSurface, &QWaylandWlShellSurface::pong, this, [this]() {
+        m_compositor->watchdog()->pongReceived(client());
+    });
 }
 
 void WindowSurface::sendResizing(const QSize &size)
@@ -94,14 +101,13 @@ QWindow *WindowSurface::outputWindow() const
     return nullptr;
 }
 
-void WindowSurface::ping()
+uint WindowSurface::ping()
 {
-    if (m_xdgSurface) {
-        // FIXME: ping should be done per-application, not per-window
-        m_compositor->xdgPing(this);
-    } else {
-        m_wlSurface->ping();
-    }
+    if (m_xdgSurface)
+        return m_compositor->xdgPing(client());
+
+    m_wlSurface->ping();
+    return 0;
 }
 
 void WindowSurface::close()
@@ -119,6 +125,83 @@ void WindowSurface::close()
     }
 }
 
+QVariantMap WindowSurface::frameStatistics() const
+{
+    const qint64 elapsed = qMax(qint64(1), m_statsTimer.elapsed());
+    const FrameStatistics &s = m_stats;
+
+    return {
+        { qSL("duration"), elapsed },
+        { qSL("commitCount"), s.commits },
+        { qSL("commitRate"), qreal(s.commits) * 1000 / elapsed },
+        { qSL("bufferCount"), s.buffers },
+        { qSL("droppedBuffers"), s.droppedBuffers },
+        { qSL("averageFrameCallbackLatency"),
+          s.latencyCount ? qreal(s.latencySum) / s.latencyCount / 1000 : qreal(0) },
+        { qSL("maximumFrameCallbackLatency"), qreal(s.latencyMax) / 1000 }
+    };
+}
+
+void WindowSurface::resetFrameStatistics()
+{
+    m_stats = { };
+    m_frameCallbackSent = -1;
+    m_bufferPending = false;
+    m_statsTimer.restart();
+}
+
+void WindowSurface::onCommitted()
+{
+    ++m_stats.commits;
+
+    // QWaylandSurface::damaged is emitted for every commit, even if only the damage changed or
+    // nothing at all: a new buffer is detected by the committed wl_buffer changing instead.
+    // (this misses clients that keep re-attaching a single buffer, but every GL client swaps
+    // between at least two of them)
+    const QWaylandBufferRef &buffer = QWaylandSurfacePrivate::get(this)->bufferRef;
+    wl_resource *bufferResource = buffer.hasContent() ? buffer.wl_buffer() : nullptr;
+    if (bufferResource && (bufferResource != m_lastBuffer))
+        onBufferAttached();
+    m_lastBuffer = bufferResource;
+
+    // only the first commit after the frame callbacks have been sent is the client's answer
+    if (m_frameCallbackSent >= 0) {
+        const qint64 latency = m_statsTimer.nsecsElapsed() / 1000 - m_frameCallbackSent;
+        ++m_stats.latencyCount;
+        m_stats.latencySum += latency;
+        m_stats.latencyMax = qMax(m_stats.latencyMax, latency);
+        m_frameCallbackSent = -1;
+    }
+}
+
+void WindowSurface::onBufferAttached()
+{
+    ++m_stats.buffers;
+    if (m_bufferPending)
+        ++m_stats.droppedBuffers;
+    m_bufferPending = true;
+
+    // QWaylandQuickOutput sends the frame callbacks right after the output window swapped
+    auto window = qobject_cast<QQuickWindow *>(outputWindow());
+    if (window != m_statsWindow) {
+        disconnect(m_frameSwappedConnection);
+        m_statsWindow = window;
+        if (window) {
+            m_frameSwappedConnection = connect(window, &QQuickWindow::frameSwapped,
+                                               this, &WindowSurface::onOutputFrameSwapped);
+        }
+    }
+}
+
+void WindowSurface::onOutputFrameSwapped()
+{
+    // Only a client that had a new buffer presented is actively rendering and thus is expected
+    // to answer the frame callback right away. Idle clients would just skew the latency.
+    if (m_bufferPending)
+        m_frameCallbackSent = m_statsTimer.nsecsElapsed() / 1000;
+    m_bufferPending = false;
+}
+
 WaylandCompositor::WaylandCompositor(QQuickWindow *window, const QString &waylandSocketName)
     : QWaylandQuickCompositor()
     , m_wlShell(new QWaylandWlShell(this))
@@ -126,6 +209,7 @@ WaylandCompositor::WaylandCompositor(QQuickWindow *window, const QString &waylan
     , m_amExtension(new WaylandQtAMServerExtension(this))
     , m_qtTextInputMethodManager(new QWaylandQtTextInputMethodManager(this))
     , m_textInputManager(new QWaylandTextInputManager(this))
+    , m_watchdog(new WaylandPingWatchdog(this))
 {
     // We are instantiating both the semi-official TextInputManager protocol (which has some
     // traction upstream, but also has known defects) and our own QtTextInputMethodManager
@@ -172,18 +256,14 @@ WaylandCompositor::~WaylandCompositor()
     delete defaultSeat();
 }
 
-void WaylandCompositor::xdgPing(WindowSurface* surface)
+uint WaylandCompositor::xdgPing(QWaylandClient *client)
 {
-    uint serial = m_xdgShell->ping(surface->client());
-    m_xdgPingMap[serial] = surface;
+    return m_xdgShell->ping(client);
 }
 
 void WaylandCompositor::onXdgPongReceived(uint serial)
 {
-    auto surface = m_xdgPingMap.take(serial);
-    if (surface) {
-        emit surface->pong();
-    }
+    m_watchdog->xdgPongReceived(serial);
 }
 
 void WaylandCompositor::registerOutputWindow(QQuickWindow* window)
@@ -199,6 +279,11 @@ WaylandQtAMServerExtension *WaylandCompositor::amExtension()
     return m_amExtension;
 }
 
+WaylandPingWatchdog *WaylandCompositor::watchdog()
+{
+    return m_watchdog;
+}
+
 void WaylandCompositor::doCreateSurface(QWaylandClient *client, uint id, int version)
 {
     (void) new WindowSurface(this, client, id, version);
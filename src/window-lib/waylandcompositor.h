@@ -15,6 +15,7 @@
 #include <QWaylandQuickSurface>
 #include <QWaylandQuickItem>
 
+#include <QElapsedTimer>
 #include <QMap>
 #include <QPointer>
 
@@ -29,10 +30,13 @@ QT_FORWARD_DECLARE_CLASS(QWaylandXdgSurface)
 QT_FORWARD_DECLARE_CLASS(QWaylandXdgToplevel)
 QT_FORWARD_DECLARE_CLASS(QWaylandXdgPopup)
 
+struct wl_resource;
+
 
 QT_BEGIN_NAMESPACE_AM
 
 class WaylandCompositor;
+class WaylandPingWatchdog;
 class WaylandQtAMServerExtension;
 class WindowSurfaceQuickItem;
 
@@ -64,16 +68,21 @@ public:
     qint64 processId() const;
     QWindow *outputWindow() const;
 
-    void ping();
+    uint ping(); // returns the serial for xdg-shell surfaces
     void close();
 
+    QVariantMap frameStatistics() const;
+    void resetFrameStatistics();
+
 signals:
-    void pong();
     void popupGeometryChanged();
     void xdgSurfaceChanged();
 
 private:
     void setShellSurface(QWaylandWlShellSurface *ss);
+    void onCommitted();
+    void onBufferAttached();
+    void onOutputFrameSwapped();
 
 private:
     QWaylandSurface *m_surface;
@@ -84,6 +93,22 @@ private:
     QWaylandXdgToplevel *m_topLevel = nullptr;
     QWaylandXdgPopup *m_popup = nullptr;
 
+    // frame pacing statistics
+    struct FrameStatistics {
+        quint64 commits = 0;
+        quint64 buffers = 0;
+        quint64 droppedBuffers = 0;  // replaced before the compositor presented them
+        quint64 latencyCount = 0;
+        qint64 latencySum = 0;       // usec
+        qint64 latencyMax = 0;       // usec
+    } m_stats;
+    QElapsedTimer m_statsTimer;
+    qint64 m_frameCallbackSent = -1; // usec since m_statsTimer was started
+    bool m_bufferPending = false;
+    wl_resource *m_lastBuffer = nullptr; // only used for comparisons: it might be gone already
+    QPointer<QQuickWindow> m_statsWindow;
+    QMetaObject::Connection m_frameSwappedConnection;
+
     friend class WaylandCompositor;
 };
 
@@ -97,8 +122,9 @@ public:
     void registerOutputWindow(QQuickWindow *window);
 
     WaylandQtAMServerExtension *amExtension();
+    WaylandPingWatchdog *watchdog();
 
-    void xdgPing(WindowSurface*);
+    uint xdgPing(QWaylandClient *client);
 
 signals:
     void surfaceMapped(QT_PREPEND_NAMESPACE_AM(WindowSurface) *surface);
@@ -117,7 +143,7 @@ protected:
     WaylandQtAMServerExtension *m_amExtension;
     QWaylandQtTextInputMethodManager *m_qtTextInputMethodManager;
     QWaylandTextInputManager *m_textInputManager;
-    QMap<uint, QPointer<WindowSurface>> m_xdgPingMap;
+    WaylandPingWatchdog *m_watchdog;
 };
 
 QT_END_NAMESPACE_AM
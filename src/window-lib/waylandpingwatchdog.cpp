@@ -0,0 +1,150 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "global.h"
+#if defined(AM_MULTI_PROCESS)
+#include <QWaylandClient>
+
+#include "logging.h"
+#include "application.h"
+#include "applicationmanager.h"
+#include "waylandcompositor.h"
+#include "waylandwindow.h"
+#include "waylandpingwatchdog.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+WaylandPingWatchdog::WaylandPingWatchdog(QObject *parent)
+    : PingWatchdog(parent)
+{ }
+
+WaylandPingWatchdog::~WaylandPingWatchdog()
+{ }
+
+void WaylandPingWatchdog::addWindow(WaylandWindow *window)
+{
+    QWaylandClient *waylandClient = window->surface() ? window->surface()->client() : nullptr;
+    if (!waylandClient)
+        return;
+
+    Client &client = m_clients[waylandClient];
+    if (!client.windows.contains(window))
+        client.windows.append(window);
+    updateClient(waylandClient, client);
+}
+
+void WaylandPingWatchdog::removeWindow(WaylandWindow *window)
+{
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if (it->windows.removeOne(window)) {
+            if (it->windows.isEmpty()) {
+                QWaylandClient *waylandClient = it.key();
+                forgetXdgSerial(it.value());
+                m_clients.erase(it);
+                removeClient(waylandClient);
+            } else {
+                updateClient(it.key(), it.value());
+            }
+            return;
+        }
+    }
+}
+
+void WaylandPingWatchdog::updateWindow(WaylandWindow *window)
+{
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if (it->windows.contains(window)) {
+            updateClient(it.key(), it.value());
+            return;
+        }
+    }
+}
+
+void WaylandPingWatchdog::xdgPongReceived(uint serial)
+{
+    if (QWaylandClient *waylandClient = m_xdgSerials.take(serial)) {
+        auto it = m_clients.find(waylandClient);
+        if (it != m_clients.end())
+            it->xdgSerial = 0;
+        pongReceived(waylandClient);
+    }
+}
+
+void WaylandPingWatchdog::updateClient(QWaylandClient *waylandClient, const Client &client)
+{
+    const Application *app = nullptr;
+    bool hasContent = false;
+
+    for (const WaylandWindow *window : client.windows) {
+        if (!app)
+            app = window->application();
+        if (window->surface() && window->surface()->hasContent())
+            hasContent = true;
+    }
+    // frozen applications cannot answer pings: pause the watchdog while they are suspended
+    const bool suspended = app && (app->runState() == Am::Suspended);
+
+    setClient(waylandClient, hasContent && !suspended, app ? app->id() : QString(),
+              app ? app->categories() : QStringList());
+}
+
+void WaylandPingWatchdog::forgetXdgSerial(Client &client)
+{
+    if (client.xdgSerial) {
+        m_xdgSerials.remove(client.xdgSerial);
+        client.xdgSerial = 0;
+    }
+}
+
+bool WaylandPingWatchdog::ping(QObject *object)
+{
+    auto *waylandClient = static_cast<QWaylandClient *>(object);
+    auto it = m_clients.find(waylandClient);
+    if (it == m_clients.end())
+        return false;
+
+    WindowSurface *surface = nullptr;
+    for (const WaylandWindow *window : qAsConst(it->windows)) {
+        if ((surface = window->surface()))
+            break;
+    }
+    if (!surface)
+        return false;
+
+    forgetXdgSerial(it.value());
+    it->xdgSerial = surface->ping();
+    if (it->xdgSerial)
+        m_xdgSerials.insert(it->xdgSerial, waylandClient);
+    return true;
+}
+
+void WaylandPingWatchdog::pongTimedOut(QObject *object, int pongTimeout)
+{
+    auto *waylandClient = static_cast<QWaylandClient *>(object);
+    Application *app = nullptr;
+
+    auto it = m_clients.find(waylandClient);
+    if (it != m_clients.end()) {
+        forgetXdgSerial(it.value());
+        for (const WaylandWindow *window : qAsConst(it->windows)) {
+            if ((app = window->application()))
+                break;
+        }
+    }
+
+    if (!app) {
+        qCWarning(LogGraphics) << "The unknown Wayland client with pid" << waylandClient->processId()
+                               << "did not send a Wayland-Pong for" << pongTimeout << "msec";
+        return;
+    }
+
+    qCCritical(LogGraphics) << "Stopping application" << app->id() << "because we did not receive a Wayland-Pong for"
+                            << pongTimeout << "msec";
+    ApplicationManager::instance()->stopApplicationInternal(app, true);
+}
+
+QT_END_NAMESPACE_AM
+
+#endif // AM_MULTI_PROCESS
+
+#include "moc_waylandpingwatchdog.cpp"
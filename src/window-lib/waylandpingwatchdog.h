@@ -0,0 +1,57 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#pragma once
+
+#include <QtAppManCommon/global.h>
+
+#if defined(AM_MULTI_PROCESS)
+
+#include <QHash>
+#include <QVector>
+#include <QtAppManWindow/pingwatchdog.h>
+
+QT_FORWARD_DECLARE_CLASS(QWaylandClient)
+
+QT_BEGIN_NAMESPACE_AM
+
+class WaylandWindow;
+
+// Detects hanging UI clients via the Wayland ping/pong mechanism. Pings are sent per client,
+// not per window: a client with multiple windows or popups is pinged once per interval only.
+
+class WaylandPingWatchdog : public PingWatchdog
+{
+    Q_OBJECT
+
+public:
+    explicit WaylandPingWatchdog(QObject *parent = nullptr);
+    ~WaylandPingWatchdog() override;
+
+    void addWindow(WaylandWindow *window);
+    void removeWindow(WaylandWindow *window);
+    void updateWindow(WaylandWindow *window);
+
+    void xdgPongReceived(uint serial);
+
+protected:
+    bool ping(QObject *client) override;
+    void pongTimedOut(QObject *client, int pongTimeout) override;
+
+private:
+    struct Client
+    {
+        QVector<WaylandWindow *> windows;
+        uint xdgSerial = 0;
+    };
+
+    void updateClient(QWaylandClient *waylandClient, const Client &client);
+    void forgetXdgSerial(Client &client);
+
+    QHash<QWaylandClient *, Client> m_clients;
+    QHash<uint, QWaylandClient *> m_xdgSerials;
+};
+
+QT_END_NAMESPACE_AM
+
+#endif // AM_MULTI_PROCESS
@@ -12,23 +12,18 @@
 #include "windowmanager.h"
 #include "waylandwindow.h"
 #include "waylandcompositor.h"
+#include "waylandpingwatchdog.h"
 #include "waylandqtamserverextension_p.h"
 
 #include <QWaylandWlShellSurface>
 
 QT_BEGIN_NAMESPACE_AM
 
-bool WaylandWindow::m_watchdogEnabled = true;
-
 WaylandWindow::WaylandWindow(Application *app, WindowSurface *surf)
     : Window(app)
-    , m_pingTimer(new QTimer(this))
-    , m_pongTimer(new QTimer(this))
     , m_surface(surf)
 {
     if (surf) {
-        connect(surf, &WindowSurface::pong,
-                this, &WaylandWindow::pongReceived);
         connect(m_surface, &QWaylandSurface::hasContentChanged, this, &WaylandWindow::onContentStateChanged);
 #if QT_VERSION < QT_VERSION_CHECK(5, 13, 0)
         connect(m_surface, &QWaylandSurface::sizeChanged, this, &Window::sizeChanged);
@@ -36,13 +31,6 @@ WaylandWindow::WaylandWindow(Application *app, WindowSurface *surf)
         connect(m_surface, &QWaylandSurface::bufferSizeChanged, this, &Window::sizeChanged);
 #endif
 
-        m_pingTimer->setInterval(1000);
-        m_pingTimer->setSingleShot(true);
-        connect(m_pingTimer, &QTimer::timeout, this, &WaylandWindow::pingTimeout);
-        m_pongTimer->setInterval(2000);
-        m_pongTimer->setSingleShot(true);
-        connect(m_pongTimer, &QTimer::timeout, this, &WaylandWindow::pongTimeout);
-
         connect(surf->compositor()->amExtension(), &WaylandQtAMServerExtension::windowPropertyChanged,
                 this, [this](QWaylandSurface *surface, const QString &name, const QVariant &value) {
             if (surface == m_surface) {
@@ -52,6 +40,8 @@ WaylandWindow::WaylandWindow(Application *app, WindowSurface *surf)
         });
 
         connect(surf, &QWaylandSurface::surfaceDestroyed, this, [this]() {
+            if (m_watchdog)
+                m_watchdog->removeWindow(this);
             m_surface = nullptr;
             onContentStateChanged();
             emit waylandSurfaceChanged();
@@ -70,31 +60,24 @@ WaylandWindow::WaylandWindow(Application *app, WindowSurface *surf)
         connect(m_surface, &WindowSurface::xdgSurfaceChanged,
                 this, &WaylandWindow::waylandXdgSurfaceChanged);
 
-        enableOrDisablePing();
-    }
-}
-
-void WaylandWindow::pongReceived()
-{
-    m_pongTimer->stop();
-    m_pingTimer->start();
-}
+        // the watchdog pings per client, so it needs to know about all of the client's windows
+        m_watchdog = surf->compositor()->watchdog();
+        m_watchdog->addWindow(this);
 
-void WaylandWindow::pongTimeout()
-{
-    if (!application())
-        return;
-
-    qCCritical(LogGraphics) << "Stopping application" << application()->id() << "because we did not receive a Wayland-Pong for" << m_pongTimer->interval() << "msec";
-    ApplicationManager::instance()->stopApplicationInternal(application(), true);
+        // frozen applications cannot answer pings: the watchdog pauses while they are suspended
+        if (app) {
+            connect(app, &Application::runStateChanged, this, [this]() {
+                if (m_watchdog)
+                    m_watchdog->updateWindow(this);
+            });
+        }
+    }
 }
 
-void WaylandWindow::pingTimeout()
+WaylandWindow::~WaylandWindow()
 {
-    m_pingTimer->stop();
-    m_pongTimer->start();
-    if (m_surface)
-        m_surface->ping();
+    if (m_watchdog)
+        m_watchdog->removeWindow(this);
 }
 
 bool WaylandWindow::setWindowProperty(const QString &name, const QVariant &value)
@@ -132,22 +115,12 @@ Window::ContentState WaylandWindow::contentState() const
         return NoSurface;
 }
 
-void WaylandWindow::enableOrDisablePing()
-{
-    if (m_watchdogEnabled) {
-        m_pingTimer->stop();
-        m_pongTimer->stop();
-
-        if (m_surface && m_surface->hasContent())
-            pingTimeout();
-    }
-}
-
 void WaylandWindow::onContentStateChanged()
 {
     qCDebug(LogGraphics) << this << "of" << applicationId() << "contentState changed to" << contentState();
 
-    enableOrDisablePing();
+    if (m_watchdog)
+        m_watchdog->updateWindow(this);
     emit contentStateChanged();
 }
 
@@ -181,6 +154,17 @@ void WaylandWindow::resize(const QSize &newSize)
     m_surface->sendResizing(newSize);
 }
 
+QVariantMap WaylandWindow::frameStatistics() const
+{
+    return m_surface ? m_surface->frameStatistics() : QVariantMap { };
+}
+
+void WaylandWindow::resetFrameStatistics()
+{
+    if (m_surface)
+        m_surface->resetFrameStatistics();
+}
+
 QWaylandQuickSurface* WaylandWindow::waylandSurface() const
 {
     return m_surface;
@@ -11,11 +11,12 @@
 
 #include <QWaylandQuickSurface>
 #include <QWaylandXdgShell>
-#include <QTimer>
+#include <QPointer>
 
 QT_BEGIN_NAMESPACE_AM
 
 class WindowSurface;
+class WaylandPingWatchdog;
 
 class WaylandWindow : public Window
 {
@@ -25,6 +26,7 @@ class WaylandWindow : public Window
 
 public:
     WaylandWindow(Application *app, WindowSurface *surface);
+    ~WaylandWindow() override;
 
     bool isInProcess() const override { return false; }
 
@@ -42,29 +44,25 @@ public:
     QSize size() const override;
     void resize(const QSize &size) override;
 
+    QVariantMap frameStatistics() const override;
+    void resetFrameStatistics() override;
+
     WindowSurface *surface() const { return m_surface; }
 
     QWaylandQuickSurface *waylandSurface() const;
     QWaylandXdgSurface *waylandXdgSurface() const;
 
-    static bool m_watchdogEnabled;
-
 signals:
     void waylandSurfaceChanged();
     void waylandXdgSurfaceChanged();
 
 private slots:
-    void pongReceived();
-    void pongTimeout();
-    void pingTimeout();
     void onContentStateChanged();
 
 private:
     QString applicationId() const;
 
-    void enableOrDisablePing();
-    QTimer *m_pingTimer;
-    QTimer *m_pongTimer;
+    QPointer<WaylandPingWatchdog> m_watchdog;
     WindowSurface *m_surface;
     QVariantMap m_windowProperties;
 };
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
 #include "window.h"
+#include "windowthumbnailer.h"
 
 /*!
     \qmltype WindowObject
@@ -61,6 +62,58 @@
     \sa WindowObject::size, WindowItem::objectFollowsItemSize
 */
 
+/*!
+    \qmlmethod var WindowObject::frameStatistics()
+
+    Returns an object with statistics on how well the client application is pacing its frames,
+    counted since the window's surface was created or resetFrameStatistics() was last called.
+    This helps with finding the application that is starving the compositor.
+
+    The object has the following fields:
+
+    \table
+    \header
+        \li Name
+        \li Description
+    \row
+        \li \c duration
+        \li The time in milliseconds that these statistics have been collected for.
+    \row
+        \li \c commitCount
+        \li The number of surface commits.
+    \row
+        \li \c commitRate
+        \li The average number of surface commits per second.
+    \row
+        \li \c bufferCount
+        \li The number of new buffers the client has committed. Commits that only damage the
+             current buffer again are not counted.
+    \row
+        \li \c droppedBuffers
+        \li The number of buffers that were replaced by a newer one before the compositor could
+             present them.
+    \row
+        \li \c averageFrameCallbackLatency
+        \li The average time in milliseconds between the compositor sending a frame callback and
+             the client committing its next frame.
+    \row
+        \li \c maximumFrameCallbackLatency
+        \li The longest time in milliseconds between the compositor sending a frame callback and
+             the client committing its next frame.
+    \endtable
+
+    In single-process mode, or if the window does not have a surface (anymore), an empty object is
+    returned.
+
+    \sa resetFrameStatistics(), WindowManager::frameStatistics()
+*/
+
+/*!
+    \qmlmethod WindowObject::resetFrameStatistics()
+
+    Resets all the counters reported by frameStatistics().
+*/
+
 /*!
     \qmlproperty enumeration WindowObject::contentState
     \readonly
@@ -146,11 +199,34 @@
 
     \sa popup
 */
+/*!
+    \qmlproperty url WindowObject::thumbnail
+    \readonly
+
+    An image url pointing to a downscaled snapshot of this window's content, suitable for an
+    \l Image in a task switcher. Using this image instead of a live WindowItem avoids rendering
+    the full window every frame.
+
+    The snapshot is only taken while the image is being used, and it is only refreshed after the
+    content of the window has changed. In-process windows do not provide any information about
+    changed content, so their snapshot is refreshed continuously while the image is being used.
+    The refresh rate and the maximum size can be set via
+    WindowManager::thumbnailRefreshRate and WindowManager::thumbnailSize. The url changes
+    every time a new snapshot is available.
+
+    The window needs to be displayed by at least one WindowItem to be captured: a window that is
+    not shown anywhere keeps its last snapshot. Until the first snapshot has been taken, the image
+    is fully transparent.
+*/
 QT_BEGIN_NAMESPACE_AM
 
+// windows are only ever created on the GUI thread
+static quint64 s_nextWindowId = 0;
+
 Window::Window(Application *app)
     : QObject()
     , m_application(app)
+    , m_id(++s_nextWindowId)
 {
 }
 
@@ -187,6 +263,26 @@ bool Window::isBeingDisplayed() const
     return m_items.count() > 0;
 }
 
+QVariantMap Window::frameStatistics() const
+{
+    return { };
+}
+
+void Window::resetFrameStatistics()
+{ }
+
+QUrl Window::thumbnail() const
+{
+    return QUrl(qSL("image://%1/%2/%3").arg(qL1S(WindowThumbnailer::providerId()))
+                .arg(m_id).arg(m_thumbnailVersion));
+}
+
+void Window::updateThumbnail()
+{
+    ++m_thumbnailVersion;
+    emit thumbnailChanged();
+}
+
 QT_END_NAMESPACE_AM
 
 #include "moc_window.cpp"
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <QObject>
+#include <QUrl>
 #include <QVariantMap>
 #include <QPointer>
 #include <QQuickItem>
@@ -32,6 +33,7 @@ class Window : public QObject
     Q_PROPERTY(Application* application READ application CONSTANT)
     Q_PROPERTY(bool popup READ isPopup CONSTANT)
     Q_PROPERTY(QPoint requestedPopupPosition READ requestedPopupPosition NOTIFY requestedPopupPositionChanged)
+    Q_PROPERTY(QUrl thumbnail READ thumbnail NOTIFY thumbnailChanged)
 
 public:
 
@@ -48,6 +50,9 @@ public:
     virtual bool isInProcess() const = 0;
     virtual Application *application() const;
 
+    // A unique, never re-used number; used as a key in caches that might outlive this object
+    quint64 id() const { return m_id; }
+
     // Controls how many items (which are views from a model-view perspective) are currently rendering this window
     void registerItem(WindowItem *item);
     void unregisterItem(WindowItem *item);
@@ -75,18 +80,30 @@ public:
     virtual QSize size() const = 0;
     Q_INVOKABLE virtual void resize(const QSize &size) = 0;
 
+    // Only Wayland clients are rendering asynchronously to the compositor
+    Q_INVOKABLE virtual QVariantMap frameStatistics() const;
+    Q_INVOKABLE virtual void resetFrameStatistics();
+
+    QUrl thumbnail() const;
+    void updateThumbnail();
+
 signals:
     void sizeChanged();
     void windowPropertyChanged(const QString &name, const QVariant &value);
     void isBeingDisplayedChanged();
     void contentStateChanged();
     void requestedPopupPositionChanged();
+    void thumbnailChanged();
 
 protected:
     QPointer<Application> m_application;
 
     QSet<WindowItem*> m_items;
     WindowItem *m_primaryItem{nullptr};
+
+private:
+    quint64 m_id;
+    int m_thumbnailVersion = 0;
 };
 
 QT_END_NAMESPACE_AM
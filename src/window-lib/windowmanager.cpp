@@ -8,10 +8,13 @@
 #include <QQuickView>
 #include <QQuickItem>
 #include <QQuickItemGrabResult>
+#include <QImageWriter>
+#include <QThreadPool>
 #include <QQmlEngine>
 #include <QVariant>
 #include <QMetaObject>
 #include <QThread>
+#include <QTimer>
 #include <QQmlComponent>
 #include <private/qabstractanimation_p.h>
 #include <QLocalServer>
@@ -19,6 +22,7 @@
 
 #if defined(AM_MULTI_PROCESS)
 #  include "waylandcompositor.h"
+#  include "waylandpingwatchdog.h"
 #  include <private/qwaylandcompositor_p.h>
 #endif
 
@@ -31,6 +35,7 @@
 #include "windowitem.h"
 #include "windowmanager.h"
 #include "windowmanager_p.h"
+#include "windowthumbnailer.h"
 #include "waylandwindow.h"
 #include "inprocesswindow.h"
 #include "qml-utilities.h"
@@ -323,6 +328,46 @@ void WindowManager::setAllowUnknownUiClients(bool enable)
     d->allowUnknownUiClients = enable;
 }
 
+/*!
+    \qmlproperty size WindowManager::thumbnailSize
+
+    The maximum size of the snapshots provided by WindowObject::thumbnail. The aspect ratio of the
+    window is preserved. The default is 256x256 pixels.
+*/
+QSize WindowManager::thumbnailSize() const
+{
+    return d->thumbnailer->size();
+}
+
+void WindowManager::setThumbnailSize(const QSize &size)
+{
+    if (size == d->thumbnailer->size())
+        return;
+    d->thumbnailer->setSize(size);
+    if (d->thumbnailer->size() == size)
+        emit thumbnailSizeChanged();
+}
+
+/*!
+    \qmlproperty real WindowManager::thumbnailRefreshRate
+
+    The maximum number of times per second a WindowObject::thumbnail snapshot is refreshed, while
+    the content of the window keeps changing. The default is \c 2.
+*/
+qreal WindowManager::thumbnailRefreshRate() const
+{
+    return d->thumbnailer->refreshRate();
+}
+
+void WindowManager::setThumbnailRefreshRate(qreal refreshRate)
+{
+    if (qFuzzyCompare(refreshRate, d->thumbnailer->refreshRate()))
+        return;
+    d->thumbnailer->setRefreshRate(refreshRate);
+    if (qFuzzyCompare(refreshRate, d->thumbnailer->refreshRate()))
+        emit thumbnailRefreshRateChanged();
+}
+
 void WindowManager::updateViewSlowMode(QQuickWindow *view)
 {
     // QUnifiedTimer are thread-local. To also slow down animations running in the SG thread
@@ -358,6 +403,10 @@ WindowManager::WindowManager(QQmlEngine *qmlEngine, const QString &waylandSocket
 
     d->qmlEngine = qmlEngine;
 
+    d->thumbnailer = new WindowThumbnailer(this);
+    if (qmlEngine)
+        qmlEngine->addImageProvider(qL1S(WindowThumbnailer::providerId()), d->thumbnailer->createImageProvider());
+
     qApp->installEventFilter(this);
 }
 
@@ -365,6 +414,9 @@ WindowManager::~WindowManager()
 {
     qApp->removeEventFilter(this);
 
+    // waits for all the screenshots to be written
+    delete d->screenshotPool;
+
 #if defined(AM_MULTI_PROCESS)
     delete d->waylandCompositor;
 #endif
@@ -374,10 +426,19 @@ WindowManager::~WindowManager()
 
 void WindowManager::enableWatchdog(bool enable)
 {
+    d->watchdogEnabled = enable;
 #if defined(AM_MULTI_PROCESS)
-    WaylandWindow::m_watchdogEnabled = enable;
-#else
-    Q_UNUSED(enable);
+    if (d->waylandCompositor)
+        d->waylandCompositor->watchdog()->setEnabled(enable);
+#endif
+}
+
+void WindowManager::setWatchdogConfiguration(const QVariantMap &configuration)
+{
+    d->watchdogConfiguration = configuration;
+#if defined(AM_MULTI_PROCESS)
+    if (d->waylandCompositor)
+        d->waylandCompositor->watchdog()->setConfiguration(configuration);
 #endif
 }
 
@@ -509,10 +570,10 @@ Window *WindowManager::window(int index) const
 QList<QObject *> WindowManager::windowsOfApplication(const QString &id) const
 {
     QList<QObject *> result;
-    for (Window *window : d->windowsInModel) {
-        if (window->application() && window->application()->id() == id)
-            result << window;
-    }
+    const auto windows = d->modelWindowsOfApplication.value(id);
+    result.reserve(windows.size());
+    for (Window *window : windows)
+        result << window;
     return result;
 }
 
@@ -524,7 +585,7 @@ QList<QObject *> WindowManager::windowsOfApplication(const QString &id) const
  */
 int WindowManager::indexOfWindow(Window *window) const
 {
-    return d->windowsInModel.indexOf(window);
+    return d->modelIndexOfWindow.value(window, -1);
 }
 
 /*!
@@ -604,6 +665,8 @@ void WindowManager::releaseWindow(Window *window)
         return;
 
     d->allWindows.removeAt(index);
+    d->removeFromIndices(window);
+    d->thumbnailer->removeWindow(window);
 
     disconnect(window, nullptr, this, nullptr);
 
@@ -619,6 +682,9 @@ void WindowManager::releaseWindow(Window *window)
 void WindowManager::addWindow(Window *window)
 {
     beginInsertRows(QModelIndex(), d->windowsInModel.count(), d->windowsInModel.count());
+    d->modelIndexOfWindow.insert(window, d->windowsInModel.count());
+    if (window->application())
+        d->modelWindowsOfApplication[window->application()->id()].append(window);
     d->windowsInModel << window;
     endInsertRows();
     emit countChanged();
@@ -630,7 +696,7 @@ void WindowManager::addWindow(Window *window)
  */
 void WindowManager::removeWindow(Window *window)
 {
-    int index = d->windowsInModel.indexOf(window);
+    int index = indexOfWindow(window);
     if (index == -1)
         return;
 
@@ -638,6 +704,18 @@ void WindowManager::removeWindow(Window *window)
 
     beginRemoveRows(QModelIndex(), index, index);
     d->windowsInModel.removeAt(index);
+    d->modelIndexOfWindow.remove(window);
+    for (int i = index; i < d->windowsInModel.count(); ++i)
+        d->modelIndexOfWindow[d->windowsInModel.at(i)] = i;
+    if (window->application()) {
+        const QString id = window->application()->id();
+        auto it = d->modelWindowsOfApplication.find(id);
+        if (it != d->modelWindowsOfApplication.end()) {
+            it->removeOne(window);
+            if (it->isEmpty())
+                d->modelWindowsOfApplication.erase(it);
+        }
+    }
     endRemoveRows();
     emit countChanged();
 }
@@ -667,6 +745,8 @@ void WindowManager::registerCompositorView(QQuickWindow *view)
             d->waylandCompositor = new WaylandCompositor(view, d->waylandSocketName);
             for (const auto &extraSocket : d->extraWaylandSockets)
                 d->waylandCompositor->addSocketDescriptor(extraSocket);
+            d->waylandCompositor->watchdog()->setEnabled(d->watchdogEnabled);
+            d->waylandCompositor->watchdog()->setConfiguration(d->watchdogConfiguration);
 
             connect(d->waylandCompositor, &QWaylandCompositor::surfaceCreated,
                     this, &WindowManager::waylandSurfaceCreated);
@@ -717,13 +797,11 @@ void WindowManager::inProcessSurfaceItemCreated(QSharedPointer<InProcessSurfaceI
     }
 
     //Only create a new Window if we don't have it already in the window list, as the user controls whether windows are removed or not
-    int index = d->findWindowBySurfaceItem(surfaceItem.data());
-    if (index == -1) {
+    Window *window = d->findWindowBySurfaceItem(surfaceItem.data());
+    if (!window)
         setupWindow(new InProcessWindow(app, surfaceItem));
-    } else {
-        auto window = qobject_cast<InProcessWindow*>(d->allWindows.at(index));
-        window->setContentState(Window::SurfaceWithContent);
-    }
+    else
+        static_cast<InProcessWindow *>(window)->setContentState(Window::SurfaceWithContent);
 }
 
 /*! \internal
@@ -773,7 +851,19 @@ void WindowManager::setupWindow(Window *window)
         }
     }, Qt::QueuedConnection);
 
+#if defined(AM_MULTI_PROCESS)
+    if (!window->isInProcess()) {
+        if (WindowSurface *surface = static_cast<WaylandWindow *>(window)->surface()) {
+            connect(surface, &QWaylandSurface::surfaceDestroyed, this, [this, surface]() {
+                d->windowsByWaylandSurface.remove(surface);
+            });
+        }
+    }
+#endif
+
     d->allWindows << window;
+    d->addToIndices(window);
+    d->thumbnailer->addWindow(window);
     addWindow(window);
 }
 
@@ -823,8 +913,7 @@ void WindowManager::waylandSurfaceMapped(WindowSurface *surface)
 
     // Only create a new Window if we don't have it already in the window list, as the user controls
     // whether windows are removed or not
-    int index = d->findWindowByWaylandSurface(surface->surface());
-    if (index == -1) {
+    if (!d->findWindowByWaylandSurface(surface->surface())) {
         WaylandWindow *w = new WaylandWindow(app, surface);
         setupWindow(w);
     }
@@ -890,13 +979,68 @@ void WindowManager::waylandSurfaceMapped(WindowSurface *surface)
     com.pelagicore.*[type=cluster]:1
     \endcode
 
-    Returns \c true on success and \c false otherwise.
+    Returns \c true, if at least one screen or window matched the \a selector and capturing it
+    was started, and \c false otherwise.
+
+    \note The images are captured and saved asynchronously, so \c true does not mean that all the
+          screenshot images have been written already, nor that writing them succeeded. Failures
+          are only logged: use requestScreenshot() and its screenshotFinished() signal to get
+          notified when the images have been written and whether that succeeded.
 
-    \note This call will be handled asynchronously, so even a positive return value does not mean
-          that all screenshot images have been created already.
+    \sa requestScreenshot()
 */
-//TODO: either change return value to list of to-be-created filenames or add a 'finished' signal
 bool WindowManager::makeScreenshot(const QString &filename, const QString &selector)
+{
+    return requestScreenshot(filename, selector, { }) != 0;
+}
+
+/*!
+    \qmlmethod int WindowManager::requestScreenshot(string filename, string selector, var options)
+
+    Creates one or several screenshots like makeScreenshot(), using the given \a filename and
+    \a selector. The screens or windows are captured right away, but the images are encoded and
+    written to disk on a pool of worker threads, in order to not block the System UI.
+
+    The \a options object supports these fields:
+
+    \table
+    \header
+        \li Name
+        \li Description
+    \row
+        \li \c format
+        \li The image format, e.g. \c png, \c jpg, or an uncompressed one like \c bmp or \c ppm.
+             If not set, the format is derived from the file name's suffix.
+    \row
+        \li \c quality
+        \li The quality in the range 0 to 100 as in QImageWriter::setQuality(). For \c png, this
+             selects the compression level, with \c 100 being the fastest, uncompressed variant.
+    \row
+        \li \c compression
+        \li The format specific compression value as in QImageWriter::setCompression().
+    \endtable
+
+    Returns an id for this request, or \c 0 if the request failed or nothing matched the
+    \a selector. The screenshotFinished() signal is emitted with this id, after all the images of
+    this request have been written. Capturing a window that does not get rendered (e.g. because
+    it is hidden) fails after 5 seconds.
+
+    This function is also available via D-Bus.
+
+    \sa makeScreenshot(), screenshotFinished()
+*/
+
+/*!
+    \qmlsignal WindowManager::screenshotFinished(int requestId, bool success, list<string> files)
+
+    This signal is emitted, when all the images of the screenshot request \a requestId have been
+    written. The \a files are the names of the files that were written successfully, while
+    \a success is only \c true if all of them could be captured and saved.
+
+    \sa requestScreenshot()
+*/
+uint WindowManager::requestScreenshot(const QString &filename, const QString &selector,
+                                      const QVariantMap &options)
 {
     // filename:
     // %s -> screenId
@@ -949,86 +1093,224 @@ bool WindowManager::makeScreenshot(const QString &filename, const QString &selec
     // qWarning() << "  attributeName :" << attributeName;
     // qWarning() << "  attributeValue:" << attributeValue;
 
-    bool result = true;
+    WindowManagerPrivate::ScreenshotRequest request;
+    request.format = options.value(qSL("format")).toString().toLatin1().toLower();
+    request.quality = options.value(qSL("quality"), -1).toInt();
+    request.compression = options.value(qSL("compression"), -1).toInt();
+
+    if (!request.format.isEmpty() && !QImageWriter::supportedImageFormats().contains(request.format)) {
+        qCWarning(LogGraphics) << "WindowManager::requestScreenshot: unsupported image format"
+                               << request.format;
+        return 0;
+    }
+
+    // 0 is reserved for failed requests
+    uint requestId = ++d->lastScreenshotRequestId;
+    if (!requestId)
+        requestId = ++d->lastScreenshotRequestId;
+    d->screenshotRequests.insert(requestId, request);
+
     bool foundAtLeastOne = false;
 
     if (appId.isEmpty() && attributeName.isEmpty()) {
-        // fullscreen screenshot
+        // fullscreen screenshot: capture all the screens first, then encode them in parallel
 
         for (int i = 0; i < d->views.count(); ++i) {
             if (screenId.isEmpty() || screenId.toInt() == i) {
-                QImage img = d->views.at(i)->grabWindow();
-
                 foundAtLeastOne = true;
-                result &= img.save(substituteFilename(QString::number(i), QString()));
+                encodeScreenshot(requestId, d->views.at(i)->grabWindow(),
+                                 substituteFilename(QString::number(i), QString()));
             }
         }
     } else {
         // app without System UI
 
-        // filter out alias and apps not matching appId (if set)
-        QVector<Application *> apps = ApplicationManager::instance()->applications();
-        apps.erase(std::remove_if(apps.begin(), apps.end(), [appId](const Application *app) {
-            return app->isAlias() || (!appId.isEmpty() && (appId != app->id()));
-        }), apps.end());
+        // only look at the windows of the requested application (if set)
+        const QVector<Window *> windows = appId.isEmpty() ? d->windowsInModel
+                                                          : d->modelWindowsOfApplication.value(appId);
 
-        auto grabbers = new QList<QSharedPointer<const QQuickItemGrabResult>>;
+        for (const Window *w : windows) {
+            if (!w->application() || w->application()->isAlias())
+                continue;
+            if (!attributeName.isEmpty()
+                    && (w->windowProperty(attributeName).toString() != attributeValue)) {
+                continue;
+            }
 
-        for (const Window *w : qAsConst(d->windowsInModel)) {
-            if (apps.contains(w->application())) {
-                if (attributeName.isEmpty()
-                        || (w->windowProperty(attributeName).toString() == attributeValue)) {
-                    for (int i = 0; i < d->views.count(); ++i) {
-                        if (screenId.isEmpty() || screenId.toInt() == i) {
-                            QQuickWindow *view = d->views.at(i);
+            auto itemList = w->items().values();
+            if (itemList.count() == 0)
+                continue;
 
-                            bool onScreen = false;
+            // TODO: Care about multiple views?
+            WindowItem *windowItem = itemList.first();
 
-                            auto itemList = w->items().values();
-                            if (itemList.count() == 0)
-                                continue;
+            int i = d->views.indexOf(windowItem->QQuickItem::window());
+            if ((i == -1) || (!screenId.isEmpty() && screenId.toInt() != i))
+                continue;
 
-                            // TODO: Care about multiple views?
-                            WindowItem *windowItem = itemList.first();
+            foundAtLeastOne = true;
+            QSharedPointer<const QQuickItemGrabResult> grabber = windowItem->grabToImage();
 
-                            onScreen = windowItem->QQuickItem::window() == view;
+            auto &req = d->screenshotRequests[requestId];
+            if (!grabber) {
+                req.success = false;
+                continue;
+            }
 
-                            if (onScreen) {
-                                foundAtLeastOne = true;
-                                QSharedPointer<const QQuickItemGrabResult> grabber = windowItem->grabToImage();
+            // the grab result is kept alive by the request, until it is finished
+            ++req.pending;
+            req.grabbers << grabber;
+
+            QString saveTo = substituteFilename(QString::number(i), w->application()->id());
+            const QQuickItemGrabResult *grabResult = grabber.data();
+
+            auto *grabTimer = new QTimer(this);
+            grabTimer->setSingleShot(true);
+            connect(grabTimer, &QTimer::timeout, this, [this, requestId, grabResult, grabTimer, saveTo]() {
+                disconnect(grabResult, &QQuickItemGrabResult::ready, this, nullptr);
+                grabTimer->deleteLater();
+                qCWarning(LogGraphics) << "Could not save the screenshot" << saveTo
+                                       << ": capturing the window timed out";
+                screenshotEncoded(requestId, QString(), false);
+            });
+            connect(grabResult, &QQuickItemGrabResult::ready, this, [this, requestId, grabResult, grabTimer, saveTo]() {
+                delete grabTimer;
+                encodeScreenshot(requestId, grabResult->image(), saveTo);
+                screenshotEncoded(requestId, QString(), true); // the grab itself is done
+            });
+            grabTimer->start(WindowManagerPrivate::screenshotGrabTimeout);
+        }
+    }
 
-                                if (!grabber) {
-                                    result = false;
-                                    continue;
-                                }
+    if (!foundAtLeastOne) {
+        d->screenshotRequests.remove(requestId);
+        return 0;
+    }
+    if (!d->screenshotRequests.value(requestId).pending) {
+        // nothing to wait for, but the signal should still not be emitted synchronously
+        QMetaObject::invokeMethod(this, [this, requestId]() {
+            finishScreenshot(requestId);
+        }, Qt::QueuedConnection);
+    }
+    return requestId;
+}
 
-                                QString saveTo = substituteFilename(QString::number(i), w->application()->id());
-                                grabbers->append(grabber);
-                                connect(grabber.data(), &QQuickItemGrabResult::ready, this, [grabbers, grabber, saveTo]() {
-                                    grabber->saveToFile(saveTo);
-                                    grabbers->removeOne(grabber);
-                                    if (grabbers->isEmpty())
-                                        delete grabbers;
-                                });
+void WindowManager::encodeScreenshot(uint requestId, const QImage &image, const QString &fileName)
+{
+    auto it = d->screenshotRequests.find(requestId);
+    if (it == d->screenshotRequests.end())
+        return;
 
-                            }
-                        }
-                    }
-                }
-            }
+    ++it->pending;
+
+    if (!d->screenshotPool) {
+        d->screenshotPool = new QThreadPool;
+        d->screenshotPool->setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+    }
+
+    const QByteArray format = it->format;
+    const int quality = it->quality;
+    const int compression = it->compression;
+
+    d->screenshotPool->start([this, requestId, image, fileName, format, quality, compression]() {
+        QImageWriter writer(fileName, format);
+        writer.setQuality(quality);
+        writer.setCompression(compression);
+
+        const bool ok = !image.isNull() && writer.write(image);
+        if (!ok) {
+            qCWarning(LogGraphics) << "Could not save the screenshot" << fileName << ":"
+                                   << (image.isNull() ? qSL("capturing failed") : writer.errorString());
         }
+        QMetaObject::invokeMethod(this, [this, requestId, fileName, ok]() {
+            screenshotEncoded(requestId, fileName, ok);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void WindowManager::screenshotEncoded(uint requestId, const QString &fileName, bool success)
+{
+    auto it = d->screenshotRequests.find(requestId);
+    if (it == d->screenshotRequests.end())
+        return;
+
+    if (!success)
+        it->success = false;
+    else if (!fileName.isEmpty())
+        it->files << fileName;
+
+    if (!--it->pending)
+        finishScreenshot(requestId);
+}
+
+void WindowManager::finishScreenshot(uint requestId)
+{
+    const auto request = d->screenshotRequests.take(requestId);
+    emit screenshotFinished(requestId, request.success, request.files);
+}
+
+/*!
+    \qmlmethod list<var> WindowManager::frameStatistics()
+
+    Returns the frame pacing statistics of all Wayland client windows in this model. Each entry
+    in the list is an object with the fields described in WindowObject::frameStatistics(), plus
+    \c applicationId and \c index, which is the row of the window in this model.
+
+    This function is also available via D-Bus, so the application that is starving the compositor
+    can be found without changing the System UI.
+
+    \sa WindowObject::frameStatistics()
+*/
+QVariantList WindowManager::frameStatistics() const
+{
+    QVariantList result;
+    for (int i = 0; i < d->windowsInModel.count(); ++i) {
+        const Window *w = d->windowsInModel.at(i);
+        if (w->isInProcess())
+            continue;
+        QVariantMap stats = w->frameStatistics();
+        if (stats.isEmpty())
+            continue;
+        stats.insert(qSL("index"), i);
+        stats.insert(qSL("applicationId"), w->application() ? w->application()->id() : QString());
+        result << stats;
+    }
+    return result;
+}
+
+Window *WindowManagerPrivate::findWindowBySurfaceItem(QQuickItem *quickItem) const
+{
+    return windowsBySurfaceItem.value(quickItem);
+}
+
+void WindowManagerPrivate::addToIndices(Window *window)
+{
+    if (window->isInProcess()) {
+        windowsBySurfaceItem.insert(static_cast<InProcessWindow *>(window)->rootItem(), window);
+    } else {
+#if defined(AM_MULTI_PROCESS)
+        if (WindowSurface *windowSurface = static_cast<WaylandWindow *>(window)->surface())
+            windowsByWaylandSurface.insert(windowSurface->surface(), window);
+#endif
     }
-    return foundAtLeastOne && result;
 }
 
-int WindowManagerPrivate::findWindowBySurfaceItem(QQuickItem *quickItem) const
+void WindowManagerPrivate::removeFromIndices(Window *window)
 {
-    for (int i = 0; i < allWindows.count(); ++i) {
-        auto *window = allWindows.at(i);
-        if (window->isInProcess() && static_cast<InProcessWindow*>(window)->rootItem() == quickItem)
-            return i;
+    if (window->isInProcess()) {
+        auto it = windowsBySurfaceItem.find(static_cast<InProcessWindow *>(window)->rootItem());
+        if ((it != windowsBySurfaceItem.end()) && (it.value() == window))
+            windowsBySurfaceItem.erase(it);
+    } else {
+#if defined(AM_MULTI_PROCESS)
+        // normally already removed, when the surface was destroyed
+        if (WindowSurface *windowSurface = static_cast<WaylandWindow *>(window)->surface()) {
+            auto it = windowsByWaylandSurface.find(windowSurface->surface());
+            if ((it != windowsByWaylandSurface.end()) && (it.value() == window))
+                windowsByWaylandSurface.erase(it);
+        }
+#endif
     }
-    return -1;
 }
 
 QList<QQuickWindow *> WindowManager::compositorViews() const
@@ -1038,19 +1320,9 @@ QList<QQuickWindow *> WindowManager::compositorViews() const
 
 #if defined(AM_MULTI_PROCESS)
 
-int WindowManagerPrivate::findWindowByWaylandSurface(QWaylandSurface *waylandSurface) const
+Window *WindowManagerPrivate::findWindowByWaylandSurface(QWaylandSurface *waylandSurface) const
 {
-    for (int i = 0; i < allWindows.count(); ++i) {
-        auto *window = allWindows.at(i);
-
-        if (window->isInProcess())
-            continue;
-
-        auto windowSurface = static_cast<WaylandWindow*>(window)->surface();
-        if (windowSurface && windowSurface->surface() == waylandSurface)
-            return i;
-    }
-    return -1;
+    return windowsByWaylandSurface.value(waylandSurface);
 }
 
 QString WindowManagerPrivate::applicationId(Application *app, WindowSurface *windowSurface)
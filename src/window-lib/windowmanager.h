@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <QAbstractListModel>
+#include <QSize>
 #include <QtAppManCommon/global.h>
 
 #if defined(AM_MULTI_PROCESS)
@@ -20,6 +21,7 @@ QT_FORWARD_DECLARE_CLASS(QJSEngine)
 QT_FORWARD_DECLARE_CLASS(QWindow)
 QT_FORWARD_DECLARE_CLASS(QQmlComponent)
 QT_FORWARD_DECLARE_CLASS(QLocalServer)
+QT_FORWARD_DECLARE_CLASS(QImage)
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -52,6 +54,8 @@ class WindowManager : public QAbstractListModel
     Q_PROPERTY(bool runningOnDesktop READ isRunningOnDesktop CONSTANT)
     Q_PROPERTY(bool slowAnimations READ slowAnimations WRITE setSlowAnimations NOTIFY slowAnimationsChanged)
     Q_PROPERTY(bool allowUnknownUiClients READ allowUnknownUiClients CONSTANT)
+    Q_PROPERTY(QSize thumbnailSize READ thumbnailSize WRITE setThumbnailSize NOTIFY thumbnailSizeChanged)
+    Q_PROPERTY(qreal thumbnailRefreshRate READ thumbnailRefreshRate WRITE setThumbnailRefreshRate NOTIFY thumbnailRefreshRateChanged)
 
 public:
     ~WindowManager() override;
@@ -67,6 +71,11 @@ public:
     bool allowUnknownUiClients() const;
     void setAllowUnknownUiClients(bool enable);
     void enableWatchdog(bool enable);
+    void setWatchdogConfiguration(const QVariantMap &configuration);
+    QSize thumbnailSize() const;
+    void setThumbnailSize(const QSize &size);
+    qreal thumbnailRefreshRate() const;
+    void setThumbnailRefreshRate(qreal refreshRate);
 
     bool addWaylandSocket(QLocalServer *waylandSocket);
 
@@ -102,6 +111,10 @@ signals:
     void shutDownFinished();
 
     void slowAnimationsChanged(bool);
+    void thumbnailSizeChanged();
+    void thumbnailRefreshRateChanged();
+
+    Q_SCRIPTABLE void screenshotFinished(uint requestId, bool success, const QStringList &files);
 
 private slots:
     void inProcessSurfaceItemCreated(QSharedPointer<QT_PREPEND_NAMESPACE_AM(InProcessSurfaceItem)> surfaceItem);
@@ -109,6 +122,9 @@ private slots:
 
 public:
     Q_SCRIPTABLE bool makeScreenshot(const QString &filename, const QString &selector);
+    Q_SCRIPTABLE uint requestScreenshot(const QString &filename, const QString &selector,
+                                        const QVariantMap &options);
+    Q_SCRIPTABLE QVariantList frameStatistics() const;
 
     QList<QQuickWindow *> compositorViews() const;
 
@@ -130,6 +146,9 @@ private:
     void removeWindow(Window *window);
     void releaseWindow(Window *window);
     void updateViewSlowMode(QQuickWindow *view);
+    void encodeScreenshot(uint requestId, const QImage &image, const QString &fileName);
+    void screenshotEncoded(uint requestId, const QString &fileName, bool success);
+    void finishScreenshot(uint requestId);
     WindowManager(QQmlEngine *qmlEngine, const QString &waylandSocketName);
     WindowManager(const WindowManager &);
     WindowManager &operator=(const WindowManager &);
@@ -8,20 +8,29 @@
 #include <QVector>
 #include <QMap>
 #include <QHash>
+#include <QVariantMap>
+#include <QSharedPointer>
+#include <QStringList>
 
 #include <QtAppManWindow/windowmanager.h>
 
 QT_FORWARD_DECLARE_CLASS(QQmlEngine)
+QT_FORWARD_DECLARE_CLASS(QQuickItemGrabResult)
+QT_FORWARD_DECLARE_CLASS(QThreadPool)
 
 QT_BEGIN_NAMESPACE_AM
 
+class WindowThumbnailer;
+
 class WindowManagerPrivate
 {
 public:
-    int findWindowBySurfaceItem(QQuickItem *quickItem) const;
+    Window *findWindowBySurfaceItem(QQuickItem *quickItem) const;
+    void addToIndices(Window *window);
+    void removeFromIndices(Window *window);
 
 #if defined(AM_MULTI_PROCESS)
-    int findWindowByWaylandSurface(QWaylandSurface *waylandSurface) const;
+    Window *findWindowByWaylandSurface(QWaylandSurface *waylandSurface) const;
 
     WaylandCompositor *waylandCompositor = nullptr;
     QVector<int> extraWaylandSockets;
@@ -39,9 +48,38 @@ public:
     // kept here.
     QVector<Window *> windowsInModel;
 
+    // Indices to avoid linear searches through the lists above on every surface event
+    QHash<QQuickItem *, Window *> windowsBySurfaceItem;          // all in-process windows
+#if defined(AM_MULTI_PROCESS)
+    QHash<QWaylandSurface *, Window *> windowsByWaylandSurface;  // all Wayland windows with a surface
+#endif
+    QHash<Window *, int> modelIndexOfWindow;                     // windowsInModel
+    QHash<QString, QVector<Window *>> modelWindowsOfApplication; // windowsInModel, in model order
+
     bool shuttingDown = false;
     bool slowAnimations = false;
     bool allowUnknownUiClients = false;
+    bool watchdogEnabled = true;
+    QVariantMap watchdogConfiguration;
+
+    // Screenshots are captured on the GUI thread, but encoded and saved on a worker pool
+    struct ScreenshotRequest
+    {
+        QByteArray format;
+        int quality = -1;
+        int compression = -1;
+        int pending = 0; // grabs and encodes
+        bool success = true;
+        QStringList files;
+        QList<QSharedPointer<const QQuickItemGrabResult>> grabbers;
+    };
+    QHash<uint, ScreenshotRequest> screenshotRequests;
+    uint lastScreenshotRequestId = 0;
+    // grabToImage() never reports back, if the window is not rendered (e.g. it is hidden)
+    static constexpr int screenshotGrabTimeout = 5000; // msec
+    QThreadPool *screenshotPool = nullptr;
+
+    WindowThumbnailer *thumbnailer = nullptr;
 
     QList<QQuickWindow *> views;
     QString waylandSocketName;
@@ -0,0 +1,260 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QQuickImageProvider>
+#include <QQuickItemGrabResult>
+#include <QTimer>
+
+#include "global.h"
+#include "logging.h"
+#include "window.h"
+#include "windowitem.h"
+#include "windowthumbnailer.h"
+#if defined(AM_MULTI_PROCESS)
+#  include "waylandcompositor.h"
+#  include "waylandwindow.h"
+#endif
+
+
+QT_BEGIN_NAMESPACE_AM
+
+class WindowThumbnailProvider : public QQuickImageProvider
+{
+public:
+    WindowThumbnailProvider(WindowThumbnailer *thumbnailer)
+        : QQuickImageProvider(QQuickImageProvider::Image)
+        , m_cache(thumbnailer->m_cache)
+        , m_thumbnailer(thumbnailer)
+    { }
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override
+    {
+        // id: <window-id>/<version>
+        bool ok = false;
+        quint64 windowId = id.section(qL1C('/'), 0, 0).toULongLong(&ok);
+
+        QImage image;
+        bool newRequest = false;
+        if (ok) {
+            QMutexLocker locker(&m_cache->mutex);
+            image = m_cache->images.value(windowId);
+            newRequest = !m_cache->requested.contains(windowId);
+            m_cache->requested.insert(windowId);
+        }
+        if (newRequest) {
+            // the thumbnailer will update the window's thumbnail url, once a new snapshot is taken
+            QMetaObject::invokeMethod(m_thumbnailer, "processRequests", Qt::QueuedConnection);
+        }
+        if (image.isNull()) {
+            image = QImage(1, 1, QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::transparent);
+        }
+        if (requestedSize.isValid() && (requestedSize != image.size()))
+            image = image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        if (size)
+            *size = image.size();
+        return image;
+    }
+
+private:
+    QSharedPointer<WindowThumbnailer::Cache> m_cache;
+    QPointer<WindowThumbnailer> m_thumbnailer;
+};
+
+
+WindowThumbnailer::WindowThumbnailer(QObject *parent)
+    : QObject(parent)
+    , m_cache(new Cache)
+    , m_refreshTimer(new QTimer(this))
+{
+    m_refreshTimer->setInterval(int(1000 / m_refreshRate));
+    connect(m_refreshTimer, &QTimer::timeout, this, &WindowThumbnailer::refresh);
+}
+
+WindowThumbnailer::~WindowThumbnailer()
+{ }
+
+const char *WindowThumbnailer::providerId()
+{
+    return "appman-window-thumbnail";
+}
+
+QQuickImageProvider *WindowThumbnailer::createImageProvider()
+{
+    return new WindowThumbnailProvider(this);
+}
+
+QSize WindowThumbnailer::size() const
+{
+    return m_size;
+}
+
+void WindowThumbnailer::setSize(const QSize &size)
+{
+    if (size == m_size || !size.isValid())
+        return;
+    m_size = size;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        markDirty(it.key());
+}
+
+qreal WindowThumbnailer::refreshRate() const
+{
+    return m_refreshRate;
+}
+
+void WindowThumbnailer::setRefreshRate(qreal refreshRate)
+{
+    if (refreshRate <= 0)
+        return;
+    m_refreshRate = refreshRate;
+    m_refreshTimer->setInterval(qMax(1, int(1000 / refreshRate)));
+}
+
+void WindowThumbnailer::addWindow(Window *window)
+{
+    const quint64 id = window->id();
+    Entry &entry = m_entries[id];
+    entry.window = window;
+
+    auto changed = [this, id]() { markDirty(id); };
+    connect(window, &Window::sizeChanged, this, changed);
+    connect(window, &Window::contentStateChanged, this, changed);
+    connect(window, &Window::isBeingDisplayedChanged, this, changed);
+
+#if defined(AM_MULTI_PROCESS)
+    // Wayland clients tell us exactly when their content changed
+    if (!window->isInProcess()) {
+        if (WindowSurface *surface = static_cast<WaylandWindow *>(window)->surface())
+            connect(surface, &QWaylandSurface::damaged, this, changed);
+    }
+#endif
+}
+
+void WindowThumbnailer::removeWindow(Window *window)
+{
+    const quint64 id = window->id();
+    disconnect(window, nullptr, this, nullptr);
+    m_entries.remove(id);
+
+    QMutexLocker locker(&m_cache->mutex);
+    m_cache->images.remove(id);
+    m_cache->requested.remove(id);
+}
+
+void WindowThumbnailer::processRequests()
+{
+    QSet<quint64> requested;
+    {
+        QMutexLocker locker(&m_cache->mutex);
+        requested = m_cache->requested;
+    }
+    bool refreshNeeded = false;
+    for (quint64 id : qAsConst(requested)) {
+        auto it = m_entries.find(id);
+        if ((it != m_entries.end()) && !it->wanted) {
+            it->wanted = true;
+            refreshNeeded = refreshNeeded || it->dirty;
+        }
+    }
+    if (refreshNeeded)
+        scheduleRefresh();
+}
+
+void WindowThumbnailer::markDirty(quint64 id)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+        return;
+
+    it->dirty = true;
+    if (it->wanted)
+        scheduleRefresh();
+}
+
+void WindowThumbnailer::scheduleRefresh()
+{
+    if (!m_refreshTimer->isActive()) {
+        // the first change is captured right away, the following ones are rate limited
+        refresh();
+        m_refreshTimer->start();
+    }
+}
+
+void WindowThumbnailer::refresh()
+{
+    bool pending = false;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (!it->wanted || !it->dirty)
+            continue;
+        if (it->grab) {
+            pending = true; // still waiting for the last one
+            continue;
+        }
+        // keep the timer running for one more interval after a grab, so that the next one
+        // (after the snapshot has been requested again) is rate limited as well
+        pending = grab(it.key(), it.value()) || it->dirty || pending;
+    }
+    if (!pending)
+        m_refreshTimer->stop();
+}
+
+bool WindowThumbnailer::grab(quint64 id, Entry &entry)
+{
+    entry.dirty = false;
+
+    Window *window = entry.window;
+    if (!window)
+        return false;
+
+    WindowItem *item = window->primaryItem();
+    if (!item && !window->items().isEmpty())
+        item = *window->items().cbegin();
+
+    // windows that are not displayed anywhere keep their last thumbnail
+    if (!item || !item->window() || !item->isVisible() || (item->width() <= 0) || (item->height() <= 0))
+        return false;
+
+    const QSize targetSize = QSizeF(item->width(), item->height()).scaled(m_size, Qt::KeepAspectRatio)
+            .toSize().expandedTo(QSize(1, 1));
+
+    auto grabResult = item->grabToImage(targetSize);
+    if (!grabResult)
+        return false;
+
+    entry.grab = grabResult;
+    connect(grabResult.data(), &QQuickItemGrabResult::ready, this, [this, id]() {
+        auto it = m_entries.find(id);
+        if (it == m_entries.end() || !it->grab)
+            return;
+
+        const QImage image = it->grab->image();
+        // the grab result must not be deleted while it is emitting this signal
+        QMetaObject::invokeMethod(this, [grab = it->grab]() { Q_UNUSED(grab) }, Qt::QueuedConnection);
+        it->grab.reset();
+
+        if (image.isNull())
+            return;
+        {
+            QMutexLocker locker(&m_cache->mutex);
+            m_cache->images.insert(id, image);
+            // only take the next snapshot, if this one is actually requested by someone
+            m_cache->requested.remove(id);
+        }
+        it->wanted = false;
+
+        // In-process windows are part of the System UI's scene and there is no damage information
+        // for a single item: the scene's frameSwapped() would also be triggered by the grab itself.
+        // Instead, they are refreshed at the refresh rate for as long as they are requested.
+        if (it->window && it->window->isInProcess())
+            it->dirty = true;
+
+        if (it->window)
+            it->window->updateThumbnail();
+    });
+    return true;
+}
+
+QT_END_NAMESPACE_AM
+
+#include "moc_windowthumbnailer.cpp"
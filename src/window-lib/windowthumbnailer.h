@@ -0,0 +1,83 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QPointer>
+#include <QSet>
+#include <QSharedPointer>
+#include <QSize>
+#include <QtAppManCommon/global.h>
+
+QT_FORWARD_DECLARE_CLASS(QQuickImageProvider)
+QT_FORWARD_DECLARE_CLASS(QQuickItemGrabResult)
+QT_FORWARD_DECLARE_CLASS(QTimer)
+
+QT_BEGIN_NAMESPACE_AM
+
+class Window;
+
+// Keeps a downscaled snapshot of every window that has been requested via the image provider.
+// A snapshot is only refreshed while it is being requested, after the window's content changed
+// and then at most refreshRate() times per second, so a task switcher showing these images costs
+// a small texture per window instead of a live surface.
+
+class WindowThumbnailer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WindowThumbnailer(QObject *parent = nullptr);
+    ~WindowThumbnailer() override;
+
+    static const char *providerId();
+    QQuickImageProvider *createImageProvider();
+
+    QSize size() const;
+    void setSize(const QSize &size);
+    qreal refreshRate() const;
+    void setRefreshRate(qreal refreshRate);
+
+    void addWindow(Window *window);
+    void removeWindow(Window *window);
+
+    // shared with the image provider, which might be called from QML's image loader thread
+    struct Cache
+    {
+        QMutex mutex;
+        QHash<quint64, QImage> images;
+        QSet<quint64> requested;
+    };
+
+private:
+    struct Entry
+    {
+        QPointer<Window> window;
+        bool wanted = false; // requested via the image provider since the last snapshot
+        bool dirty = true;
+        QSharedPointer<const QQuickItemGrabResult> grab;
+    };
+
+private slots:
+    void processRequests();
+
+private:
+    void markDirty(quint64 id);
+    void scheduleRefresh();
+    void refresh();
+    bool grab(quint64 id, Entry &entry);
+
+    QSize m_size { 256, 256 };
+    qreal m_refreshRate = 2;
+    QHash<quint64, Entry> m_entries;
+    QSharedPointer<Cache> m_cache;
+    QTimer *m_refreshTimer;
+
+    friend class WindowThumbnailProvider;
+};
+
+QT_END_NAMESPACE_AM
@@ -53,6 +53,9 @@ void tst_Configuration::defaultConfig()
     QCOMPARE(c.documentDir(), qSL(""));
 
     QCOMPARE(c.installationDir(), qSL(""));
+    QCOMPARE(c.maximumConcurrentApplicationStarts(), 0);
+    QCOMPARE(c.applicationStartTimeout(), 20000);
+    QCOMPARE(c.applicationEvictionPolicy(), QVariantMap {});
     QCOMPARE(c.disableInstaller(), false);
     QCOMPARE(c.disableIntents(), false);
     QCOMPARE(c.intentTimeoutForDisambiguation(), 10000);
@@ -83,6 +86,7 @@ void tst_Configuration::defaultConfig()
     QCOMPARE(c.resources(), {});
 
     QCOMPARE(c.openGLConfiguration(), QVariantMap {});
+    QCOMPARE(c.uiWatchdogConfiguration(), QVariantMap {});
 
     QCOMPARE(c.installationLocations(), {});
 
@@ -110,6 +114,9 @@ void tst_Configuration::defaultConfig()
     QCOMPARE(c.managerCrashAction(), QVariantMap {});
 
     QCOMPARE(c.caCertificates(), {});
+    QCOMPARE(c.precompileQml(), false);
+    QCOMPARE(c.ioPriority(), qSL("low"));
+    QCOMPARE(c.ioBandwidthLimit(), quint64(0));
 
     QCOMPARE(c.pluginFilePaths("container"), {});
     QCOMPARE(c.pluginFilePaths("startup"), {});
@@ -137,6 +144,13 @@ void tst_Configuration::simpleConfig()
     QCOMPARE(c.documentDir(), qSL("doc-dir"));
 
     QCOMPARE(c.installationDir(), qSL("installation-dir"));
+    QCOMPARE(c.maximumConcurrentApplicationStarts(), 3);
+    QCOMPARE(c.applicationStartTimeout(), 5000);
+    QCOMPARE(c.applicationEvictionPolicy(), QVariantMap
+             ({
+                  { qSL("enabled"), true },
+                  { qSL("targetMemoryUsage"), 60 }
+              }));
     QCOMPARE(c.disableInstaller(), true);
     QCOMPARE(c.disableIntents(), true);
     QCOMPARE(c.intentTimeoutForDisambiguation(), 1);
@@ -173,6 +187,14 @@ void tst_Configuration::simpleConfig()
                   { qSL("esMajorVersion"), 5 },
                   { qSL("esMinorVersion"), 15 }
               }));
+    QCOMPARE(c.uiWatchdogConfiguration(), QVariantMap
+             ({
+                  { qSL("pongTimeout"), 3000 },
+                  { qSL("overrides"), QVariantList { QVariantMap {
+                        { qSL("applications"), QVariantList { qSL("com.example.*") } },
+                        { qSL("pongTimeout"), 10000 }
+                    } } }
+              }));
 
     QCOMPARE(c.installationLocations(), {});
 
@@ -238,6 +260,9 @@ void tst_Configuration::simpleConfig()
               }));
 
     QCOMPARE(c.caCertificates(), QStringList({ qSL("cert1"), qSL("cert2") }));
+    QCOMPARE(c.precompileQml(), true);
+    QCOMPARE(c.ioPriority(), qSL("idle"));
+    QCOMPARE(c.ioBandwidthLimit(), quint64(1048576));
 
     QCOMPARE(c.pluginFilePaths("startup"), QStringList({ qSL("s1"), qSL("s2") }));
     QCOMPARE(c.pluginFilePaths("container"), QStringList({ qSL("c1"), qSL("c2") }));
@@ -265,6 +290,13 @@ void tst_Configuration::mergedConfig()
     QCOMPARE(c.documentDir(), qSL("doc-dir2"));
 
     QCOMPARE(c.installationDir(), qSL("installation-dir2"));
+    QCOMPARE(c.maximumConcurrentApplicationStarts(), 3);
+    QCOMPARE(c.applicationStartTimeout(), 5000);
+    QCOMPARE(c.applicationEvictionPolicy(), QVariantMap
+             ({
+                  { qSL("enabled"), true },
+                  { qSL("targetMemoryUsage"), 60 }
+              }));
     QCOMPARE(c.disableInstaller(), true);
     QCOMPARE(c.disableIntents(), true);
     QCOMPARE(c.intentTimeoutForDisambiguation(), 5);
@@ -304,6 +336,14 @@ void tst_Configuration::mergedConfig()
                   { qSL("esMajorVersion"), 1 },
                   { qSL("esMinorVersion"), 0 },
               }));
+    QCOMPARE(c.uiWatchdogConfiguration(), QVariantMap
+             ({
+                  { qSL("pongTimeout"), 3000 },
+                  { qSL("overrides"), QVariantList { QVariantMap {
+                        { qSL("applications"), QVariantList { qSL("com.example.*") } },
+                        { qSL("pongTimeout"), 10000 }
+                    } } }
+              }));
 
     QCOMPARE(c.installationLocations(), {});
 
@@ -386,6 +426,9 @@ void tst_Configuration::mergedConfig()
               }));
 
     QCOMPARE(c.caCertificates(), QStringList({ qSL("cert1"), qSL("cert2"), qSL("cert3") }));
+    QCOMPARE(c.precompileQml(), true);
+    QCOMPARE(c.ioPriority(), qSL("idle"));
+    QCOMPARE(c.ioBandwidthLimit(), quint64(1048576));
 
     QCOMPARE(c.pluginFilePaths("container"), QStringList({ qSL("c1"), qSL("c2"), qSL("c3"), qSL("c4") }));
     QCOMPARE(c.pluginFilePaths("startup"), QStringList({ qSL("s1"), qSL("s2"), qSL("s3") }));
@@ -445,6 +488,9 @@ void tst_Configuration::commandLineConfig()
     QCOMPARE(c.documentDir(), qSL("document-dir-cl"));
 
     QCOMPARE(c.installationDir(), qSL("installation-dir-cl"));
+    QCOMPARE(c.maximumConcurrentApplicationStarts(), 0);
+    QCOMPARE(c.applicationStartTimeout(), 20000);
+    QCOMPARE(c.applicationEvictionPolicy(), QVariantMap {});
     QCOMPARE(c.disableInstaller(), true);
     QCOMPARE(c.disableIntents(), true);
     QCOMPARE(c.intentTimeoutForDisambiguation(), 10000);
@@ -474,6 +520,7 @@ void tst_Configuration::commandLineConfig()
     QCOMPARE(c.resources(), {});
 
     QCOMPARE(c.openGLConfiguration(), QVariantMap {});
+    QCOMPARE(c.uiWatchdogConfiguration(), QVariantMap {});
 
     QCOMPARE(c.installationLocations(), {});
 
@@ -494,6 +541,9 @@ void tst_Configuration::commandLineConfig()
     QCOMPARE(c.managerCrashAction(), QVariantMap {});
 
     QCOMPARE(c.caCertificates(), {});
+    QCOMPARE(c.precompileQml(), false);
+    QCOMPARE(c.ioPriority(), qSL("low"));
+    QCOMPARE(c.ioBandwidthLimit(), quint64(0));
 
     QCOMPARE(c.pluginFilePaths("container"), {});
     QCOMPARE(c.pluginFilePaths("startup"), {});
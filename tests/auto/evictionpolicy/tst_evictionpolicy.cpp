@@ -0,0 +1,77 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtTest>
+
+#include "evictionpolicy.h"
+
+QT_USE_NAMESPACE_AM
+
+class tst_EvictionPolicy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lastActivation();
+    void selectVictims_data();
+    void selectVictims();
+};
+
+void tst_EvictionPolicy::lastActivation()
+{
+    EvictionPolicy policy;
+    QVERIFY(!policy.isEnabled());
+    QCOMPARE(policy.lastActivation(qSL("a")), -1);
+
+    policy.applicationActivated(qSL("a"));
+    QTest::qWait(5);
+    policy.applicationActivated(qSL("b"));
+    QVERIFY(policy.lastActivation(qSL("a")) >= 0);
+    QVERIFY(policy.lastActivation(qSL("b")) > policy.lastActivation(qSL("a")));
+
+    policy.applicationStopped(qSL("a"));
+    QCOMPARE(policy.lastActivation(qSL("a")), -1);
+
+    // a disabled policy never requires any eviction
+    QCOMPARE(policy.bytesToFree(), 0ULL);
+}
+
+void tst_EvictionPolicy::selectVictims_data()
+{
+    QTest::addColumn<int>("protectedCount");
+    QTest::addColumn<QStringList>("excluded");
+    QTest::addColumn<quint64>("bytesToFree");
+    QTest::addColumn<QStringList>("victims");
+
+    // candidates (see below): a is the most recently used app, d was never activated
+    QTest::newRow("lru-first") << 1 << QStringList { } << 10ULL << QStringList { qSL("d") };
+    QTest::newRow("until-target") << 1 << QStringList { } << 250ULL << QStringList { qSL("d"), qSL("c") };
+    QTest::newRow("unknown-pss") << 1 << QStringList { } << 350ULL << QStringList { qSL("d"), qSL("c"), qSL("e") };
+    QTest::newRow("protected") << 3 << QStringList { } << 1000ULL << QStringList { qSL("d"), qSL("c") };
+    QTest::newRow("excluded") << 1 << QStringList { qSL("d") } << 10ULL << QStringList { qSL("c") };
+    QTest::newRow("excluded-not-shifting") << 2 << QStringList { qSL("a") } << 1000ULL
+                                           << QStringList { qSL("d"), qSL("c"), qSL("e") };
+    QTest::newRow("nothing-to-free") << 0 << QStringList { } << 0ULL << QStringList { };
+}
+
+void tst_EvictionPolicy::selectVictims()
+{
+    QFETCH(int, protectedCount);
+    QFETCH(QStringList, excluded);
+    QFETCH(quint64, bytesToFree);
+    QFETCH(QStringList, victims);
+
+    const QVector<EvictionPolicy::Candidate> candidates {
+        { qSL("c"), 100, 200 },
+        { qSL("a"), 300, 400 },
+        { qSL("d"), -1, 100 },
+        { qSL("e"), 150, 0 },
+        { qSL("b"), 200, 300 },
+    };
+
+    QCOMPARE(EvictionPolicy::selectVictims(candidates, protectedCount, excluded, bytesToFree), victims);
+}
+
+QTEST_MAIN(tst_EvictionPolicy)
+
+#include "tst_evictionpolicy.moc"
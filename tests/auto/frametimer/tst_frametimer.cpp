@@ -0,0 +1,193 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtTest>
+#include <numeric>
+
+#include "frametimer.h"
+
+QT_USE_NAMESPACE_AM
+
+// The frame times are fed in directly, instead of being measured between the frameSwapped
+// signals of a real window.
+class FakeFrameTimer : public FrameTimer
+{
+public:
+    using FrameTimer::addFrame;
+
+    void addFrames(int count, int frameTime)
+    {
+        while (count--)
+            addFrame(frameTime);
+    }
+};
+
+class tst_FrameTimer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void noFrames();
+    void percentiles();
+    void percentilesOfLongFrames();
+    void framesOverBudget();
+    void jankCount_data();
+    void jankCount();
+    void resetOnUpdate();
+
+private:
+    // 100 frames: 90 at 10ms, 6 at 20.5ms, 3 at 40ms and a single one at 150ms
+    static void addTypicalFrames(FakeFrameTimer &timer)
+    {
+        timer.addFrames(90, 10000);
+        timer.addFrames(6, 20500);
+        timer.addFrames(3, 40000);
+        timer.addFrames(1, 150000);
+    }
+};
+
+void tst_FrameTimer::noFrames()
+{
+    FakeFrameTimer timer;
+    timer.update();
+
+    QCOMPARE(timer.averageFps(), qreal(0));
+    QCOMPARE(timer.frameTimeP50(), qreal(0));
+    QCOMPARE(timer.frameTimeP95(), qreal(0));
+    QCOMPARE(timer.frameTimeP99(), qreal(0));
+    QCOMPARE(timer.jankCount(), 0);
+    QCOMPARE(timer.framesOverBudget(), QList<int>({ 0, 0 }));
+    QCOMPARE(timer.frameTimeHistogram().size(), 101);
+    QCOMPARE(timer.frameTimeHistogram().count(0), 101);
+}
+
+void tst_FrameTimer::percentiles()
+{
+    FakeFrameTimer timer;
+    addTypicalFrames(timer);
+    timer.update();
+
+    // each percentile is the upper bound of the 1ms histogram bucket it falls into
+    QCOMPARE(timer.frameTimeP50(), qreal(11));
+    QCOMPARE(timer.frameTimeP95(), qreal(21));
+    QCOMPARE(timer.frameTimeP99(), qreal(41));
+
+    const QList<int> histogram = timer.frameTimeHistogram();
+    QCOMPARE(histogram.size(), 101);
+    QCOMPARE(histogram.at(10), 90);
+    QCOMPARE(histogram.at(20), 6);
+    QCOMPARE(histogram.at(40), 3);
+    QCOMPARE(histogram.at(100), 1);
+    QCOMPARE(std::accumulate(histogram.cbegin(), histogram.cend(), 0), 100);
+
+    QCOMPARE(timer.averageFps(), qreal(1000 * 1000 * 100) / (900000 + 123000 + 120000 + 150000));
+    QCOMPARE(timer.minimumFps(), qreal(1000) / 150);
+    QCOMPARE(timer.maximumFps(), qreal(100));
+}
+
+void tst_FrameTimer::percentilesOfLongFrames()
+{
+    FakeFrameTimer timer;
+
+    // the bucket's upper bound is capped by the longest frame
+    timer.addFrame(5500);
+    timer.update();
+    QCOMPARE(timer.frameTimeP50(), 5.5);
+    QCOMPARE(timer.frameTimeP99(), 5.5);
+
+    // frames beyond the histogram's range are reported with their real duration
+    timer.addFrames(98, 10000);
+    timer.addFrames(2, 250000);
+    timer.update();
+    QCOMPARE(timer.frameTimeP50(), qreal(11));
+    QCOMPARE(timer.frameTimeP95(), qreal(11));
+    QCOMPARE(timer.frameTimeP99(), qreal(250));
+    QCOMPARE(timer.frameTimeHistogram().at(100), 2);
+}
+
+void tst_FrameTimer::framesOverBudget()
+{
+    FakeFrameTimer timer;
+    QSignalSpy budgetsSpy(&timer, &FrameTimer::frameBudgetsChanged);
+
+    addTypicalFrames(timer);
+    timer.update();
+    QCOMPARE(timer.framesOverBudget(), QList<int>({ 10, 4 }));
+
+    timer.setFrameBudgets({ 10, 20.5, 100 });
+    QCOMPARE(budgetsSpy.count(), 1);
+    QCOMPARE(timer.frameBudgets(), QList<qreal>({ 10, 20.5, 100 }));
+    timer.setFrameBudgets({ 10, 20.5, 100 });
+    QCOMPARE(budgetsSpy.count(), 1);
+
+    // frames exactly at the budget are still within it
+    addTypicalFrames(timer);
+    timer.update();
+    QCOMPARE(timer.framesOverBudget(), QList<int>({ 10, 4, 1 }));
+}
+
+void tst_FrameTimer::jankCount_data()
+{
+    QTest::addColumn<qreal>("threshold");
+    QTest::addColumn<int>("jankCount");
+
+    QTest::newRow("default") << qreal(-1) << 1;
+    QTest::newRow("10ms") << qreal(10) << 100;
+    QTest::newRow("20ms") << qreal(20) << 10;
+    QTest::newRow("40ms") << qreal(40) << 4;
+    QTest::newRow("200ms") << qreal(200) << 0;
+}
+
+void tst_FrameTimer::jankCount()
+{
+    QFETCH(qreal, threshold);
+    QFETCH(int, jankCount);
+
+    FakeFrameTimer timer;
+    if (threshold >= 0)
+        timer.setJankThreshold(threshold);
+    else
+        QCOMPARE(timer.jankThreshold(), qreal(50));
+
+    QSignalSpy jankSpy(&timer, &FrameTimer::jank);
+    addTypicalFrames(timer);
+
+    // the property only changes on update(), the signal is emitted right away
+    QCOMPARE(timer.jankCount(), 0);
+    QCOMPARE(jankSpy.count(), jankCount);
+    timer.update();
+    QCOMPARE(timer.jankCount(), jankCount);
+
+    if (jankCount) {
+        // the frames are added in ascending order, so the last one is the longest
+        QCOMPARE(jankSpy.constLast().at(1).toReal(), qreal(150));
+        QVERIFY(jankSpy.constLast().at(0).toLongLong() > 0);
+    }
+}
+
+void tst_FrameTimer::resetOnUpdate()
+{
+    FakeFrameTimer timer;
+    QSignalSpy updatedSpy(&timer, &FrameTimer::updated);
+
+    addTypicalFrames(timer);
+    timer.update();
+    QCOMPARE(updatedSpy.count(), 1);
+    QCOMPARE(timer.jankCount(), 1);
+
+    // every interval starts from scratch
+    timer.addFrames(10, 30000);
+    timer.update();
+    QCOMPARE(updatedSpy.count(), 2);
+    QCOMPARE(timer.frameTimeP50(), qreal(30));
+    QCOMPARE(timer.frameTimeP99(), qreal(30));
+    QCOMPARE(timer.jankCount(), 0);
+    QCOMPARE(timer.framesOverBudget(), QList<int>({ 10, 0 }));
+    QCOMPARE(timer.frameTimeHistogram().at(10), 0);
+    QCOMPARE(timer.frameTimeHistogram().at(30), 10);
+    QCOMPARE(timer.averageFps(), qreal(1000) / 30);
+}
+
+QTEST_APPLESS_MAIN(tst_FrameTimer)
+
+#include "tst_frametimer.moc"
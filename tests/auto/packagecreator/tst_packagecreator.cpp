@@ -9,6 +9,7 @@
 #include "installationreport.h"
 #include "packageutilities.h"
 #include "packagecreator.h"
+#include "packageextractor.h"
 #include "utilities.h"
 
 #include "../error-checking.h"
@@ -30,8 +31,14 @@ private slots:
     void createAndVerify_data();
     void createAndVerify();
 
+    void multiThreaded();
+
+    void benchmark_data();
+    void benchmark();
+
 private:
     QString escapeFilename(const QString &name);
+    bool createLargeSourceTree(QTemporaryDir &dir, InstallationReport &report, int fileCount, int fileSize);
 
 private:
     QDir m_baseDir;
@@ -138,6 +145,119 @@ void tst_PackageCreator::createAndVerify()
     }
 }
 
+// Creates files, that are compressible similar to real-world code and assets
+bool tst_PackageCreator::createLargeSourceTree(QTemporaryDir &dir, InstallationReport &report,
+                                               int fileCount, int fileSize)
+{
+    static const QByteArrayList words = {
+        "import", "QtQuick", "Item", "property", "int", "width", "height", "anchors.fill:",
+        "parent", "function", "return", "{", "}", "\n", "    ", "id:", "Rectangle", "color:"
+    };
+    QRandomGenerator rng(42);
+
+    if (!dir.isValid())
+        return false;
+
+    QStringList files;
+    for (int i = 0; i < fileCount; ++i) {
+        const QString name = qSL("file%1.qml").arg(i);
+        QFile f(dir.filePath(name));
+        if (!f.open(QFile::WriteOnly))
+            return false;
+
+        QByteArray data;
+        data.reserve(fileSize + 32);
+        while (data.size() < fileSize) {
+            data.append(words.at(int(rng.bounded(words.size()))));
+            data.append(' ');
+            if (rng.bounded(8) == 0)
+                data.append(QByteArray::number(rng.generate()));
+        }
+        data.truncate(fileSize);
+        if (f.write(data) != data.size())
+            return false;
+        files << name;
+    }
+    report.addFiles(files);
+    return true;
+}
+
+// The compression is done in parallel: make sure that the result is still deterministic and can
+// be read by the PackageExtractor
+void tst_PackageCreator::multiThreaded()
+{
+    QTemporaryDir sourceDir;
+    InstallationReport report(qSL("com.pelagicore.test"));
+    QVERIFY(createLargeSourceTree(sourceDir, report, 5, 3 * 1024 * 1024 + 17));
+
+    QByteArray reference;
+    QByteArray referenceDigest;
+
+    for (int threads : { 1, 2, 4, 0 }) {
+        QBuffer output;
+        QVERIFY(output.open(QIODevice::WriteOnly));
+
+        PackageCreator creator(QDir(sourceDir.path()), &output, report);
+        creator.setMaximumThreadCount(threads);
+        QVERIFY2(creator.create(), qPrintable(creator.errorString()));
+
+        if (reference.isEmpty()) {
+            reference = output.data();
+            referenceDigest = creator.createdDigest();
+        } else {
+            QVERIFY2(output.data() == reference, qPrintable(qSL("%1 threads").arg(threads)));
+            QCOMPARE(creator.createdDigest(), referenceDigest);
+        }
+    }
+
+    QTemporaryFile packageFile;
+    QVERIFY(packageFile.open());
+    QCOMPARE(packageFile.write(reference), reference.size());
+    packageFile.close();
+
+    QTemporaryDir extractDir;
+    PackageExtractor extractor(QUrl::fromLocalFile(packageFile.fileName()), QDir(extractDir.path()));
+    QVERIFY2(extractor.extract(), qPrintable(extractor.errorString()));
+    QCOMPARE(extractor.installationReport().digest(), referenceDigest);
+
+    for (const QString &file : report.files()) {
+        QFile src(QDir(sourceDir.path()).absoluteFilePath(file));
+        QFile dst(QDir(extractDir.path()).absoluteFilePath(file));
+        QVERIFY(src.open(QFile::ReadOnly));
+        QVERIFY(dst.open(QFile::ReadOnly));
+        QVERIFY2(src.readAll() == dst.readAll(), qPrintable(file));
+    }
+}
+
+void tst_PackageCreator::benchmark_data()
+{
+    QTest::addColumn<int>("threads");
+
+    const int idealThreads = QThread::idealThreadCount();
+    for (int threads = 1; threads < idealThreads; threads *= 2)
+        QTest::addRow("%d thread(s)", threads) << threads;
+    QTest::addRow("%d thread(s)", idealThreads) << idealThreads;
+}
+
+void tst_PackageCreator::benchmark()
+{
+    QFETCH(int, threads);
+
+    static QTemporaryDir sourceDir;
+    static InstallationReport report(qSL("com.pelagicore.test"));
+    static bool created = createLargeSourceTree(sourceDir, report, 16, 4 * 1024 * 1024);
+    QVERIFY(created);
+
+    QBENCHMARK {
+        QTemporaryFile output;
+        QVERIFY(output.open());
+
+        PackageCreator creator(QDir(sourceDir.path()), &output, report);
+        creator.setMaximumThreadCount(threads);
+        QVERIFY2(creator.create(), qPrintable(creator.errorString()));
+    }
+}
+
 QString tst_PackageCreator::escapeFilename(const QString &name)
 {
     if (!m_isCygwin) {
@@ -43,6 +43,8 @@ private slots:
 
     void cancelExtraction();
 
+    void throttledExtraction();
+
     void extractFromFifo();
 
 private:
@@ -144,6 +146,12 @@ void tst_PackageExtractor::extractAndVerify()
     QFETCH(IntMap, sizes);
 
     PackageExtractor extractor(QUrl::fromLocalFile(qL1S(AM_TESTDATA_DIR) + path), m_extractDir->path());
+    QStringList writtenEntries;
+    extractor.setEntryWrittenCallback([&writtenEntries](const QString &entryPath, int fd) {
+        // the test packages contain files only
+        if (fd >= 0)
+            writtenEntries << entryPath;
+    });
     bool result = extractor.extract();
 
     if (expectedSuccess) {
@@ -187,6 +195,9 @@ void tst_PackageExtractor::extractAndVerify()
     reportEntries.sort();
     entries.sort();
     QCOMPARE(reportEntries, entries);
+
+    writtenEntries.sort();
+    QCOMPARE(writtenEntries, entries);
 }
 
 void tst_PackageExtractor::cancelExtraction()
@@ -212,6 +223,22 @@ void tst_PackageExtractor::cancelExtraction()
     }
 }
 
+void tst_PackageExtractor::throttledExtraction()
+{
+    PackageExtractor extractor(QUrl::fromLocalFile(qL1S(AM_TESTDATA_DIR "packages/bigtest.appkg")), m_extractDir->path());
+    QCOMPARE(extractor.writeBandwidthLimit(), quint64(0));
+
+    // 5MB at 4MB/s with a burst of 1MB: needs at least a second
+    extractor.setWriteBandwidthLimit(4 * 1024 * 1024);
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY2(extractor.extract(), qPrintable(extractor.errorString()));
+
+    QVERIFY(extractor.throttledTime() > 0);
+    QVERIFY(timer.elapsed() >= 900);
+    QCOMPARE(QFileInfo(QDir(m_extractDir->path()).absoluteFilePath(qSL("bigtest"))).size(), qint64(5*1024*1024));
+}
+
 class FifoSource : public QThread // clazy:exclude=missing-qobject-macro
 {
 public:
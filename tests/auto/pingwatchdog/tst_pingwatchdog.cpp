@@ -0,0 +1,247 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtTest>
+
+#include "pingwatchdog.h"
+
+QT_USE_NAMESPACE_AM
+
+// The clients are plain QObjects and the clock is advanced manually via tick(): the watchdog's
+// own timer never fires, since the tests do not run an event loop.
+class FakeWatchdog : public PingWatchdog
+{
+public:
+    using PingWatchdog::tick;
+
+    void ticks(int count)
+    {
+        while (count--)
+            tick();
+    }
+
+    bool canPing = true;
+    QList<QObject *> pings;
+    QList<QPair<QObject *, int>> timeouts;
+
+protected:
+    bool ping(QObject *client) override
+    {
+        pings << client;
+        return canPing;
+    }
+    void pongTimedOut(QObject *client, int pongTimeout) override
+    {
+        timeouts << qMakePair(client, pongTimeout);
+    }
+};
+
+// with the default thresholds
+static const int PingIntervalTicks = 1000 / PingWatchdog::TickInterval;
+static const int PongTimeoutTicks = 2000 / PingWatchdog::TickInterval;
+
+class tst_PingWatchdog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void thresholds();
+    void pingPong();
+    void pongTimeout();
+    void perClientThresholds();
+    void inactiveClients();
+    void pingFailed();
+};
+
+void tst_PingWatchdog::thresholds()
+{
+    FakeWatchdog watchdog;
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(qSL("^Ignoring a UI watchdog override")));
+    watchdog.setConfiguration({
+        { qSL("pingInterval"), 500 },
+        { qSL("pongTimeout"), 3000 },
+        { qSL("overrides"), QVariantList {
+              QVariantMap { { qSL("applications"), QStringList { qSL("io.qt.slow.*"), qSL("exact") } },
+                            { qSL("pongTimeout"), 10000 } },
+              QVariantMap { { qSL("categories"), QStringList { qSL("games") } },
+                            { qSL("pingInterval"), 200 } },
+              QVariantMap { { qSL("pongTimeout"), 1 } } } }
+    });
+
+    auto check = [&](const QString &id, const QStringList &categories, int pingInterval, int pongTimeout) {
+        const auto t = watchdog.thresholds(id, categories);
+        return (t.pingInterval == pingInterval) && (t.pongTimeout == pongTimeout);
+    };
+
+    QVERIFY(check(qSL("other"), { }, 500, 3000));
+    // overrides inherit the defaults
+    QVERIFY(check(qSL("io.qt.slow.app"), { }, 500, 10000));
+    QVERIFY(check(qSL("exact"), { }, 500, 10000));
+    QVERIFY(check(qSL("io.qt.slowapp"), { }, 500, 3000));
+    QVERIFY(check(qSL("pacman"), { qSL("arcade"), qSL("games") }, 200, 3000));
+    // the first matching override wins
+    QVERIFY(check(qSL("io.qt.slow.game"), { qSL("games") }, 500, 10000));
+    // unknown clients always get the defaults
+    QVERIFY(check(QString(), { qSL("games") }, 500, 3000));
+}
+
+void tst_PingWatchdog::pingPong()
+{
+    FakeWatchdog watchdog;
+    QObject client;
+
+    // a new client is pinged right away
+    watchdog.setClient(&client, true);
+    QVERIFY(watchdog.isActive(&client));
+    QVERIFY(watchdog.isAwaitingPong(&client));
+    QCOMPARE(watchdog.pings.size(), 1);
+
+    watchdog.pongReceived(&client);
+    QVERIFY(!watchdog.isAwaitingPong(&client));
+
+    // the next ping is sent pingInterval after the pong
+    watchdog.ticks(PingIntervalTicks - 1);
+    QCOMPARE(watchdog.pings.size(), 1);
+    watchdog.ticks(1);
+    QCOMPARE(watchdog.pings.size(), 2);
+    QVERIFY(watchdog.isAwaitingPong(&client));
+
+    // a late, but not too late pong
+    watchdog.ticks(PongTimeoutTicks - 1);
+    watchdog.pongReceived(&client);
+    // duplicate pongs are ignored
+    watchdog.pongReceived(&client);
+    watchdog.ticks(PingIntervalTicks);
+    QCOMPARE(watchdog.pings.size(), 3);
+    QVERIFY(watchdog.timeouts.isEmpty());
+}
+
+void tst_PingWatchdog::pongTimeout()
+{
+    FakeWatchdog watchdog;
+    QObject client;
+
+    watchdog.setClient(&client, true);
+    watchdog.ticks(PongTimeoutTicks - 1);
+    QVERIFY(watchdog.timeouts.isEmpty());
+    watchdog.ticks(1);
+    QCOMPARE(watchdog.timeouts.size(), 1);
+    QCOMPARE(watchdog.timeouts.first().first, &client);
+    QCOMPARE(watchdog.timeouts.first().second, 2000);
+    QVERIFY(!watchdog.isActive(&client));
+
+    // the timeout is only reported once and the client is not pinged anymore ...
+    watchdog.ticks(3 * PingWatchdog::WheelSize);
+    QCOMPARE(watchdog.timeouts.size(), 1);
+    QCOMPARE(watchdog.pings.size(), 1);
+    watchdog.setClient(&client, true);
+    QVERIFY(!watchdog.isActive(&client));
+
+    // ... until it is re-added
+    watchdog.removeClient(&client);
+    watchdog.setClient(&client, true);
+    QVERIFY(watchdog.isActive(&client));
+    QCOMPARE(watchdog.pings.size(), 2);
+}
+
+void tst_PingWatchdog::perClientThresholds()
+{
+    FakeWatchdog watchdog;
+    // more than one revolution of the timer wheel
+    const int slowTimeout = 2 * PingWatchdog::WheelSize * PingWatchdog::TickInterval;
+    watchdog.setConfiguration({
+        { qSL("overrides"), QVariantList {
+              QVariantMap { { qSL("applications"), QStringList { qSL("slow") } },
+                            { qSL("pongTimeout"), slowTimeout } } } }
+    });
+
+    QObject fast, slow, responsive;
+    watchdog.setClient(&fast, true, qSL("fast"));
+    watchdog.setClient(&slow, true, qSL("slow"));
+    watchdog.setClient(&responsive, true, qSL("responsive"));
+
+    for (int i = 0; i < PongTimeoutTicks; ++i) {
+        watchdog.pongReceived(&responsive);
+        watchdog.tick();
+    }
+    QCOMPARE(watchdog.timeouts.size(), 1);
+    QCOMPARE(watchdog.timeouts.first().first, &fast);
+
+    for (int i = PongTimeoutTicks; i < 2 * PingWatchdog::WheelSize; ++i) {
+        watchdog.pongReceived(&responsive);
+        watchdog.tick();
+    }
+    QCOMPARE(watchdog.timeouts.size(), 2);
+    QCOMPARE(watchdog.timeouts.last().first, &slow);
+    QCOMPARE(watchdog.timeouts.last().second, slowTimeout);
+
+    // each client is pinged once per pong: fast and slow only once
+    QCOMPARE(watchdog.pings.count(&fast), 1);
+    QCOMPARE(watchdog.pings.count(&slow), 1);
+    QCOMPARE(watchdog.pings.count(&responsive), 2 * PingWatchdog::WheelSize / PingIntervalTicks + 1);
+    QVERIFY(watchdog.isActive(&responsive));
+}
+
+void tst_PingWatchdog::inactiveClients()
+{
+    FakeWatchdog watchdog;
+    QObject client;
+
+    // e.g. no content yet or suspended
+    watchdog.setClient(&client, false);
+    QVERIFY(!watchdog.isActive(&client));
+    QVERIFY(watchdog.pings.isEmpty());
+
+    watchdog.setClient(&client, true);
+    QCOMPARE(watchdog.pings.size(), 1);
+
+    watchdog.setClient(&client, false);
+    QVERIFY(!watchdog.isActive(&client));
+    watchdog.ticks(3 * PongTimeoutTicks);
+    QVERIFY(watchdog.timeouts.isEmpty());
+
+    watchdog.setClient(&client, true);
+    watchdog.setEnabled(false);
+    QVERIFY(!watchdog.isActive(&client));
+    watchdog.ticks(3 * PongTimeoutTicks);
+    QVERIFY(watchdog.timeouts.isEmpty());
+
+    watchdog.setEnabled(true);
+    QVERIFY(watchdog.isActive(&client));
+    QCOMPARE(watchdog.pings.size(), 3);
+
+    // a pongTimeout of 0 disables the watchdog
+    watchdog.setConfiguration({ { qSL("pongTimeout"), 0 } });
+    QVERIFY(!watchdog.isActive(&client));
+
+    watchdog.setConfiguration({ });
+    watchdog.removeClient(&client);
+    QVERIFY(!watchdog.isActive(&client));
+    watchdog.ticks(3 * PongTimeoutTicks);
+    QVERIFY(watchdog.timeouts.isEmpty());
+}
+
+void tst_PingWatchdog::pingFailed()
+{
+    FakeWatchdog watchdog;
+    QObject client;
+
+    // a client that cannot be pinged right now is not timed out, but retried after pingInterval
+    watchdog.canPing = false;
+    watchdog.setClient(&client, true);
+    QCOMPARE(watchdog.pings.size(), 1);
+    QVERIFY(!watchdog.isAwaitingPong(&client));
+
+    watchdog.ticks(PingIntervalTicks);
+    QCOMPARE(watchdog.pings.size(), 2);
+    QVERIFY(watchdog.timeouts.isEmpty());
+
+    watchdog.canPing = true;
+    watchdog.ticks(PingIntervalTicks);
+    QCOMPARE(watchdog.pings.size(), 3);
+    QVERIFY(watchdog.isAwaitingPong(&client));
+}
+
+QTEST_GUILESS_MAIN(tst_PingWatchdog)
+
+#include "tst_pingwatchdog.moc"
@@ -0,0 +1,138 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtCore>
+#include <QtTest>
+
+#include <memory>
+
+#include <QtAppManManager/processcontainer.h>
+#include <QtAppManMonitor/systemreader.h>
+
+QT_USE_NAMESPACE_AM
+
+// The cgroup v2 hierarchy is simulated by plain files and directories below a temporary system
+// root: the container only ever creates directories and writes to the interface files.
+
+class tst_ProcessContainer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void controlGroupV2_data();
+    void controlGroupV2();
+
+private:
+    static QByteArray readFile(const QString &fileName);
+
+    QTemporaryDir m_systemRoot;
+    QString m_oldSystemRoot;
+};
+
+QByteArray tst_ProcessContainer::readFile(const QString &fileName)
+{
+    QFile f(fileName);
+    return f.open(QFile::ReadOnly) ? f.readAll() : QByteArray();
+}
+
+void tst_ProcessContainer::initTestCase()
+{
+    if (QStandardPaths::findExecutable(qSL("sleep")).isEmpty())
+        QSKIP("Could not find the 'sleep' executable");
+
+    QVERIFY(m_systemRoot.isValid());
+    const QString baseDir = m_systemRoot.filePath(qSL("sys/fs/cgroup"));
+    QVERIFY(QDir().mkpath(baseDir + qSL("/qtam")));
+    for (const QString &dir : { baseDir, baseDir + qSL("/qtam") }) {
+        QFile controllers(dir + qSL("/cgroup.controllers"));
+        QVERIFY(controllers.open(QFile::WriteOnly));
+        QVERIFY(controllers.write("cpu memory pids io\n") > 0);
+    }
+
+    m_oldSystemRoot = g_systemRootDir;
+    g_systemRootDir = m_systemRoot.path();
+    QVERIFY(isCGroupV2());
+}
+
+void tst_ProcessContainer::cleanupTestCase()
+{
+    if (!m_oldSystemRoot.isEmpty())
+        g_systemRootDir = m_oldSystemRoot;
+}
+
+void tst_ProcessContainer::controlGroupV2_data()
+{
+    QTest::addColumn<QString>("method");
+
+    QTest::newRow("fork") << qSL("fork");
+    QTest::newRow("spawn") << qSL("spawn");
+}
+
+void tst_ProcessContainer::controlGroupV2()
+{
+    QFETCH(QString, method);
+
+    if ((method == qSL("spawn")) && !SpawnedHostProcess::isSupported())
+        QSKIP("The 'spawn' start method is not supported on this platform");
+
+    ProcessContainerManager manager;
+    manager.setConfiguration({
+        { qSL("startMethod"), method },
+        { qSL("defaultControlGroup"), qSL("background") },
+        { qSL("controlGroups"), QVariantMap {
+              { qSL("background"), QVariantMap { { qSL("cpu.weight"), 20 } } } } }
+    });
+
+    std::unique_ptr<AbstractContainer> container(manager.create(nullptr, { }, { }, { }));
+    QVERIFY(container);
+    QVERIFY(container->setProgram(QStandardPaths::findExecutable(qSL("sleep"))));
+
+    std::unique_ptr<AbstractContainerProcess> process(container->start({ qSL("10") }, { }, { }));
+    QVERIFY(process);
+    auto cleanup = qScopeGuard([&process]() {
+        QSignalSpy finishedSpy(process.get(), &AbstractContainerProcess::finished);
+        process->kill();
+        finishedSpy.wait(5000);
+    });
+
+    const QString groupPath = g_systemRootDir + qSL("/sys/fs/cgroup/qtam/background");
+
+    if (process->processId() <= 0) {
+        // a forked process has no pid, until it has been started: neither the control group
+        // nor the freezer must touch anything in the meantime
+        QVERIFY(container->controlGroup().isEmpty());
+        QVERIFY(!container->setControlGroup(qSL("background")));
+        QVERIFY(!container->setFrozen(true));
+        QVERIFY(!QFileInfo::exists(groupPath));
+
+        QSignalSpy startedSpy(process.get(), &AbstractContainerProcess::started);
+        QVERIFY(startedSpy.wait(5000));
+    }
+
+    const qint64 pid = process->processId();
+    QVERIFY(pid > 0);
+    QVERIFY(pid != QCoreApplication::applicationPid());
+    QCOMPARE(container->controlGroup(), qSL("background"));
+    QCOMPARE(readFile(groupPath + qSL("/cpu.weight")), QByteArray("20"));
+
+    // the process is in its own leaf, named after its pid
+    const QString leafPath = groupPath + qSL("/pid-") + QString::number(pid);
+    QVERIFY(QFileInfo(leafPath).isDir());
+    QVERIFY(!QFileInfo::exists(groupPath + qSL("/pid-0")));
+    const QByteArray procs = readFile(leafPath + qSL("/cgroup.procs"));
+    QCOMPARE(procs, QByteArray::number(pid) + '\n');
+    QVERIFY(!procs.split('\n').contains(QByteArray::number(QCoreApplication::applicationPid())));
+
+    // only this leaf is frozen
+    QVERIFY(container->setFrozen(true));
+    QCOMPARE(readFile(leafPath + qSL("/cgroup.freeze")), QByteArray("1\n"));
+    QVERIFY(!QFileInfo::exists(groupPath + qSL("/cgroup.freeze")));
+    QVERIFY(container->setFrozen(false));
+    QCOMPARE(readFile(leafPath + qSL("/cgroup.freeze")), QByteArray("0\n"));
+}
+
+QTEST_MAIN(tst_ProcessContainer)
+
+#include "tst_processcontainer.moc"
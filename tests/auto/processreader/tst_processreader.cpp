@@ -6,6 +6,7 @@
 #include <QtCore>
 #include <QtTest>
 #include <QtAppManMonitor/processreader.h>
+#include <QtAppManMonitor/systemreader.h>
 
 QT_USE_NAMESPACE_AM
 
@@ -22,6 +23,7 @@ private slots:
     void memTestProcess();
     void memBasic();
     void memAdvanced();
+    void controlGroup();
 
 private:
     void printMem(const ProcessReader &reader);
@@ -101,6 +103,29 @@ void tst_ProcessReader::memAdvanced()
     QCOMPARE(reader.memory.heapPss, 15740u);
 }
 
+void tst_ProcessReader::controlGroup()
+{
+    g_systemRootDir = qL1S(":/root");
+    auto cleanup = qScopeGuard([]() { g_systemRootDir = qSL("/"); });
+
+    // the group also contains the child 4322 and 4323, which exited in the meantime
+    QVERIFY(reader.testReadControlGroup(4321));
+    QCOMPARE(reader.controlGroup.memoryTotal, Q_UINT64_C(58720256));
+    QCOMPARE(reader.controlGroup.memoryAnon, Q_UINT64_C(31457280));
+    QCOMPARE(reader.controlGroup.memoryFile, Q_UINT64_C(20971520));
+    QCOMPARE(reader.controlGroup.memoryKernel, Q_UINT64_C(4194304));
+    QCOMPARE(reader.controlGroup.memoryShmem, Q_UINT64_C(2097152));
+
+    // no /proc/$PID/cgroup: the process is not in a dedicated group
+    QVERIFY(!reader.testReadControlGroup(1234));
+    QCOMPARE(reader.controlGroup.memoryTotal, Q_UINT64_C(0));
+
+    // the group also contains 9012, which is not a child of 5678: its totals are not per-app
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(qSL("^Control group .* is shared")));
+    QVERIFY(!reader.testReadControlGroup(5678));
+    QCOMPARE(reader.controlGroup.memoryTotal, Q_UINT64_C(0));
+}
+
 void tst_ProcessReader::printMem(const ProcessReader &reader)
 {
     qDebug() << "totalVm:" << reader.memory.totalVm;
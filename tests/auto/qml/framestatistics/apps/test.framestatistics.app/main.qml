@@ -0,0 +1,23 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+import QtQuick 2.11
+import QtApplicationManager.Application 2.0
+
+ApplicationManagerWindow {
+    width: 100
+    height: 100
+    color: "green"
+
+    // keeps the client committing new frames
+    Rectangle {
+        width: 50
+        height: 50
+        color: "blue"
+        RotationAnimator on rotation {
+            from: 0; to: 360; duration: 1000
+            loops: Animation.Infinite
+            running: true
+        }
+    }
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+import QtQuick 2.11
+import QtTest 1.0
+import QtApplicationManager.SystemUI 2.0
+
+Item {
+    id: root
+    width: 200
+    height: 200
+    visible: true
+
+    property int spyTimeout: 5000 * AmTest.timeoutFactor
+    property var window
+
+    WindowItem {
+        anchors.fill: parent
+        window: root.window
+    }
+
+    Connections {
+        target: WindowManager
+        function onWindowAdded(window) {
+            root.window = window;
+        }
+    }
+
+    TestCase {
+        id: testCase
+        name: "FrameStatistics"
+        when: windowShown
+
+        property var app: ApplicationManager.application("test.framestatistics.app")
+
+        function cleanup() {
+            app.stop(true);
+            tryCompare(app, "runState", Am.NotRunning, spyTimeout);
+            root.window = null;
+        }
+
+        function checkConsistency(stats) {
+            verify(stats.duration >= 0);
+            verify(stats.bufferCount <= stats.commitCount);
+            verify(stats.droppedBuffers <= stats.bufferCount);
+            verify(stats.averageFrameCallbackLatency >= 0);
+            verify(stats.averageFrameCallbackLatency <= stats.maximumFrameCallbackLatency);
+        }
+
+        function test_frameStatistics() {
+            app.start();
+            tryVerify(() => root.window !== null, spyTimeout);
+
+            let stats = root.window.frameStatistics();
+            if (ApplicationManager.singleProcess) {
+                compare(Object.keys(stats).length, 0);
+                compare(WindowManager.frameStatistics().length, 0);
+                return;
+            }
+
+            // the client is animating, so it has to keep attaching new buffers
+            tryVerify(() => root.window.frameStatistics().bufferCount >= 10, spyTimeout);
+            stats = root.window.frameStatistics();
+            checkConsistency(stats);
+            verify(stats.commitRate > 0);
+
+            const all = WindowManager.frameStatistics();
+            compare(all.length, 1);
+            compare(all[0].applicationId, app.id);
+            compare(all[0].index, 0);
+            checkConsistency(all[0]);
+
+            root.window.resetFrameStatistics();
+            stats = root.window.frameStatistics();
+            compare(stats.commitCount, 0);
+            compare(stats.bufferCount, 0);
+            compare(stats.droppedBuffers, 0);
+            compare(stats.maximumFrameCallbackLatency, 0);
+
+            tryVerify(() => root.window.frameStatistics().bufferCount > 0, spyTimeout);
+            checkConsistency(root.window.frameStatistics());
+        }
+    }
+}
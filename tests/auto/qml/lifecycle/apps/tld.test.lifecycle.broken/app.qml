@@ -0,0 +1,12 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+import QtQuick 2.11
+import QtApplicationManager.Application 2.0
+
+// deliberately does not compile
+ApplicationManagerWindow {
+    Rectangle {
+        width: )
+    }
+}
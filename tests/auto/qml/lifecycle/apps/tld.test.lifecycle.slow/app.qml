@@ -0,0 +1,20 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+import QtQuick 2.11
+import QtApplicationManager.Application 2.0
+
+// takes a while to be created, so it can be stopped while it is still being incubated
+ApplicationManagerWindow {
+    Grid {
+        columns: 100
+        Repeater {
+            model: 5000
+            Rectangle {
+                width: 2
+                height: 2
+                color: index % 2 ? "red" : "blue"
+            }
+        }
+    }
+}
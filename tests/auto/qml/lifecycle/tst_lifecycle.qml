@@ -14,6 +14,8 @@ TestCase {
 
     property int spyTimeout: 5000 * AmTest.timeoutFactor
     property var app: ApplicationManager.application("tld.test.lifecycle");
+    property var brokenApp: ApplicationManager.application("tld.test.lifecycle.broken");
+    property var slowApp: ApplicationManager.application("tld.test.lifecycle.slow");
 
 
     WindowItem {
@@ -56,7 +58,14 @@ TestCase {
     }
 
 
+    function waitForRunState(application, runState) {
+        while (application.runState !== runState)
+            runStateChangedSpy.wait(spyTimeout);
+    }
+
     function cleanup() {
+        if (app.runState === ApplicationObject.NotRunning)
+            return;
         objectDestroyedSpy.clear();
         var index = AmTest.observeObjectDestroyed(app.runtime);
         app.stop();
@@ -125,4 +134,64 @@ TestCase {
         while (app.runState !== ApplicationObject.Running)
             runStateChangedSpy.wait(spyTimeout);
     }
+
+    // The root object of an in-process app is compiled and created asynchronously: the app only
+    // becomes Running once its object tree is complete.
+    function test_asyncStart() {
+        verify(app.start());
+        compare(app.runState, ApplicationObject.StartingUp);
+        waitForRunState(app, ApplicationObject.Running);
+        verify(app.runtime);
+        tryVerify(function() { return chrome.window !== null; }, spyTimeout);
+    }
+
+    function test_compileError() {
+        if (!ApplicationManager.singleProcess)
+            skip("the exit code of a failed compilation is specific to the in-process runtime");
+
+        // compilation errors are only detected after start() has returned
+        verify(brokenApp.start());
+        waitForRunState(brokenApp, ApplicationObject.NotRunning);
+        compare(brokenApp.lastExitCode, 3);
+        compare(brokenApp.lastExitStatus, Am.NormalExit);
+        verify(!brokenApp.runtime);
+    }
+
+    function test_stopWhileStarting_data() {
+        return [ { tag: "loading", delay: 0 },
+                 { tag: "incubating", delay: 50 } ];
+    }
+
+    function test_stopWhileStarting(data) {
+        var reachedRunning = false;
+        function onRunStateChanged(id, runState) {
+            if (id === slowApp.id && runState === Am.Running)
+                reachedRunning = true;
+        }
+        ApplicationManager.applicationRunStateChanged.connect(onRunStateChanged);
+
+        verify(slowApp.start());
+        compare(slowApp.runState, ApplicationObject.StartingUp);
+        objectDestroyedSpy.clear();
+        var index = AmTest.observeObjectDestroyed(slowApp.runtime);
+        if (data.delay)
+            wait(data.delay);
+
+        slowApp.stop();
+        waitForRunState(slowApp, ApplicationObject.NotRunning);
+        ApplicationManager.applicationRunStateChanged.disconnect(onRunStateChanged);
+
+        // the half-created object tree is dropped together with the runtime
+        objectDestroyedSpy.wait(spyTimeout);
+        compare(objectDestroyedSpy.signalArguments[0][0], index);
+        // (without an incubation controller, the creation might be finished after the delay)
+        if (ApplicationManager.singleProcess && !data.delay)
+            verify(!reachedRunning);
+
+        // ... and the app can be started again afterwards
+        verify(slowApp.start());
+        waitForRunState(slowApp, ApplicationObject.Running);
+        slowApp.stop();
+        waitForRunState(slowApp, ApplicationObject.NotRunning);
+    }
 }
@@ -0,0 +1,179 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+import QtQuick 2.11
+import QtTest 1.0
+import QtApplicationManager 2.0
+
+TestCase {
+    id: testCase
+    name: "MonitorModel"
+
+    property int targetCount: 0
+
+    MonitorModel {
+        id: monitorModel
+        maximumCount: 3
+
+        QtObject {
+            id: counter
+            property var roleNames: [ "counter", "label" ]
+            property int counter: 0
+            property string label
+
+            function update() {
+                ++counter
+                label = "row" + counter
+                if (counter >= testCase.targetCount)
+                    monitorModel.running = false
+            }
+        }
+    }
+
+    SignalSpy {
+        id: rowsMovedSpy
+        target: monitorModel
+        signalName: "rowsMoved"
+    }
+
+    function init() {
+        monitorModel.resolution = 1
+        monitorModel.resolutions = []
+        monitorModel.clear()
+        monitorModel.maximumCount = 3
+        counter.counter = 0
+        rowsMovedSpy.clear()
+    }
+
+    function addRows(count) {
+        // there is no way to trigger a single read without the timer: the data source stops the
+        // model after exactly count rows
+        targetCount = counter.counter + count
+        monitorModel.interval = 1
+        monitorModel.running = true
+        tryVerify(function() { return !monitorModel.running })
+        compare(counter.counter, targetCount)
+    }
+
+    function test_history() {
+        addRows(3)
+        compare(monitorModel.count, 3)
+        compare(rowsMovedSpy.count, 0)
+
+        compare(monitorModel.get(0).counter, 1)
+
+        addRows(2)
+        // the oldest rows are recycled as the newest ones
+        compare(rowsMovedSpy.count, 2)
+        compare(monitorModel.count, 3)
+        // ordered from oldest to newest
+        compare(monitorModel.get(0).counter, 3)
+        compare(monitorModel.get(0).label, "row3")
+        compare(monitorModel.get(1).counter, 4)
+        compare(monitorModel.get(2).counter, 5)
+    }
+
+    function test_series() {
+        addRows(5)
+        // the ring buffer wrapped around
+        compare(monitorModel.series("counter"), [ 3, 4, 5 ])
+
+        // strings are not numbers
+        verify(isNaN(monitorModel.series("label")[0]))
+
+        ignoreWarning(/there is no role named foo/)
+        compare(monitorModel.series("foo").length, 0)
+    }
+
+    function test_maximumCount() {
+        addRows(4)
+        monitorModel.maximumCount = 2
+        compare(monitorModel.count, 2)
+        compare(monitorModel.series("counter"), [ 3, 4 ])
+
+        monitorModel.maximumCount = 5
+        compare(monitorModel.count, 2)
+        compare(monitorModel.get(1).counter, 4)
+        addRows(4)
+        compare(monitorModel.count, 5)
+        compare(monitorModel.series("counter"), [ 4, 5, 6, 7, 8 ])
+    }
+
+    function test_singleRow() {
+        monitorModel.maximumCount = 1
+        addRows(1)
+        compare(monitorModel.count, 1)
+        compare(monitorModel.get(0).counter, 1)
+
+        // the only row is updated in place instead of being moved onto itself
+        var dataChangedCount = 0
+        var onDataChanged = function() { ++dataChangedCount }
+        monitorModel.dataChanged.connect(onDataChanged)
+        addRows(2)
+        monitorModel.dataChanged.disconnect(onDataChanged)
+
+        compare(rowsMovedSpy.count, 0)
+        compare(dataChangedCount, 2)
+        compare(monitorModel.count, 1)
+        compare(monitorModel.get(0).counter, 3)
+        compare(monitorModel.get(0).label, "row3")
+        compare(monitorModel.series("counter"), [ 3 ])
+    }
+
+    function test_resolutions() {
+        ignoreWarning(/Ignoring invalid resolution 1/)
+        monitorModel.resolutions = [ 2, 1, 4, 2 ]
+        compare(monitorModel.resolutions, [ 2, 4 ])
+
+        addRows(9)
+        // raw rows 7, 8, 9
+        compare(monitorModel.series("counter"), [ 7, 8, 9 ])
+
+        monitorModel.resolution = 2
+        // buckets (3, 4), (5, 6), (7, 8) - the first one was evicted
+        compare(monitorModel.count, 3)
+        compare(monitorModel.get(0).counter, 3.5)
+        compare(monitorModel.series("counter"), [ 3.5, 5.5, 7.5 ])
+        compare(monitorModel.seriesMinimum("counter"), [ 3, 5, 7 ])
+        compare(monitorModel.seriesMaximum("counter"), [ 4, 6, 8 ])
+
+        monitorModel.resolution = 4
+        // buckets (1..4), (5..8)
+        compare(monitorModel.count, 2)
+        compare(monitorModel.series("counter"), [ 2.5, 6.5 ])
+
+        // the row signals are only emitted for the exposed resolution
+        rowsMovedSpy.clear()
+        addRows(1)
+        compare(monitorModel.count, 2)
+        compare(rowsMovedSpy.count, 0)
+        addRows(3)
+        compare(monitorModel.count, 3)
+        compare(monitorModel.series("counter"), [ 2.5, 6.5, 10.5 ])
+
+        ignoreWarning(/Resolution 3 is not one of the resolutions/)
+        monitorModel.resolution = 3
+        compare(monitorModel.resolution, 4)
+    }
+
+    function test_maximumCountWhileDownsampled() {
+        monitorModel.resolutions = [ 2 ]
+        addRows(9)
+        monitorModel.resolution = 2
+
+        // the raw rows are not exposed, but have to be trimmed as well
+        monitorModel.maximumCount = 1
+        compare(monitorModel.count, 1)
+        compare(monitorModel.series("counter"), [ 7.5 ])
+
+        monitorModel.resolution = 1
+        compare(monitorModel.count, 1)
+        compare(monitorModel.series("counter"), [ 9 ])
+
+        monitorModel.maximumCount = 3
+        addRows(2)
+        compare(monitorModel.series("counter"), [ 9, 10, 11 ])
+        monitorModel.resolution = 2
+        compare(monitorModel.series("counter"), [ 7.5, 9.5 ])
+    }
+}
@@ -23,6 +23,12 @@ TestCase {
         signalName: "windowManagerCompositorReadyChanged"
     }
 
+    SignalSpy {
+        id: screenshotFinishedSpy
+        target: WindowManager
+        signalName: "screenshotFinished"
+    }
+
     function test_addExtension() {
         if (!ApplicationManager.singleProcess) {
             if (!ApplicationManager.windowManagerCompositorReady) {
@@ -37,4 +43,27 @@ TestCase {
         }
         compare(WindowManager.addExtension(textComp), null);
     }
+
+    function test_requestScreenshot() {
+        AmTest.ignoreMessage(AmTest.WarningMsg, /unsupported image format/);
+        compare(WindowManager.requestScreenshot("screenshot-%s.foo", "", { format: "foo" }), 0);
+        compare(WindowManager.requestScreenshot("screenshot-%i.png", "no.such.app", { }), 0);
+
+        var dir = AmTest.createTemporaryDir();
+        verify(dir);
+        try {
+            screenshotFinishedSpy.clear();
+            var requestId = WindowManager.requestScreenshot(dir + "/screenshot-%s.bmp", ":0",
+                                                            { format: "bmp" });
+            verify(requestId > 0);
+            // the images are always written asynchronously
+            compare(screenshotFinishedSpy.count, 0);
+            screenshotFinishedSpy.wait(2000 * AmTest.timeoutFactor);
+            compare(screenshotFinishedSpy.signalArguments[0][0], requestId);
+            verify(screenshotFinishedSpy.signalArguments[0][1]);
+            compare(screenshotFinishedSpy.signalArguments[0][2], [ dir + "/screenshot-0.bmp" ]);
+        } finally {
+            verify(AmTest.removeDir(dir));
+        }
+    }
 }
@@ -41,6 +41,11 @@ TestCase {
         }
     }
 
+    Image {
+        id: thumbnail
+        cache: false
+    }
+
     Connections {
         target: WindowManager
         function onWindowAdded(window) {
@@ -226,10 +231,36 @@ TestCase {
 
         app.start("show-sub");
         tryCompare(WindowManager, "count", 2, spyTimeout);
+        compare(WindowManager.windowsOfApplication(data.appId).length, 2);
+        compare(WindowManager.windowsOfApplication(data.appId)[1], WindowManager.window(1));
+        compare(WindowManager.indexOfWindow(WindowManager.window(1)), 1);
 
         app.start("hide-sub");
         tryCompare(WindowManager, "count", 1, spyTimeout);
+        compare(WindowManager.windowsOfApplication(data.appId).length, 1);
+        compare(WindowManager.indexOfWindow(WindowManager.window(0)), 0);
+
+        app.stop();
+        tryCompare(WindowManager, "count", 0, spyTimeout);
+    }
+
+    function test_thumbnail() {
+        var app = ApplicationManager.application("test.winmap.amwin");
 
+        app.start("show-main");
+        tryCompare(WindowManager, "count", 1, spyTimeout);
+        var window = lastWindowAdded;
+        var initialUrl = window.thumbnail.toString();
+        verify(initialUrl.startsWith("image://appman-window-thumbnail/"));
+
+        thumbnail.source = Qt.binding(function() { return window.thumbnail; });
+        // the first snapshot is taken as soon as the image is requested
+        tryVerify(function() { return window.thumbnail.toString() !== initialUrl; }, spyTimeout);
+        tryCompare(thumbnail, "status", Image.Ready, spyTimeout);
+        verify(thumbnail.sourceSize.width > 1 && thumbnail.sourceSize.width <= WindowManager.thumbnailSize.width);
+        verify(thumbnail.sourceSize.height > 1 && thumbnail.sourceSize.height <= WindowManager.thumbnailSize.height);
+
+        thumbnail.source = "";
         app.stop();
         tryCompare(WindowManager, "count", 0, spyTimeout);
     }
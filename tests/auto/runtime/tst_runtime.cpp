@@ -142,6 +142,9 @@ void tst_Runtime::factory()
     QVERIFY(r->start());
     QVERIFY(r->state() == Am::Running);
     QVERIFY(r->applicationProcessId() == 1);
+    QVERIFY(!r->freeze()); // no container, so it cannot be frozen
+    QVERIFY(r->state() == Am::Running);
+    QVERIFY(r->thaw());
     r->stop();
     QVERIFY(r->state() == Am::NotRunning);
     QVERIFY(!r->securityToken().isEmpty());
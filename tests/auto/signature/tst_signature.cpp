@@ -22,6 +22,7 @@ public:
 private slots:
     void initTestCase();
     void check();
+    void trustStore();
     void crossPlatform();
 
 private:
@@ -102,6 +103,41 @@ void tst_Signature::check()
     QVERIFY2(s.errorString().contains(qSL("private key")), qPrintable(s.errorString()));
 }
 
+void tst_Signature::trustStore()
+{
+    QByteArray hash("foo");
+    Signature s(hash);
+    QByteArray signature = s.create(m_signingP12, m_signingPassword);
+    QVERIFY2(!signature.isEmpty(), qPrintable(s.errorString()));
+
+    TrustStore ts(m_verifyingPEM);
+    QVERIFY2(ts.isValid(), qPrintable(ts.errorString()));
+    QCOMPARE(ts.certificates(), m_verifyingPEM);
+
+    // the same store can be used any number of times and is shared between copies
+    TrustStore tsCopy = ts;
+    QVERIFY2(s.verify(signature, ts), qPrintable(s.errorString()));
+    QVERIFY2(Signature(hash).verify(signature, tsCopy), qPrintable(s.errorString()));
+    QVERIFY(!Signature(hash + "bar").verify(signature, ts));
+
+    // a null store behaves like an empty chain of trust
+    TrustStore nullTs;
+    QVERIFY(nullTs.isNull());
+    QVERIFY(nullTs.isValid());
+    QVERIFY(nullTs.certificates().isEmpty());
+    QVERIFY(!ts.isNull());
+    QVERIFY(!s.verify(signature, nullTs));
+    QVERIFY2(s.errorString().contains(qSL("Failed to verify")), qPrintable(s.errorString()));
+
+    TrustStore invalidTs(QList<QByteArray>() << m_signingP12);
+    QVERIFY(!invalidTs.isValid());
+    QVERIFY2(invalidTs.errorString().contains(qSL("not load")), qPrintable(invalidTs.errorString()));
+    QVERIFY(!s.verify(signature, invalidTs));
+    QVERIFY2(s.errorString().contains(qSL("not load")), qPrintable(s.errorString()));
+    QVERIFY(!s.verify(hash, invalidTs));
+    QVERIFY2(s.errorString().contains(qSL("not read")), qPrintable(s.errorString()));
+}
+
 void tst_Signature::crossPlatform()
 {
     QByteArray hash = "hello\nworld!";
@@ -0,0 +1,214 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtTest>
+
+#include "startscheduler.h"
+
+QT_USE_NAMESPACE_AM
+
+// Tests the start scheduling of the ApplicationManager (applications/maximumConcurrentStarts)
+
+class tst_StartScheduler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void unlimitedStarts();
+    void concurrencyLimit();
+    void userStartsBeforeBackgroundStarts();
+    void promoteToUserStart();
+    void cancelQueuedStart();
+    void releaseSlotOnNotRunning();
+    void releaseSlotOnFailedStart();
+    void startTimeout();
+
+private:
+    std::function<bool()> starter(const QString &id, bool result = true)
+    {
+        return [this, id, result]() { m_started << id; return result; };
+    }
+
+    QStringList m_started;
+};
+
+void tst_StartScheduler::unlimitedStarts()
+{
+    m_started.clear();
+    StartScheduler scheduler;
+    QCOMPARE(scheduler.maximumConcurrentStarts(), 0);
+
+    for (const auto &id : { qSL("a"), qSL("b"), qSL("c") })
+        QVERIFY(scheduler.schedule(id, StartScheduler::BackgroundStart, starter(id)));
+
+    QCOMPARE(m_started, QStringList({ qSL("a"), qSL("b"), qSL("c") }));
+    QCOMPARE(scheduler.activeCount(), 3);
+    QVERIFY(scheduler.queuedIds().isEmpty());
+}
+
+void tst_StartScheduler::concurrencyLimit()
+{
+    m_started.clear();
+    StartScheduler scheduler;
+    scheduler.setMaximumConcurrentStarts(2);
+    QSignalSpy timesSpy(&scheduler, &StartScheduler::startTimes);
+
+    for (const auto &id : { qSL("a"), qSL("b"), qSL("c") })
+        QVERIFY(scheduler.schedule(id, StartScheduler::UserStart, starter(id)));
+
+    QCOMPARE(m_started, QStringList({ qSL("a"), qSL("b") }));
+    QCOMPARE(scheduler.activeCount(), 2);
+    QVERIFY(scheduler.isActive(qSL("a")));
+    QVERIFY(scheduler.isQueued(qSL("c")));
+
+    scheduler.finished(qSL("a"), true);
+    QCOMPARE(timesSpy.count(), 1);
+    QCOMPARE(timesSpy.constFirst().constFirst().toString(), qSL("a"));
+    QVERIFY(!scheduler.isActive(qSL("a")));
+
+    // the next start is only triggered from the event loop
+    QCOMPARE(m_started.size(), 2);
+    QTRY_COMPARE(m_started, QStringList({ qSL("a"), qSL("b"), qSL("c") }));
+    QCOMPARE(scheduler.activeCount(), 2);
+
+    // raising the limit starts queued applications right away
+    QVERIFY(scheduler.schedule(qSL("d"), StartScheduler::UserStart, starter(qSL("d"))));
+    QVERIFY(scheduler.isQueued(qSL("d")));
+    scheduler.setMaximumConcurrentStarts(3);
+    QCOMPARE(m_started.constLast(), qSL("d"));
+}
+
+void tst_StartScheduler::userStartsBeforeBackgroundStarts()
+{
+    m_started.clear();
+    StartScheduler scheduler;
+    scheduler.setMaximumConcurrentStarts(1);
+
+    QVERIFY(scheduler.schedule(qSL("a"), StartScheduler::BackgroundStart, starter(qSL("a"))));
+    QVERIFY(scheduler.schedule(qSL("bg1"), StartScheduler::BackgroundStart, starter(qSL("bg1"))));
+    QVERIFY(scheduler.schedule(qSL("u1"), StartScheduler::UserStart, starter(qSL("u1"))));
+    QVERIFY(scheduler.schedule(qSL("bg2"), StartScheduler::BackgroundStart, starter(qSL("bg2"))));
+    QVERIFY(scheduler.schedule(qSL("u2"), StartScheduler::UserStart, starter(qSL("u2"))));
+
+    QCOMPARE(scheduler.queuedIds(), QStringList({ qSL("u1"), qSL("u2"), qSL("bg1"), qSL("bg2") }));
+
+    for (int i = 0; i < 4; ++i) {
+        scheduler.finished(m_started.constLast(), true);
+        QTRY_COMPARE(m_started.size(), i + 2);
+    }
+    QCOMPARE(m_started, QStringList({ qSL("a"), qSL("u1"), qSL("u2"), qSL("bg1"), qSL("bg2") }));
+}
+
+void tst_StartScheduler::promoteToUserStart()
+{
+    m_started.clear();
+    StartScheduler scheduler;
+    scheduler.setMaximumConcurrentStarts(1);
+
+    QVERIFY(scheduler.schedule(qSL("a"), StartScheduler::UserStart, starter(qSL("a"))));
+    QVERIFY(scheduler.schedule(qSL("u1"), StartScheduler::UserStart, starter(qSL("u1"))));
+    QVERIFY(scheduler.schedule(qSL("bg1"), StartScheduler::BackgroundStart, starter(qSL("bg1"))));
+    QVERIFY(scheduler.schedule(qSL("bg2"), StartScheduler::BackgroundStart, starter(qSL("bg2"))));
+
+    QVERIFY(scheduler.promote(qSL("bg2")));
+    QCOMPARE(scheduler.queuedIds(), QStringList({ qSL("u1"), qSL("bg2"), qSL("bg1") }));
+
+    // promoting a user start does not change anything, active starts cannot be promoted
+    QVERIFY(scheduler.promote(qSL("u1")));
+    QCOMPARE(scheduler.queuedIds(), QStringList({ qSL("u1"), qSL("bg2"), qSL("bg1") }));
+    QVERIFY(!scheduler.promote(qSL("a")));
+    QVERIFY(!scheduler.promote(qSL("unknown")));
+}
+
+void tst_StartScheduler::cancelQueuedStart()
+{
+    m_started.clear();
+    StartScheduler scheduler;
+    scheduler.setMaximumConcurrentStarts(1);
+    QStringList canceled;
+    auto canceler = [&canceled](const QString &id) { return [&canceled, id]() { canceled << id; }; };
+
+    QVERIFY(scheduler.schedule(qSL("a"), StartScheduler::UserStart, starter(qSL("a")), canceler(qSL("a"))));
+    QVERIFY(scheduler.schedule(qSL("b"), StartScheduler::UserStart, starter(qSL("b")), canceler(qSL("b"))));
+    QVERIFY(scheduler.schedule(qSL("c"), StartScheduler::UserStart, starter(qSL("c")), canceler(qSL("c"))));
+
+    // only queued starts can be canceled
+    QVERIFY(!scheduler.cancel(qSL("a")));
+    QVERIFY(scheduler.cancel(qSL("b")));
+    QCOMPARE(canceled, QStringList({ qSL("b") }));
+    QCOMPARE(scheduler.queuedIds(), QStringList({ qSL("c") }));
+
+    scheduler.cancelAll();
+    QCOMPARE(canceled, QStringList({ qSL("b"), qSL("c") }));
+    QVERIFY(scheduler.queuedIds().isEmpty());
+
+    scheduler.finished(qSL("a"), true);
+    QTest::qWait(10);
+    QCOMPARE(m_started, QStringList({ qSL("a") }));
+}
+
+void tst_StartScheduler::releaseSlotOnNotRunning()
+{
+    m_started.clear();
+    StartScheduler scheduler;
+    scheduler.setMaximumConcurrentStarts(1);
+    QSignalSpy timesSpy(&scheduler, &StartScheduler::startTimes);
+
+    QVERIFY(scheduler.schedule(qSL("a"), StartScheduler::UserStart, starter(qSL("a"))));
+    QVERIFY(scheduler.schedule(qSL("b"), StartScheduler::UserStart, starter(qSL("b"))));
+
+    // a crashed while starting up
+    scheduler.finished(qSL("a"), false);
+    QTRY_COMPARE(m_started, QStringList({ qSL("a"), qSL("b") }));
+    QCOMPARE(timesSpy.count(), 0);
+
+    // removing an application also frees its slot
+    QVERIFY(scheduler.schedule(qSL("c"), StartScheduler::UserStart, starter(qSL("c"))));
+    scheduler.remove(qSL("b"));
+    QCOMPARE(m_started.constLast(), qSL("c"));
+}
+
+void tst_StartScheduler::releaseSlotOnFailedStart()
+{
+    m_started.clear();
+    StartScheduler scheduler;
+    scheduler.setMaximumConcurrentStarts(1);
+
+    QVERIFY(!scheduler.schedule(qSL("a"), StartScheduler::UserStart, starter(qSL("a"), false)));
+    QCOMPARE(scheduler.activeCount(), 0);
+    QVERIFY(scheduler.schedule(qSL("b"), StartScheduler::UserStart, starter(qSL("b"))));
+    QVERIFY(scheduler.isActive(qSL("b")));
+}
+
+void tst_StartScheduler::startTimeout()
+{
+    m_started.clear();
+    StartScheduler scheduler;
+    scheduler.setMaximumConcurrentStarts(1);
+    scheduler.setStartTimeout(50);
+    QSignalSpy timeoutSpy(&scheduler, &StartScheduler::startTimedOut);
+    QSignalSpy timesSpy(&scheduler, &StartScheduler::startTimes);
+
+    // a never reaches the Running state
+    QVERIFY(scheduler.schedule(qSL("a"), StartScheduler::UserStart, starter(qSL("a"))));
+    QVERIFY(scheduler.schedule(qSL("b"), StartScheduler::UserStart, starter(qSL("b"))));
+
+    QVERIFY(timeoutSpy.wait());
+    QCOMPARE(timeoutSpy.constFirst().constFirst().toString(), qSL("a"));
+    QCOMPARE(m_started, QStringList({ qSL("a"), qSL("b") }));
+    QVERIFY(!scheduler.isActive(qSL("a")));
+
+    // b finishes in time: its timer must not fire anymore
+    scheduler.finished(qSL("b"), true);
+    QCOMPARE(timesSpy.count(), 1);
+    QTest::qWait(100);
+    QCOMPARE(timeoutSpy.count(), 1);
+
+    // a late Running state of a is ignored
+    scheduler.finished(qSL("a"), true);
+    QCOMPARE(timesSpy.count(), 1);
+}
+
+QTEST_MAIN(tst_StartScheduler)
+
+#include "tst_startscheduler.moc"
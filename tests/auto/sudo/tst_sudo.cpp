@@ -54,6 +54,8 @@ private slots:
     void cleanupTestCase();
 
     void privileges();
+    void pipelinedRequests();
+    void setOwnerAndPermissionsFd();
 
 private:
     SudoClient *m_sudo = nullptr;
@@ -82,6 +84,85 @@ void tst_Sudo::privileges()
     ScopedRootPrivileges sudo;
 }
 
+void tst_Sudo::pipelinedRequests()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    QDir dir(tmp.path());
+
+    const uid_t uid = getuid();
+    const gid_t gid = getgid();
+    QVector<QPair<quint32, QString>> requests;
+
+    for (int i = 0; i < 200; ++i) {
+        QFile f(dir.filePath(QString::number(i)));
+        QVERIFY(f.open(QFile::WriteOnly));
+        requests.append({ m_sudo->submitSetOwnerAndPermissions(f.handle(), uid, gid, 0440), f.fileName() });
+        // the request has its own copy of the descriptor, so we can close ours right away
+    }
+    QVERIFY(dir.mkpath(qSL("sub/dir")));
+    requests.append({ m_sudo->submitSetOwnerAndPermissionsRecursive(dir.filePath(qSL("sub")), uid, gid, 0640),
+                      dir.filePath(qSL("sub")) });
+    // overlapping with the previous request: this has to be executed afterwards
+    requests.append({ m_sudo->submitRemoveRecursive(dir.filePath(qSL("sub"))), dir.filePath(qSL("sub")) });
+
+    // collect the replies in reverse order
+    for (auto it = requests.crbegin(); it != requests.crend(); ++it) {
+        QString errorString;
+        QVERIFY2(m_sudo->waitForReply(it->first, &errorString), qPrintable(it->second + qSL(": ") + errorString));
+    }
+
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(QFileInfo(dir.filePath(QString::number(i))).permissions() & 0x7777, QFile::ReadOwner | QFile::ReadUser | QFile::ReadGroup);
+    QVERIFY(!dir.exists(qSL("sub")));
+
+    // replies can only be collected once and there are none for unknown ids: both must not block
+    QVERIFY(!m_sudo->waitForReply(requests.constFirst().first));
+    QVERIFY(!m_sudo->lastError().isEmpty());
+    QVERIFY(!m_sudo->waitForReply(0));
+
+    QVERIFY(!m_sudo->setOwnerAndPermissions(-1, uid, gid, 0440));
+    QVERIFY(!m_sudo->lastError().isEmpty());
+}
+
+void tst_Sudo::setOwnerAndPermissionsFd()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    QDir dir(tmp.path());
+
+    const uid_t uid = getuid();
+    const gid_t gid = getgid();
+    QString errorString;
+
+    // directories get the x bits wherever they are readable
+    QVERIFY(dir.mkdir(qSL("dir")));
+    int dirFd = QT_OPEN(QFile::encodeName(dir.filePath(qSL("dir"))).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    QVERIFY(dirFd >= 0);
+    const quint32 dirRequest = m_sudo->submitSetOwnerAndPermissions(dirFd, uid, gid, 0440);
+    QT_CLOSE(dirFd);
+    QVERIFY2(m_sudo->waitForReply(dirRequest, &errorString), qPrintable(errorString));
+    QCOMPARE(QFileInfo(dir.filePath(qSL("dir"))).permissions() & 0x7777,
+             QFile::ReadOwner | QFile::ExeOwner | QFile::ReadUser | QFile::ExeUser
+             | QFile::ReadGroup | QFile::ExeGroup);
+
+    // an fd that has already been closed cannot be passed to the server at all
+    QFile f(dir.filePath(qSL("file")));
+    QVERIFY(f.open(QFile::WriteOnly));
+    const int closedFd = f.handle();
+    f.close();
+    const quint32 closedRequest = m_sudo->submitSetOwnerAndPermissions(closedFd, uid, gid, 0440);
+    QVERIFY(!m_sudo->waitForReply(closedRequest, &errorString));
+    QVERIFY(!errorString.isEmpty());
+    QCOMPARE(f.permissions() & QFile::WriteOwner, QFile::WriteOwner);
+
+    // the failed request did not break the pipeline
+    QVERIFY(f.open(QFile::ReadOnly));
+    QVERIFY2(m_sudo->setOwnerAndPermissions(f.handle(), uid, gid, 0400), qPrintable(m_sudo->lastError()));
+    f.close();
+    QCOMPARE(f.permissions() & 0x7777, QFile::ReadOwner | QFile::ReadUser);
+}
+
 void tst_Sudo::cleanupTestCase()
 {
     // the real cleanup happens in ~tst_Installer, since we also need
@@ -21,6 +21,12 @@ private slots:
     void cgroupProcessInfo();
     void memoryReaderReadUsedValue();
     void memoryReaderGroupLimit();
+    void cgroupV2Detection();
+    void memoryReaderV2();
+    void pressureReader();
+    void cpuCoresReader();
+    void drmFdInfoParsing();
+    void drmFdInfoReader();
 };
 
 tst_SystemReader::tst_SystemReader()
@@ -48,6 +54,131 @@ void tst_SystemReader::memoryReaderGroupLimit()
     QCOMPARE(value, Q_UINT64_C(524288000));
 }
 
+void tst_SystemReader::cgroupV2Detection()
+{
+    QVERIFY(!isCGroupV2());
+
+    g_systemRootDir = qL1S(":/root-v2");
+    QVERIFY(isCGroupV2());
+    g_systemRootDir = qL1S(":/root");
+}
+
+void tst_SystemReader::memoryReaderV2()
+{
+    g_systemRootDir = qL1S(":/root-v2");
+    auto cleanup = qScopeGuard([]() { g_systemRootDir = qL1S(":/root"); });
+
+    MemoryReader groupReader(qSL("qtam/background"));
+    QCOMPARE(groupReader.readUsedValue(), Q_UINT64_C(41943040));
+    // memory.high is "max", so memory.max is the effective limit
+    QCOMPARE(groupReader.groupLimit(), Q_UINT64_C(268435456));
+
+    // the root group has no memory.stat: MemTotal - MemAvailable from /proc/meminfo
+    MemoryReader systemReader;
+    QCOMPARE(systemReader.readUsedValue(), Q_UINT64_C(6068219904));
+}
+
+void tst_SystemReader::pressureReader()
+{
+    PressureReader memoryReader(PressureReader::Memory);
+    QVERIFY(memoryReader.isAvailable());
+
+    auto v = memoryReader.readValues();
+    QCOMPARE(v.someAvg10, qreal(0.12));
+    QCOMPARE(v.fullAvg10, qreal(0.05));
+    // the first read only establishes the baseline for the stall times
+    QCOMPARE(v.someDelta, Q_UINT64_C(0));
+    QCOMPARE(v.fullDelta, Q_UINT64_C(0));
+
+    v = memoryReader.readValues();
+    QCOMPARE(v.someDelta, Q_UINT64_C(0));
+    QCOMPARE(v.fullDelta, Q_UINT64_C(0));
+
+    PressureReader cpuReader(PressureReader::Cpu);
+    QCOMPARE(cpuReader.readValues().someAvg10, qreal(0.015));
+
+    g_systemRootDir = qL1S(":/root-v2");
+    auto cleanup = qScopeGuard([]() { g_systemRootDir = qL1S(":/root"); });
+    PressureReader unavailableReader(PressureReader::Io);
+    QVERIFY(!unavailableReader.isAvailable());
+    QCOMPARE(unavailableReader.readValues().someAvg10, qreal(0));
+}
+
+void tst_SystemReader::cpuCoresReader()
+{
+    CpuCoresReader reader;
+    QCOMPARE(reader.coreCount(), 2);
+
+    auto loads = reader.readLoadValues();
+    QCOMPARE(loads.size(), 2);
+    QCOMPARE(loads.at(0), qreal(0.2));
+    QCOMPARE(loads.at(1), qreal(0.4));
+    // nothing changed since the last read
+    loads = reader.readLoadValues();
+    QCOMPARE(loads.at(0), qreal(0));
+    QCOMPARE(loads.at(1), qreal(0));
+
+    auto frequencies = reader.readFrequencies();
+    QCOMPARE(frequencies.size(), 2);
+    QCOMPARE(frequencies.at(0), qreal(1800));
+    // cpu1 has no cpufreq support
+    QCOMPARE(frequencies.at(1), qreal(0));
+}
+
+void tst_SystemReader::drmFdInfoParsing()
+{
+    QFile i915(qSL(":/root/proc/2000/fdinfo/4"));
+    QVERIFY(i915.open(QIODevice::ReadOnly));
+    DrmFdInfoReader::Client client;
+    QVERIFY(DrmFdInfoReader::parseFdInfo(i915.readAll(), client));
+    QCOMPARE(client.id, QByteArray("7"));
+    QCOMPARE(client.device, QByteArray("0000:00:02.0"));
+    QCOMPARE(client.engineTime.size(), 4);
+    QCOMPARE(client.engineTime.value("render"), Q_UINT64_C(5231263000));
+    QCOMPARE(client.engineTime.value("video"), Q_UINT64_C(12000000));
+    QCOMPARE(client.engineCapacity.value("video"), 2);
+    // the resident memory is preferred over the total
+    QCOMPARE(client.memory, Q_UINT64_C(32768) << 10);
+
+    QFile amdgpu(qSL(":/root/proc/2001/fdinfo/9"));
+    QVERIFY(amdgpu.open(QIODevice::ReadOnly));
+    client = { };
+    QVERIFY(DrmFdInfoReader::parseFdInfo(amdgpu.readAll(), client));
+    QCOMPARE(client.id, QByteArray("42"));
+    QCOMPARE(client.engineTime.value("gfx"), Q_UINT64_C(1826541000));
+    // the legacy drm-memory-* keys are summed up
+    QCOMPARE(client.memory, Q_UINT64_C(10240) << 10);
+
+    QFile other(qSL(":/root/proc/2000/fdinfo/0"));
+    QVERIFY(other.open(QIODevice::ReadOnly));
+    client = { };
+    QVERIFY(!DrmFdInfoReader::parseFdInfo(other.readAll(), client));
+}
+
+void tst_SystemReader::drmFdInfoReader()
+{
+    DrmFdInfoReader processReader(2000);
+    QCOMPARE(processReader.readLoadValue(), qreal(0));
+    // fd 4 and 5 are duplicates of the same client
+    QCOMPARE(processReader.clientCount(), 1);
+    QVERIFY(processReader.hasEngineStatistics());
+    QCOMPARE(processReader.memoryUsed(), Q_UINT64_C(32768) << 10);
+    // the engine times did not change (this read only uses the cached DRM fds)
+    QCOMPARE(processReader.readLoadValue(), qreal(0));
+    QCOMPARE(processReader.clientCount(), 1);
+    QCOMPARE(processReader.memoryUsed(), Q_UINT64_C(32768) << 10);
+
+    DrmFdInfoReader systemReader;
+    systemReader.readLoadValue();
+    QCOMPARE(systemReader.clientCount(), 2);
+    QCOMPARE(systemReader.memoryUsed(), (Q_UINT64_C(32768) + Q_UINT64_C(10240)) << 10);
+
+    DrmFdInfoReader noGpuReader(1234);
+    QCOMPARE(noGpuReader.readLoadValue(), qreal(0));
+    QCOMPARE(noGpuReader.clientCount(), 0);
+    QVERIFY(!noGpuReader.hasEngineStatistics());
+}
+
 QTEST_APPLESS_MAIN(tst_SystemReader)
 
 #include "tst_systemreader.moc"
@@ -7,6 +7,7 @@
 #include <QtTest>
 
 #include "utilities.h"
+#include "qml-utilities.h"
 
 QT_USE_NAMESPACE_AM
 
@@ -18,12 +19,110 @@ public:
     tst_Utilities();
 
 private slots:
+    void syncToDisk();
+    void qmlDiskCacheFileName_data();
+    void qmlDiskCacheFileName();
+    void seedQmlDiskCache();
 };
 
 
 tst_Utilities::tst_Utilities()
 { }
 
+void tst_Utilities::syncToDisk()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    QDir dir(tmp.path());
+    QVERIFY(dir.mkpath(qSL("a/b")));
+    QFile f(dir.filePath(qSL("a/b/file")));
+    QVERIFY(f.open(QFile::WriteOnly));
+    QCOMPARE(f.write("data"), 4);
+    f.close();
+
+    QVERIFY(QT_PREPEND_NAMESPACE_AM(syncToDisk)(f.fileName()));
+    QVERIFY(QT_PREPEND_NAMESPACE_AM(syncToDisk)(dir.filePath(qSL("a")), RecursiveOperationType::LeaveDirectory));
+    QVERIFY(syncRecursive(tmp.path()));
+
+#if defined(Q_OS_UNIX)
+    QVERIFY(!QT_PREPEND_NAMESPACE_AM(syncToDisk)(dir.filePath(qSL("does-not-exist"))));
+#endif
+}
+
+void tst_Utilities::qmlDiskCacheFileName_data()
+{
+    QTest::addColumn<QString>("source");
+    QTest::addColumn<QString>("suffix");
+
+    QTest::newRow("qml") << qSL("/apps/com.example/main.qml") << qSL("qmlc");
+    QTest::newRow("js") << qSL("/apps/com.example/lib/util.js") << qSL("jsc");
+    QTest::newRow("mjs") << qSL("/apps/com.example/module.mjs") << qSL("mjsc");
+    QTest::newRow("multiple-dots") << qSL("/apps/com.example/Main.ui.qml") << qSL("ui.qmlc");
+}
+
+void tst_Utilities::qmlDiskCacheFileName()
+{
+    QFETCH(QString, source);
+    QFETCH(QString, suffix);
+
+    // has to match QV4::CompilationUnit::localCacheFilePath()
+    const QByteArray hash = QCryptographicHash::hash(source.toUtf8(), QCryptographicHash::Sha1).toHex();
+    QCOMPARE(QT_PREPEND_NAMESPACE_AM(qmlDiskCacheFileName)(source), QString::fromLatin1(hash) + qL1C('.') + suffix);
+}
+
+void tst_Utilities::seedQmlDiskCache()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    QDir dir(tmp.path());
+    QVERIFY(dir.mkpath(qSL("precompiled")));
+
+    const QString cacheDir = dir.filePath(qSL("cache"));
+    qputenv("QML_DISK_CACHE_PATH", cacheDir.toLocal8Bit());
+    qunsetenv("QML_DISABLE_DISK_CACHE");
+    QCOMPARE(qmlDiskCacheDirectory(), cacheDir);
+
+    auto writeFile = [](const QString &path, const QByteArray &content, const QDateTime &modified) {
+        QFile f(path);
+        return f.open(QFile::WriteOnly | QFile::Truncate) && (f.write(content) == content.size())
+                && f.setFileTime(modified, QFileDevice::FileModificationTime);
+    };
+    auto readFile = [](const QString &path) {
+        QFile f(path);
+        return f.open(QFile::ReadOnly) ? f.readAll() : QByteArray();
+    };
+
+    const QDateTime now = QDateTime::currentDateTime();
+    const QString src = dir.filePath(qSL("precompiled/a.qmlc"));
+    const QString dest = dir.filePath(qSL("cache/a.qmlc"));
+    QVERIFY(writeFile(src, "v1", now.addSecs(-60)));
+
+    // disabled by default
+    QVERIFY(!isPrecompiledQmlCacheEnabled());
+    QT_PREPEND_NAMESPACE_AM(seedQmlDiskCache)(dir.filePath(qSL("precompiled")));
+    QVERIFY(!QFile::exists(dest));
+
+    setPrecompiledQmlCacheEnabled(true);
+    QT_PREPEND_NAMESPACE_AM(seedQmlDiskCache)(dir.filePath(qSL("precompiled")));
+    QCOMPARE(readFile(dest), QByteArray("v1"));
+
+    // a newer file in the cache (e.g. written by the engine itself) is kept
+    QVERIFY(writeFile(dest, "engine", now));
+    QT_PREPEND_NAMESPACE_AM(seedQmlDiskCache)(dir.filePath(qSL("precompiled")));
+    QCOMPARE(readFile(dest), QByteArray("engine"));
+
+    // a newer precompiled file (e.g. after an update) replaces the cached one
+    QVERIFY(writeFile(src, "v2", now.addSecs(60)));
+    QT_PREPEND_NAMESPACE_AM(seedQmlDiskCache)(dir.filePath(qSL("precompiled")));
+    QCOMPARE(readFile(dest), QByteArray("v2"));
+
+    // a missing directory is not an error
+    QT_PREPEND_NAMESPACE_AM(seedQmlDiskCache)(dir.filePath(qSL("does-not-exist")));
+
+    setPrecompiledQmlCacheEnabled(false);
+    qunsetenv("QML_DISK_CACHE_PATH");
+}
+
 QTEST_APPLESS_MAIN(tst_Utilities)
 
 #include "tst_utilities.moc"
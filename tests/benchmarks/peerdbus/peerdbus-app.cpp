@@ -0,0 +1,33 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusMessage>
+
+#include "global.h"
+#include "qtyaml.h"
+
+QT_USE_NAMESPACE_AM
+
+// A minimal native application for tst_bench_peerdbus: it does the least possible amount of work
+// a real launcher has to do, before it is considered to be ready on the peer D-Bus.
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    const auto docs = QtYaml::variantDocumentsFromYaml(qgetenv("AM_CONFIG"));
+    const QString address = docs.value(0).toMap().value(qSL("dbus")).toMap().value(qSL("p2p")).toString();
+
+    QDBusConnection connection = QDBusConnection::connectToPeer(address, qSL("am"));
+    if (!connection.isConnected())
+        return 1;
+
+    connection.send(QDBusMessage::createMethodCall(QString(), qSL("/ApplicationInterface"),
+                                                   qSL("io.qt.ApplicationManager.ApplicationInterface"),
+                                                   qSL("finishedInitialization")));
+
+    // the benchmark kills us
+    return a.exec();
+}
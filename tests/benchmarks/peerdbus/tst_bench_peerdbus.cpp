@@ -0,0 +1,150 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtCore>
+#include <QtTest>
+#include <QtDBus>
+
+#include <memory>
+
+#include "application.h"
+#include "applicationmanager.h"
+#include "notificationmanager.h"
+#include "package.h"
+#include "packageinfo.h"
+#include "abstractcontainer.h"
+#include "containerfactory.h"
+#include "processcontainer.h"
+#include "nativeruntime.h"
+#include "runtimefactory.h"
+#include "exception.h"
+
+QT_USE_NAMESPACE_AM
+
+// Measures the time between the creation of a NativeRuntime and the application being ready on
+// the peer-to-peer D-Bus (NativeRuntime::applicationReadyOnPeerDBus). The runtime's constructor
+// either creates a new D-Bus server (cold: peerDBusServerPoolSize is 0) or takes an already
+// listening one from the NativeRuntimeManager's pool (pooled), so the timing has to start before
+// the runtime is created.
+// The application is a minimal helper (peerdbus-app), that connects to the peer D-Bus and
+// immediately reports that it finished its initialization.
+
+class tst_Bench_PeerDBus : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void launchLatency_data();
+    void launchLatency();
+
+private:
+    QTemporaryDir m_appDir;
+    std::unique_ptr<PackageInfo> m_packageInfo;
+    std::unique_ptr<Package> m_package;
+    std::unique_ptr<Application> m_app;
+    NativeRuntimeManager *m_runtimeManager = nullptr;
+};
+
+void tst_Bench_PeerDBus::initTestCase()
+{
+    QVERIFY(QFile::exists(qSL(AM_PEERDBUS_APP)));
+    QVERIFY(m_appDir.isValid());
+
+    ApplicationManager::createInstance(false);
+    NotificationManager::createInstance();
+
+    m_runtimeManager = new NativeRuntimeManager();
+    QVERIFY(RuntimeFactory::instance()->registerRuntime(m_runtimeManager));
+    QVERIFY(ContainerFactory::instance()->registerContainer(new ProcessContainerManager()));
+
+    const QString appBinary = m_appDir.filePath(qSL("peerdbus-app"));
+    QVERIFY(QFile::copy(qSL(AM_PEERDBUS_APP), appBinary));
+
+    QFile manifest(m_appDir.filePath(qSL("info.yaml")));
+    QVERIFY(manifest.open(QFile::WriteOnly));
+    manifest.write("formatVersion: 1\n"
+                   "formatType: am-application\n"
+                   "---\n"
+                   "id: io.qt.bench.peerdbus\n"
+                   "name: { en_US: 'PeerDBus' }\n"
+                   "icon: icon.png\n"
+                   "code: peerdbus-app\n"
+                   "runtime: native\n"
+                   "supportsApplicationInterface: yes\n");
+    manifest.close();
+
+    try {
+        m_packageInfo.reset(PackageInfo::fromManifest(manifest.fileName()));
+        m_package.reset(new Package(m_packageInfo.get()));
+        m_app.reset(new Application(m_packageInfo->applications().constFirst(), m_package.get()));
+    } catch (const Exception &e) {
+        QVERIFY2(false, qPrintable(e.errorString()));
+    }
+}
+
+void tst_Bench_PeerDBus::cleanupTestCase()
+{
+    m_app.reset();
+    m_package.reset();
+    m_packageInfo.reset();
+    delete RuntimeFactory::instance();
+    delete ContainerFactory::instance();
+    delete NotificationManager::instance();
+    delete ApplicationManager::instance();
+}
+
+void tst_Bench_PeerDBus::launchLatency_data()
+{
+    QTest::addColumn<int>("poolSize");
+
+    QTest::newRow("cold") << 0;
+    QTest::newRow("pooled") << 1;
+}
+
+void tst_Bench_PeerDBus::launchLatency()
+{
+    QFETCH(int, poolSize);
+
+    static const int iterations = 20;
+
+    m_runtimeManager->setConfiguration({ { qSL("peerDBusServerPoolSize"), poolSize } });
+    // start with the same pool state as in the steady state: the first take triggers the refill
+    m_runtimeManager->takeApplicationInterfaceServer()->deleteLater();
+    QTest::qWait(10);
+
+    qint64 totalNSecs = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+
+        AbstractContainer *container = ContainerFactory::instance()->create(qSL("process"), m_app.get());
+        QVERIFY(container);
+        auto *runtime = qobject_cast<NativeRuntime *>(RuntimeFactory::instance()->create(container, m_app.get()));
+        QVERIFY(runtime);
+        m_app->setCurrentRuntime(runtime);
+
+        qint64 latency = -1;
+        connect(runtime, &NativeRuntime::applicationReadyOnPeerDBus, this, [&timer, &latency]() {
+            latency = timer.nsecsElapsed();
+        });
+
+        QVERIFY(runtime->start());
+
+        QTRY_VERIFY_WITH_TIMEOUT(latency >= 0, 10000);
+        totalNSecs += latency;
+
+        QPointer<NativeRuntime> guard(runtime);
+        runtime->stop(true);
+        QTRY_VERIFY_WITH_TIMEOUT(!guard, 10000);
+    }
+
+    QTest::setBenchmarkResult(qreal(totalNSecs) / iterations / 1000000, QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(tst_Bench_PeerDBus)
+
+#include "tst_bench_peerdbus.moc"
@@ -0,0 +1,77 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtCore>
+#include <QtTest>
+
+#include <memory>
+
+#include <QtAppManManager/processcontainer.h>
+
+QT_USE_NAMESPACE_AM
+
+// Measures the time it takes to start a child process with the 'fork' (QProcess) and the 'spawn'
+// (posix_spawn) start methods of the process container, depending on the RSS of the parent
+// process (which would be the System UI in a real setup).
+
+class tst_Bench_ProcessContainer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void spawnLatency_data();
+    void spawnLatency();
+
+private:
+    template <typename T> void startAndWait(const QString &program);
+};
+
+template <typename T> void tst_Bench_ProcessContainer::startAndWait(const QString &program)
+{
+    QBENCHMARK {
+        T process;
+        QSignalSpy finishedSpy(&process, &AbstractContainerProcess::finished);
+        process.start(program, { });
+        // we do not want to accumulate children (or zombies) while benchmarking
+        QVERIFY(finishedSpy.wait(5000));
+    }
+}
+
+void tst_Bench_ProcessContainer::spawnLatency_data()
+{
+    QTest::addColumn<QString>("method");
+    QTest::addColumn<int>("rssMiB");
+
+    for (const char *method : { "fork", "spawn" }) {
+        for (int rss : { 0, 128, 512, 1024 })
+            QTest::addRow("%s-%dMiB", method, rss) << QString::fromLatin1(method) << rss;
+    }
+}
+
+void tst_Bench_ProcessContainer::spawnLatency()
+{
+    QFETCH(QString, method);
+    QFETCH(int, rssMiB);
+
+    if ((method == qSL("spawn")) && !SpawnedHostProcess::isSupported())
+        QSKIP("The 'spawn' start method is not supported on this platform");
+
+    const QString program = QStandardPaths::findExecutable(qSL("true"));
+    if (program.isEmpty())
+        QSKIP("Could not find the 'true' executable");
+
+    // simulate a big System UI: the memory needs to be touched to actually be mapped
+    const size_t ballastSize = size_t(rssMiB) * 1024 * 1024;
+    std::unique_ptr<char[]> ballast(ballastSize ? new char[ballastSize] : nullptr);
+    if (ballastSize)
+        memset(ballast.get(), 0x55, ballastSize);
+
+    if (method == qSL("spawn"))
+        startAndWait<SpawnedHostProcess>(program);
+    else
+        startAndWait<HostProcess>(program);
+}
+
+QTEST_MAIN(tst_Bench_ProcessContainer)
+
+#include "tst_bench_processcontainer.moc"